@@ -0,0 +1,594 @@
+#include "geometry/AnyShape.h"
+#include "geometry/Shape.h"
+#include "geometry/ShapeArena.h"
+#include "geometry/ShapeManager.h"
+#include "geometry/ShapeStore.h"
+#include "utils/ExactStatistics.h"
+#include "utils/Instrumentation.h"
+#include "utils/MathUtils.h"
+#include "utils/QuantileSketch.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include <sys/resource.h>
+
+// Regression harness: identical workloads through each shape and statistics
+// backend. Every run first checks the backend's results against a reference
+// backend (and fails the run on a mismatch), then reports throughput, per-call
+// p50/p99 latency, heap allocations and peak heap per call, process peak RSS,
+// and the per-call deltas of every instrumentation metric the calls touched.
+// Peak RSS is a process-wide high-water mark; compare it between backends by
+// running each on its own, e.g. --benchmark_filter='ShapeBackendBuild<Soa'.
+
+using namespace geometry;
+using namespace utils;
+
+namespace
+{
+    // Heap accounting, enabled only while a measured call runs
+    std::atomic<bool> trackingHeap{false};
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<int64_t> liveHeapBytes{0};
+    std::atomic<int64_t> peakHeapBytes{0};
+
+    void recordAllocation(void *pointer)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        int64_t bytes = static_cast<int64_t>(malloc_usable_size(pointer));
+        int64_t live = liveHeapBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        int64_t peak = peakHeapBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakHeapBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void recordFree(void *pointer)
+    {
+        liveHeapBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(pointer)), std::memory_order_relaxed);
+    }
+}
+
+void *operator new(size_t size)
+{
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer)
+        throw std::bad_alloc();
+    if (trackingHeap.load(std::memory_order_relaxed))
+        recordAllocation(pointer);
+    return pointer;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (pointer && trackingHeap.load(std::memory_order_relaxed))
+        recordFree(pointer);
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+// Over-aligned types (e.g. alignas(64) cells) allocate through these overloads
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    // aligned_alloc wants a size that is a multiple of the alignment
+    size_t align = static_cast<size_t>(alignment);
+    size_t rounded = (std::max<size_t>(size, 1) + align - 1) / align * align;
+    void *pointer = std::aligned_alloc(align, rounded);
+    if (!pointer)
+        throw std::bad_alloc();
+    if (trackingHeap.load(std::memory_order_relaxed))
+        recordAllocation(pointer);
+    return pointer;
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept
+{
+    operator delete(pointer);
+}
+
+namespace
+{
+    bool isClose(double value, double reference, double relative = 1e-9)
+    {
+        return std::abs(value - reference) <= relative * std::max(1.0, std::abs(reference));
+    }
+
+    /**
+     * Runs one measured call per benchmark iteration and reports the
+     * harness counters for them.
+     */
+    template <typename Call>
+    void measureCalls(benchmark::State &state, int64_t itemsPerCall, Call call)
+    {
+        std::map<std::string, uint64_t> counters;
+        for (const Counter *counter : Instrumentation::getCounters())
+        {
+            counters[counter->getName()] = counter->getValue();
+        }
+        std::map<std::string, uint64_t> timers;
+        for (const TimerMetric *timer : Instrumentation::getTimers())
+        {
+            timers[timer->getName()] = timer->getTotalNanoseconds();
+        }
+
+        std::vector<uint64_t> latencies;
+        latencies.reserve(1 << 16);
+        uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        liveHeapBytes.store(0, std::memory_order_relaxed);
+        peakHeapBytes.store(0, std::memory_order_relaxed);
+
+        for (auto _ : state)
+        {
+            auto start = std::chrono::steady_clock::now();
+            trackingHeap.store(true, std::memory_order_relaxed);
+            call();
+            trackingHeap.store(false, std::memory_order_relaxed);
+            auto end = std::chrono::steady_clock::now();
+            latencies.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        }
+
+        double calls = static_cast<double>(std::max<size_t>(latencies.size(), 1));
+        state.SetItemsProcessed(state.iterations() * itemsPerCall);
+        if (!latencies.empty())
+        {
+            auto p50 = latencies.begin() + static_cast<ptrdiff_t>(latencies.size() / 2);
+            std::nth_element(latencies.begin(), p50, latencies.end());
+            state.counters["p50_us"] = static_cast<double>(*p50) * 1e-3;
+            auto p99 = latencies.begin() + static_cast<ptrdiff_t>(latencies.size() * 99 / 100);
+            std::nth_element(latencies.begin(), p99, latencies.end());
+            state.counters["p99_us"] = static_cast<double>(*p99) * 1e-3;
+        }
+        state.counters["allocs"] =
+            static_cast<double>(allocationCount.load(std::memory_order_relaxed) - allocationsBefore) / calls;
+        state.counters["peak_heap_mb"] = static_cast<double>(peakHeapBytes.load(std::memory_order_relaxed)) / 1e6;
+
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            state.counters["peak_rss_mb"] = static_cast<double>(usage.ru_maxrss) / 1024.0;
+        }
+
+        for (const Counter *counter : Instrumentation::getCounters())
+        {
+            uint64_t delta = counter->getValue() - counters[counter->getName()];
+            if (delta > 0)
+                state.counters[counter->getName()] = static_cast<double>(delta) / calls;
+        }
+        for (const TimerMetric *timer : Instrumentation::getTimers())
+        {
+            uint64_t delta = timer->getTotalNanoseconds() - timers[timer->getName()];
+            if (delta > 0)
+                state.counters[timer->getName()] = static_cast<double>(delta) * 1e-9 / calls;
+        }
+    }
+
+    void backendSizes(benchmark::internal::Benchmark *benchmark)
+    {
+        benchmark->ArgName("n")->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMicrosecond);
+    }
+
+    // Shape workloads: build a scene, then per frame move every shape and read the totals
+    struct ShapeParameters
+    {
+        bool rectangle;
+        double x, y, a, b;
+    };
+
+    std::vector<ShapeParameters> generateScene(size_t count)
+    {
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> position(0.0, 1000.0);
+        std::uniform_real_distribution<double> extent(0.1, 10.0);
+        std::vector<ShapeParameters> scene(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            scene[i] = {i % 2 == 0, position(rng), position(rng), extent(rng), extent(rng)};
+        }
+        return scene;
+    }
+
+    struct ShapeTotals
+    {
+        double area;
+        double perimeter;
+    };
+
+    // Reference: owning polymorphic shapes with cached aggregates
+    class VirtualShapes
+    {
+    public:
+        void build(const std::vector<ShapeParameters> &scene)
+        {
+            shapes_.reserve(scene.size());
+            for (const ShapeParameters &p : scene)
+            {
+                std::unique_ptr<Shape> shape;
+                if (p.rectangle)
+                    shape = std::make_unique<Rectangle>(p.x, p.y, p.a, p.b);
+                else
+                    shape = std::make_unique<Circle>(p.x, p.y, p.a);
+                shapes_.push_back(shape.get());
+                manager_.addShape(std::move(shape));
+            }
+        }
+
+        void moveAll(double dx, double dy)
+        {
+            for (Shape *shape : shapes_)
+            {
+                shape->move(dx, dy);
+            }
+        }
+
+        ShapeTotals totals() const { return {manager_.calculateTotalArea(), manager_.calculateTotalPerimeter()}; }
+
+    private:
+        ShapeManager manager_;
+        std::vector<Shape *> shapes_;
+    };
+
+    class ArenaShapes
+    {
+    public:
+        void build(const std::vector<ShapeParameters> &scene)
+        {
+            for (const ShapeParameters &p : scene)
+            {
+                if (p.rectangle)
+                    arena_.create<Rectangle>(p.x, p.y, p.a, p.b);
+                else
+                    arena_.create<Circle>(p.x, p.y, p.a);
+            }
+        }
+
+        void moveAll(double dx, double dy)
+        {
+            for (Shape *shape : arena_.getShapes())
+            {
+                shape->move(dx, dy);
+            }
+        }
+
+        ShapeTotals totals() const
+        {
+            ShapeTotals totals = {0.0, 0.0};
+            for (const Shape *shape : arena_.getShapes())
+            {
+                totals.area += shape->area();
+                totals.perimeter += shape->perimeter();
+            }
+            return totals;
+        }
+
+    private:
+        ShapeArena arena_;
+    };
+
+    class VariantShapes
+    {
+    public:
+        void build(const std::vector<ShapeParameters> &scene)
+        {
+            list_.reserve(scene.size());
+            for (const ShapeParameters &p : scene)
+            {
+                if (p.rectangle)
+                    list_.emplace<Rectangle>(p.x, p.y, p.a, p.b);
+                else
+                    list_.emplace<Circle>(p.x, p.y, p.a);
+            }
+        }
+
+        void moveAll(double dx, double dy) { list_.moveAll(dx, dy); }
+        ShapeTotals totals() const { return {list_.totalArea(), list_.totalPerimeter()}; }
+
+    private:
+        AnyShapeList list_;
+    };
+
+    class SoaShapes
+    {
+    public:
+        void build(const std::vector<ShapeParameters> &scene)
+        {
+            store_.reserve(scene.size() / 2 + 1, scene.size() / 2 + 1);
+            for (const ShapeParameters &p : scene)
+            {
+                if (p.rectangle)
+                    store_.addRectangle(p.x, p.y, p.a, p.b);
+                else
+                    store_.addCircle(p.x, p.y, p.a);
+            }
+        }
+
+        void moveAll(double dx, double dy) { store_.moveAll(dx, dy); }
+        ShapeTotals totals() const { return {store_.totalArea(), store_.totalPerimeter()}; }
+
+    private:
+        ShapeStore store_;
+    };
+
+    template <typename Backend>
+    bool totalsMatchReference(benchmark::State &state, const Backend &backend, const VirtualShapes &reference)
+    {
+        ShapeTotals got = backend.totals();
+        ShapeTotals want = reference.totals();
+        if (isClose(got.area, want.area) && isClose(got.perimeter, want.perimeter))
+        {
+            return true;
+        }
+        state.SkipWithError("shape totals differ from the ShapeManager reference");
+        return false;
+    }
+}
+
+template <typename Backend>
+static void BM_ShapeBackendBuild(benchmark::State &state)
+{
+    auto scene = generateScene(static_cast<size_t>(state.range(0)));
+    {
+        Backend backend;
+        backend.build(scene);
+        VirtualShapes reference;
+        reference.build(scene);
+        if (!totalsMatchReference(state, backend, reference))
+            return;
+    }
+
+    measureCalls(state, state.range(0), [&]
+                 {
+                     Backend backend;
+                     backend.build(scene);
+                     benchmark::DoNotOptimize(backend.totals());
+                 });
+}
+BENCHMARK_TEMPLATE(BM_ShapeBackendBuild, VirtualShapes)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_ShapeBackendBuild, ArenaShapes)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_ShapeBackendBuild, VariantShapes)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_ShapeBackendBuild, SoaShapes)->Apply(backendSizes);
+
+template <typename Backend>
+static void BM_ShapeBackendFrame(benchmark::State &state)
+{
+    auto scene = generateScene(static_cast<size_t>(state.range(0)));
+    Backend backend;
+    backend.build(scene);
+    {
+        // Check after a few frames, so moving is covered too
+        VirtualShapes reference;
+        reference.build(scene);
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            backend.moveAll(1.0, -0.5);
+            reference.moveAll(1.0, -0.5);
+        }
+        if (!totalsMatchReference(state, backend, reference))
+            return;
+    }
+
+    measureCalls(state, state.range(0), [&]
+                 {
+                     backend.moveAll(1.0, -0.5);
+                     benchmark::DoNotOptimize(backend.totals());
+                 });
+}
+BENCHMARK_TEMPLATE(BM_ShapeBackendFrame, VirtualShapes)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_ShapeBackendFrame, ArenaShapes)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_ShapeBackendFrame, VariantShapes)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_ShapeBackendFrame, SoaShapes)->Apply(backendSizes);
+
+// Statistics workload: summarize one window of samples (moments, median, p90, p99)
+namespace
+{
+    const std::vector<double> WINDOW_PERCENTILES = {50.0, 90.0, 99.0};
+
+    struct WindowSummary
+    {
+        Statistics stats;
+        std::vector<double> percentiles;
+    };
+
+    std::vector<double> generateSamples(size_t count)
+    {
+        std::mt19937_64 rng(42);
+        std::lognormal_distribution<double> latency(3.0, 0.75);
+        std::vector<double> samples(count);
+        for (double &sample : samples)
+        {
+            sample = latency(rng);
+        }
+        return samples;
+    }
+
+    // Reference: comparison sort, then exact moments and interpolated percentiles
+    struct ComparisonSortStatistics
+    {
+        static constexpr double RANK_TOLERANCE = 0.0;
+
+        static WindowSummary summarize(std::span<const double> samples)
+        {
+            std::vector<double> sorted(samples.begin(), samples.end());
+            std::sort(sorted.begin(), sorted.end());
+            SampleMoments moments = ExactStatistics::computeMoments(sorted);
+
+            WindowSummary summary;
+            summary.stats.count = moments.count;
+            summary.stats.mean = moments.mean;
+            summary.stats.median = ExactStatistics::medianOfSorted(sorted);
+            summary.stats.standardDeviation = std::sqrt(moments.variance());
+            summary.stats.minimum = moments.minimum;
+            summary.stats.maximum = moments.maximum;
+            for (double percentile : WINDOW_PERCENTILES)
+            {
+                summary.percentiles.push_back(ExactStatistics::percentileOfSorted(sorted, percentile));
+            }
+            return summary;
+        }
+    };
+
+    // StatisticsCalculator after a radix sort (the path getPercentile() takes)
+    struct RadixSortStatistics
+    {
+        static constexpr double RANK_TOLERANCE = 0.0;
+
+        static WindowSummary summarize(std::span<const double> samples)
+        {
+            StatisticsCalculator calc;
+            calc.addValues(samples);
+            calc.getPercentile(50.0);
+            WindowSummary summary;
+            summary.stats = calc.calculate(WINDOW_PERCENTILES, summary.percentiles);
+            return summary;
+        }
+    };
+
+    // StatisticsCalculator on unsorted samples: fused moments plus selection
+    struct SelectionStatistics
+    {
+        static constexpr double RANK_TOLERANCE = 0.0;
+
+        static WindowSummary summarize(std::span<const double> samples)
+        {
+            StatisticsCalculator calc;
+            calc.addValues(samples);
+            WindowSummary summary;
+            summary.stats = calc.calculate(WINDOW_PERCENTILES, summary.percentiles);
+            return summary;
+        }
+    };
+
+    // StatisticsCalculator over a view: radix selection in place, no copy
+    struct ChunkedViewStatistics
+    {
+        static constexpr double RANK_TOLERANCE = 0.0;
+
+        static WindowSummary summarize(std::span<const double> samples)
+        {
+            StatisticsCalculator calc;
+            calc.attachView(samples);
+            WindowSummary summary;
+            summary.stats = calc.calculate(WINDOW_PERCENTILES, summary.percentiles);
+            return summary;
+        }
+    };
+
+    // StatisticsCalculator with a KLL sketch answering the percentiles
+    struct SketchStatistics
+    {
+        static constexpr double RANK_TOLERANCE = 0.02;
+
+        static WindowSummary summarize(std::span<const double> samples)
+        {
+            StatisticsCalculator calc;
+            calc.setQuantileBackend(std::make_unique<KllSketch>());
+            calc.addValues(samples);
+            WindowSummary summary;
+            summary.stats = calc.calculate(WINDOW_PERCENTILES, summary.percentiles);
+            return summary;
+        }
+    };
+
+    // Exact backends match the reference values; approximate ones must land
+    // within RANK_TOLERANCE of the requested rank
+    template <typename Backend>
+    bool summaryMatchesReference(benchmark::State &state, std::span<const double> samples)
+    {
+        WindowSummary got = Backend::summarize(samples);
+        WindowSummary want = ComparisonSortStatistics::summarize(samples);
+        const Statistics &a = got.stats;
+        const Statistics &b = want.stats;
+        bool ok = a.count == b.count && isClose(a.mean, b.mean) && isClose(a.median, b.median) &&
+                  isClose(a.standardDeviation, b.standardDeviation) && isClose(a.minimum, b.minimum) &&
+                  isClose(a.maximum, b.maximum) && got.percentiles.size() == want.percentiles.size();
+
+        std::vector<double> sorted(samples.begin(), samples.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; ok && i < WINDOW_PERCENTILES.size(); ++i)
+        {
+            if (Backend::RANK_TOLERANCE == 0.0)
+            {
+                ok = isClose(got.percentiles[i], want.percentiles[i]);
+                continue;
+            }
+            // Fraction of samples below and not above the estimate
+            double target = WINDOW_PERCENTILES[i] / 100.0;
+            double n = static_cast<double>(sorted.size());
+            auto range = std::equal_range(sorted.begin(), sorted.end(), got.percentiles[i]);
+            double lowRank = static_cast<double>(range.first - sorted.begin()) / n;
+            double highRank = static_cast<double>(range.second - sorted.begin()) / n;
+            ok = lowRank <= target + Backend::RANK_TOLERANCE && highRank >= target - Backend::RANK_TOLERANCE;
+        }
+
+        if (!ok)
+        {
+            state.SkipWithError("window summary differs from the comparison-sort reference");
+        }
+        return ok;
+    }
+}
+
+template <typename Backend>
+static void BM_StatisticsBackend(benchmark::State &state)
+{
+    auto samples = generateSamples(static_cast<size_t>(state.range(0)));
+    if (!summaryMatchesReference<Backend>(state, samples))
+        return;
+
+    measureCalls(state, state.range(0), [&]
+                 { benchmark::DoNotOptimize(Backend::summarize(samples)); });
+}
+BENCHMARK_TEMPLATE(BM_StatisticsBackend, ComparisonSortStatistics)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_StatisticsBackend, RadixSortStatistics)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_StatisticsBackend, SelectionStatistics)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_StatisticsBackend, ChunkedViewStatistics)->Apply(backendSizes);
+BENCHMARK_TEMPLATE(BM_StatisticsBackend, SketchStatistics)->Apply(backendSizes);
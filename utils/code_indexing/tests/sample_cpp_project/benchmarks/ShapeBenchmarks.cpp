@@ -0,0 +1,420 @@
+#include "geometry/AnyShape.h"
+#include "geometry/CollisionDetector.h"
+#include "geometry/ConcurrentShapeManager.h"
+#include "geometry/DrawSink.h"
+#include "geometry/SceneFile.h"
+#include "geometry/ScenePipeline.h"
+#include "geometry/Shape.h"
+#include "geometry/ShapeManager.h"
+#include "geometry/ShapeStore.h"
+#include "utils/MathUtils.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace geometry;
+
+namespace
+{
+    // Same deterministic mix of rectangles and circles for every container
+    template <typename AddRectangle, typename AddCircle>
+    void generateShapes(size_t count, AddRectangle addRectangle, AddCircle addCircle)
+    {
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> position(0.0, 1000.0);
+        std::uniform_real_distribution<double> extent(0.1, 10.0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i % 2 == 0)
+                addRectangle(position(rng), position(rng), extent(rng), extent(rng));
+            else
+                addCircle(position(rng), position(rng), extent(rng));
+        }
+    }
+}
+
+// Cached path: one resize updates the running totals, then the total is read
+static void BM_ShapeManagerResizeTotalArea(benchmark::State &state)
+{
+    ShapeManager manager;
+    std::vector<Circle *> circles;
+    generateShapes(
+        static_cast<size_t>(state.range(0)),
+        [&](double x, double y, double w, double h) { manager.addShape(std::make_unique<Rectangle>(x, y, w, h)); },
+        [&](double x, double y, double r) {
+            auto circle = std::make_unique<Circle>(x, y, r);
+            circles.push_back(circle.get());
+            manager.addShape(std::move(circle));
+        });
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        Circle *circle = circles[next];
+        circle->setRadius(circle->getRadius() == 1.0 ? 2.0 : 1.0);
+        benchmark::DoNotOptimize(manager.calculateTotalArea());
+        next = (next + 1 == circles.size()) ? 0 : next + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShapeManagerResizeTotalArea)->RangeMultiplier(10)->Range(1000, 10000000);
+
+// Cold path: shrinking the shape on the edge forces a full bounds rebuild
+static void BM_ShapeManagerBoundsRebuild(benchmark::State &state)
+{
+    ShapeManager manager;
+    generateShapes(
+        static_cast<size_t>(state.range(0)),
+        [&](double x, double y, double w, double h) { manager.addShape(std::make_unique<Rectangle>(x, y, w, h)); },
+        [&](double x, double y, double r) { manager.addShape(std::make_unique<Circle>(x, y, r)); });
+    auto edge = std::make_unique<Circle>(2000.0, 2000.0, 10.0);
+    Circle *edgeCircle = edge.get();
+    manager.addShape(std::move(edge));
+
+    for (auto _ : state)
+    {
+        edgeCircle->setRadius(5.0);
+        benchmark::DoNotOptimize(manager.getBounds());
+        edgeCircle->setRadius(10.0); // growing back extends in place
+    }
+    state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_ShapeManagerBoundsRebuild)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_AnyShapeListTotalArea(benchmark::State &state)
+{
+    AnyShapeList list;
+    list.reserve(static_cast<size_t>(state.range(0)));
+    generateShapes(
+        static_cast<size_t>(state.range(0)),
+        [&](double x, double y, double w, double h) { list.emplace<Rectangle>(x, y, w, h); },
+        [&](double x, double y, double r) { list.emplace<Circle>(x, y, r); });
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(list.totalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AnyShapeListTotalArea)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ShapeStoreTotalArea(benchmark::State &state)
+{
+    ShapeStore store;
+    generateShapes(
+        static_cast<size_t>(state.range(0)),
+        [&](double x, double y, double w, double h) { store.addRectangle(x, y, w, h); },
+        [&](double x, double y, double r) { store.addCircle(x, y, r); });
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(store.totalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShapeStoreTotalArea)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ShapeStoreMoveAll(benchmark::State &state)
+{
+    ShapeStore store;
+    generateShapes(
+        static_cast<size_t>(state.range(0)),
+        [&](double x, double y, double w, double h) { store.addRectangle(x, y, w, h); },
+        [&](double x, double y, double r) { store.addCircle(x, y, r); });
+    std::vector<utils::Vec2d> deltas(store.getShapeCount(), utils::Vec2d(0.5, -0.25));
+
+    for (auto _ : state)
+    {
+        store.moveAll(deltas);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShapeStoreMoveAll)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ShapeStoreAreas(benchmark::State &state)
+{
+    ShapeStore store;
+    generateShapes(
+        static_cast<size_t>(state.range(0)),
+        [&](double x, double y, double w, double h) { store.addRectangle(x, y, w, h); },
+        [&](double x, double y, double r) { store.addCircle(x, y, r); });
+    std::vector<double> areas(store.getShapeCount());
+
+    for (auto _ : state)
+    {
+        store.areas(areas);
+        benchmark::DoNotOptimize(areas.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShapeStoreAreas)->RangeMultiplier(10)->Range(1000, 10000000)->Unit(benchmark::kMicrosecond);
+
+// Collision detection at constant density: the world grows with the shape count
+namespace
+{
+    ShapeStore collisionScene(size_t count)
+    {
+        ShapeStore store;
+        double side = 4.0 * std::sqrt(static_cast<double>(count));
+        generateShapes(
+            count, [&](double x, double y, double w, double h)
+            { store.addRectangle(x * side / 1000.0, y * side / 1000.0, w / 4.0, h / 4.0); },
+            [&](double x, double y, double r)
+            { store.addCircle(x * side / 1000.0, y * side / 1000.0, r / 8.0); });
+        return store;
+    }
+}
+
+static void BM_CollisionsBruteForce(benchmark::State &state)
+{
+    ShapeStore store = collisionScene(static_cast<size_t>(state.range(0)));
+    std::vector<std::unique_ptr<Shape>> shapes;
+    for (size_t i = 0; i < store.getRectangleCount(); ++i)
+        shapes.push_back(std::make_unique<Rectangle>(store.rectangleAt(i)));
+    for (size_t i = 0; i < store.getCircleCount(); ++i)
+        shapes.push_back(std::make_unique<Circle>(store.circleAt(i)));
+
+    for (auto _ : state)
+    {
+        std::vector<CollisionPair> pairs;
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            for (size_t j = i + 1; j < shapes.size(); ++j)
+            {
+                if (shapes[i]->intersects(*shapes[j]))
+                    pairs.push_back({i, j});
+            }
+        }
+        benchmark::DoNotOptimize(pairs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CollisionsBruteForce)->RangeMultiplier(4)->Range(1000, 16000)->Unit(benchmark::kMillisecond);
+
+// First tick: full sort of the sweep order
+static void BM_CollisionDetectorCold(benchmark::State &state)
+{
+    ShapeStore store = collisionScene(static_cast<size_t>(state.range(0)));
+    std::vector<CollisionPair> pairs;
+    for (auto _ : state)
+    {
+        CollisionDetector detector;
+        detector.findCollisions(store, pairs);
+        benchmark::DoNotOptimize(pairs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CollisionDetectorCold)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Steady state: every shape jitters a little, then the tick's pairs are found
+static void BM_CollisionDetectorTick(benchmark::State &state)
+{
+    ShapeStore store = collisionScene(static_cast<size_t>(state.range(0)));
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> step(-0.05, 0.05);
+    std::vector<utils::Vec2d> forward(store.getShapeCount());
+    for (auto &delta : forward)
+        delta = utils::Vec2d(step(rng), step(rng));
+    std::vector<utils::Vec2d> backward(forward.size());
+    for (size_t i = 0; i < forward.size(); ++i)
+        backward[i] = utils::Vec2d(-forward[i].x, -forward[i].y);
+
+    CollisionDetector detector;
+    std::vector<CollisionPair> pairs;
+    detector.findCollisions(store, pairs);
+    bool flip = false;
+    for (auto _ : state)
+    {
+        store.moveAll(flip ? backward : forward);
+        flip = !flip;
+        detector.findCollisions(store, pairs);
+        benchmark::DoNotOptimize(pairs.data());
+    }
+    state.counters["pairs"] = static_cast<double>(pairs.size());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CollisionDetectorTick)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Multi-producer scene loading: one shared manager, each benchmark thread adds shapes
+static void BM_LockedShapeManagerAdd(benchmark::State &state)
+{
+    static ShapeManager *manager;
+    static std::mutex mutex;
+    if (state.thread_index() == 0)
+        manager = new ShapeManager();
+
+    for (auto _ : state)
+    {
+        auto shape = std::make_unique<Rectangle>(0.0, 0.0, 1.0, 1.0);
+        std::lock_guard<std::mutex> lock(mutex);
+        manager->addShape(std::move(shape));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+        delete manager;
+}
+BENCHMARK(BM_LockedShapeManagerAdd)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ConcurrentShapeManagerAdd(benchmark::State &state)
+{
+    static ConcurrentShapeManager *manager;
+    if (state.thread_index() == 0)
+        manager = new ConcurrentShapeManager();
+
+    for (auto _ : state)
+    {
+        manager->addShape(std::make_unique<Rectangle>(0.0, 0.0, 1.0, 1.0));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+        delete manager;
+}
+BENCHMARK(BM_ConcurrentShapeManagerAdd)->ThreadRange(1, 8)->UseRealTime();
+
+// Scene frame end to end: load, move, record areas, draw, then keep the shapes
+namespace
+{
+    constexpr size_t SCENE_BATCH = 1024;
+
+    ScenePipeline::Loader sceneLoader(size_t count)
+    {
+        return [count, loaded = size_t{0}](ScenePipeline::Batch &batch) mutable
+        {
+            if (loaded == count)
+                return false;
+            size_t end = std::min(count, loaded + SCENE_BATCH);
+            batch.reserve(end - loaded);
+            for (; loaded < end; ++loaded)
+            {
+                double offset = static_cast<double>(loaded % 1000);
+                if (loaded % 2 == 0)
+                    batch.push_back(std::make_unique<Rectangle>(offset, offset, 2.0, 3.0));
+                else
+                    batch.push_back(std::make_unique<Circle>(offset, offset, 1.5));
+            }
+            return true;
+        };
+    }
+}
+
+static void BM_SceneSequential(benchmark::State &state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        std::ostringstream out;
+        BinaryDrawSink sink(out);
+        ShapeManager scene;
+        utils::StatisticsCalculator areas;
+        ScenePipeline::Loader loader = sceneLoader(count);
+        ScenePipeline::Batch batch;
+        while (loader(batch))
+        {
+            for (auto &shape : batch)
+            {
+                shape->move(1.0, 0.0);
+                areas.addValue(shape->area());
+            }
+            for (const auto &shape : batch)
+            {
+                shape->draw(sink);
+            }
+            sink.flush();
+            for (auto &shape : batch)
+            {
+                scene.addShape(std::move(shape));
+            }
+            batch.clear();
+        }
+        benchmark::DoNotOptimize(scene.calculateTotalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneSequential)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ScenePipeline(benchmark::State &state)
+{
+    size_t count = static_cast<size_t>(state.range(0));
+    ScenePipeline pipeline;
+    for (auto _ : state)
+    {
+        std::ostringstream out;
+        BinaryDrawSink sink(out);
+        ShapeManager scene;
+        pipeline.run(sceneLoader(count), [](Shape &shape)
+                     { shape.move(1.0, 0.0); },
+                     sink, scene);
+        benchmark::DoNotOptimize(scene.calculateTotalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ScenePipeline)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Startup: rebuild a scene in code versus map or load it from a scene file
+namespace
+{
+    std::string writeSceneFile(size_t count)
+    {
+        ShapeStore store;
+        generateShapes(
+            count, [&](double x, double y, double w, double h) { store.addRectangle(x, y, w, h); },
+            [&](double x, double y, double r) { store.addCircle(x, y, r); });
+        std::string path = (std::filesystem::temp_directory_path() / "shape_benchmarks.scene").string();
+        SceneFile::write(store, path);
+        return path;
+    }
+}
+
+static void BM_SceneStartupBuild(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        ShapeManager manager;
+        generateShapes(
+            static_cast<size_t>(state.range(0)),
+            [&](double x, double y, double w, double h)
+            { manager.addShape(std::make_unique<Rectangle>(x, y, w, h)); },
+            [&](double x, double y, double r) { manager.addShape(std::make_unique<Circle>(x, y, r)); });
+        benchmark::DoNotOptimize(manager.calculateTotalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneStartupBuild)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SceneStartupMapped(benchmark::State &state)
+{
+    std::string path = writeSceneFile(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        MappedScene scene;
+        scene.open(path);
+        benchmark::DoNotOptimize(scene.getView().totalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_SceneStartupMapped)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_SceneStartupLoad(benchmark::State &state)
+{
+    std::string path = writeSceneFile(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        ShapeStore store;
+        SceneFile::load(path, store);
+        benchmark::DoNotOptimize(store.totalArea());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_SceneStartupLoad)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,240 @@
+#include "utils/MathUtils.h"
+#include "utils/RadixSort.h"
+#include "utils/StatisticsSummary.h"
+#include "utils/WindowedStatistics.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace utils;
+
+namespace
+{
+    enum Pattern
+    {
+        Random,
+        Sorted,
+        Reversed,
+        NearlySorted,
+        FewUnique
+    };
+
+    const char *patternName(int pattern)
+    {
+        static const char *names[] = {"random", "sorted", "reversed", "nearly_sorted", "few_unique"};
+        return names[pattern];
+    }
+
+    std::vector<double> generateData(size_t count, int pattern)
+    {
+        std::mt19937_64 rng(42);
+        std::normal_distribution<double> normal(50.0, 15.0);
+        std::vector<double> data(count);
+        for (double &value : data)
+        {
+            value = normal(rng);
+        }
+
+        switch (pattern)
+        {
+        case Sorted:
+            std::sort(data.begin(), data.end());
+            break;
+        case Reversed:
+            std::sort(data.begin(), data.end(), std::greater<double>());
+            break;
+        case NearlySorted:
+        {
+            // 1% of positions swapped at random
+            std::sort(data.begin(), data.end());
+            std::uniform_int_distribution<size_t> index(0, count - 1);
+            for (size_t i = 0; i < count / 100; ++i)
+            {
+                std::swap(data[index(rng)], data[index(rng)]);
+            }
+            break;
+        }
+        case FewUnique:
+            for (double &value : data)
+            {
+                value = std::round(value / 10.0) * 10.0;
+            }
+            break;
+        default:
+            break;
+        }
+        return data;
+    }
+
+    StatisticsCalculator makeCalculator(benchmark::State &state)
+    {
+        StatisticsCalculator calc;
+        calc.addValues(generateData(static_cast<size_t>(state.range(0)), static_cast<int>(state.range(1))));
+        state.SetLabel(patternName(static_cast<int>(state.range(1))));
+        return calc;
+    }
+
+    void dataArguments(benchmark::internal::Benchmark *benchmark)
+    {
+        benchmark->ArgNames({"n", "pattern"})
+            ->ArgsProduct({{1000, 10000, 100000, 1000000, 10000000},
+                           {Random, Sorted, Reversed, NearlySorted, FewUnique}})
+            ->Unit(benchmark::kMicrosecond);
+    }
+}
+
+// calculate() reorders the samples in place, so each iteration starts from a
+// fresh copy of the generated pattern
+static void BM_StatisticsCalculate(benchmark::State &state)
+{
+    StatisticsCalculator calc = makeCalculator(state);
+    StatisticsCalculator working;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        working = calc;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(working.calculate());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StatisticsCalculate)->Apply(dataArguments);
+
+// Same samples stored as float, double or int (scaled to microsecond-like integers)
+template <typename T>
+static void BM_NativeStatisticsCalculate(benchmark::State &state)
+{
+    std::vector<double> data = generateData(static_cast<size_t>(state.range(0)), Random);
+    BasicStatisticsCalculator<T> calc;
+    calc.reserve(data.size());
+    for (double value : data)
+    {
+        calc.addValue(static_cast<T>(std::is_integral_v<T> ? value * 1000.0 : value));
+    }
+
+    BasicStatisticsCalculator<T> working;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        working = calc;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(working.calculate());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_NativeStatisticsCalculate, float)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_NativeStatisticsCalculate, double)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_NativeStatisticsCalculate, int)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMicrosecond);
+
+// First query on fresh data, including the sort it triggers
+static void BM_StatisticsPercentileCold(benchmark::State &state)
+{
+    StatisticsCalculator calc = makeCalculator(state);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        StatisticsCalculator fresh = calc;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(fresh.getPercentile(95.0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StatisticsPercentileCold)->Apply(dataArguments);
+
+// The sort behind a cold percentile: std::sort against serial and parallel radix sort
+static void BM_SortSamples(benchmark::State &state)
+{
+    static const char *names[] = {"std_sort", "radix", "parallel_radix"};
+    std::vector<double> data = generateData(static_cast<size_t>(state.range(0)), Random);
+    std::vector<double> values;
+    int method = static_cast<int>(state.range(1));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        values = data;
+        state.ResumeTiming();
+        if (method == 0)
+            std::sort(values.begin(), values.end());
+        else if (method == 1)
+            RadixSort::serialSort(values);
+        else
+            RadixSort::parallelSort(values);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(names[method]);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortSamples)
+    ->ArgNames({"n", "method"})
+    ->ArgsProduct({{1000, 10000, 100000, 1000000, 10000000}, {0, 1, 2}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Repeated queries against the cached sorted data
+static void BM_StatisticsPercentileWarm(benchmark::State &state)
+{
+    StatisticsCalculator calc = makeCalculator(state);
+    calc.getPercentile(50.0);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(calc.getPercentile(95.0));
+    }
+}
+BENCHMARK(BM_StatisticsPercentileWarm)->Apply(dataArguments);
+
+static void BM_StatisticsHistogram(benchmark::State &state)
+{
+    StatisticsCalculator calc = makeCalculator(state);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(calc.getHistogram(64));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StatisticsHistogram)->Apply(dataArguments);
+
+// Windowed p99 query: cost scales with the bucket count, not the samples ingested
+static void BM_SlidingWindowPercentile(benchmark::State &state)
+{
+    std::vector<double> data = generateData(static_cast<size_t>(state.range(0)), Random);
+    SlidingWindowStatistics window(std::chrono::seconds(60));
+    auto start = SlidingWindowStatistics::Clock::time_point();
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        window.addValue(data[i], start + std::chrono::milliseconds(60000 * i / data.size()));
+    }
+    auto now = start + std::chrono::seconds(59);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(window.getPercentile(99.0, now));
+    }
+}
+BENCHMARK(BM_SlidingWindowPercentile)->RangeMultiplier(10)->Range(1000, 1000000);
+
+// Aggregator side: parse a shipped summary in place and merge it, versus its sample count
+static void BM_SummaryParseAndMerge(benchmark::State &state)
+{
+    std::vector<double> data = generateData(static_cast<size_t>(state.range(0)), Random);
+    StatisticsSummary worker;
+    worker.addValues(data);
+    std::vector<uint8_t> bytes = worker.serialize();
+
+    for (auto _ : state)
+    {
+        StatisticsSummary aggregate;
+        StatisticsSummaryView view;
+        bool merged = view.parse(bytes) && aggregate.merge(view);
+        benchmark::DoNotOptimize(merged);
+        benchmark::DoNotOptimize(aggregate.getCount());
+    }
+    state.counters["bytes"] = static_cast<double>(bytes.size());
+}
+BENCHMARK(BM_SummaryParseAndMerge)->RangeMultiplier(10)->Range(1000, 1000000);
@@ -0,0 +1,319 @@
+#include "geometry/BvhIndex.h"
+#include "geometry/PointIndex.h"
+#include "utils/DistanceMatrix.h"
+#include "utils/MathUtils.h"
+#include "utils/VectorExpression.h"
+#include "utils/VectorSimd.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace utils;
+
+namespace
+{
+    template <typename T>
+    std::vector<Vector2D<T>> generateVectors(size_t count)
+    {
+        // Components stay away from zero so normalized() never takes the zero-vector path
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<int> component(1, 1000);
+        std::vector<Vector2D<T>> vectors;
+        vectors.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            vectors.emplace_back(static_cast<T>(component(rng)), static_cast<T>(component(rng)));
+        }
+        return vectors;
+    }
+}
+
+template <typename T>
+static void BM_VectorAdd(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto b = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<Vector2D<T>> out(a.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            out[i] = a[i] + b[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_VectorDot(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto b = generateVectors<T>(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        T total{};
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            total += a[i].dot(b[i]);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_VectorMagnitude(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        T total{};
+        for (const auto &v : a)
+        {
+            total += v.magnitude();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_VectorNormalized(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<Vector2D<T>> out(a.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            out[i] = a[i].normalized();
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, typename Precision>
+static void BM_VectorMagnitudeWith(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        T total{};
+        for (const auto &v : a)
+        {
+            total += v.magnitude(Precision{});
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, typename Precision>
+static void BM_VectorNormalizedWith(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<Vector2D<T>> out(a.size());
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            out[i] = a[i].normalized(Precision{});
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_SimdMagnitude(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<T> out(a.size());
+
+    for (auto _ : state)
+    {
+        simd::magnitude(std::span<const Vector2D<T>>(a), std::span<T>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::instructionSetName(simd::activeInstructionSet()));
+}
+
+// out = (a + b) * s - c over whole arrays: one pass per operator through
+// temporaries, a hand-fused loop, and an expression template
+template <typename T>
+static void BM_VectorChainPasses(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto b = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto c = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<Vector2D<T>> out(a.size());
+    T s = static_cast<T>(3);
+
+    for (auto _ : state)
+    {
+        std::vector<Vector2D<T>> sum(a.size());
+        simd::add(std::span<const Vector2D<T>>(a), std::span<const Vector2D<T>>(b), std::span<Vector2D<T>>(sum));
+        for (auto &v : sum)
+        {
+            v *= s;
+        }
+        simd::subtract(std::span<const Vector2D<T>>(sum), std::span<const Vector2D<T>>(c),
+                       std::span<Vector2D<T>>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_VectorChainFused(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto b = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto c = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<Vector2D<T>> out(a.size());
+    T s = static_cast<T>(3);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            out[i] = (a[i] + b[i]) * s - c[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+static void BM_VectorChainExpression(benchmark::State &state)
+{
+    auto a = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto b = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    auto c = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<Vector2D<T>> out(a.size());
+    T s = static_cast<T>(3);
+
+    for (auto _ : state)
+    {
+        expr::evaluate((expr::view(a) + expr::view(b)) * s - expr::view(c), out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(simd::instructionSetName(simd::activeInstructionSet()));
+}
+
+// All-pairs distances one at a time, as the calculateDistance() helper in main.cpp
+static void BM_PairwiseDistanceScalar(benchmark::State &state)
+{
+    auto points = generateVectors<double>(static_cast<size_t>(state.range(0)));
+    std::vector<double> out(points.size() * points.size());
+
+    for (auto _ : state)
+    {
+        for (size_t row = 0; row < points.size(); ++row)
+        {
+            for (size_t column = 0; column < points.size(); ++column)
+            {
+                out[row * points.size() + column] = (points[column] - points[row]).magnitude();
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_PairwiseDistanceScalar)->RangeMultiplier(4)->Range(256, 4096)->Unit(benchmark::kMicrosecond);
+
+template <typename T>
+static void BM_DistanceMatrixSquared(benchmark::State &state)
+{
+    auto points = generateVectors<T>(static_cast<size_t>(state.range(0)));
+    std::vector<T> out(points.size() * points.size());
+
+    for (auto _ : state)
+    {
+        DistanceMatrix::squared(std::span<const Vector2D<T>>(points), std::span<const Vector2D<T>>(points),
+                                std::span<T>(out));
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+    state.SetLabel(simd::instructionSetName(simd::activeInstructionSet()));
+}
+BENCHMARK_TEMPLATE(BM_DistanceMatrixSquared, float)->RangeMultiplier(4)->Range(256, 4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DistanceMatrixSquared, double)->RangeMultiplier(4)->Range(256, 4096)->Unit(benchmark::kMicrosecond);
+
+// Nearest point for 1000 queries: brute-force tiles against the BVH-backed index
+static void BM_NearestBruteForce(benchmark::State &state)
+{
+    auto points = generateVectors<double>(static_cast<size_t>(state.range(0)));
+    auto queries = generateVectors<double>(1000);
+    std::vector<size_t> indices(queries.size());
+    std::vector<double> distances(queries.size());
+
+    for (auto _ : state)
+    {
+        DistanceMatrix::nearest(queries, points, indices, distances);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_NearestBruteForce)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_NearestPointIndex(benchmark::State &state)
+{
+    auto points = generateVectors<double>(static_cast<size_t>(state.range(0)));
+    auto queries = generateVectors<double>(1000);
+    geometry::PointIndex index(std::make_unique<geometry::BvhIndex>());
+    index.add(points);
+    std::vector<size_t> ids;
+
+    for (auto _ : state)
+    {
+        index.nearest(queries, 1, ids);
+        benchmark::DoNotOptimize(ids.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_NearestPointIndex)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+#define VECTOR_BENCHMARKS(T)                                                                  \
+    BENCHMARK_TEMPLATE(BM_VectorAdd, T)->RangeMultiplier(16)->Range(256, 1 << 20);            \
+    BENCHMARK_TEMPLATE(BM_VectorDot, T)->RangeMultiplier(16)->Range(256, 1 << 20);            \
+    BENCHMARK_TEMPLATE(BM_VectorMagnitude, T)->RangeMultiplier(16)->Range(256, 1 << 20);      \
+    BENCHMARK_TEMPLATE(BM_VectorNormalized, T)->RangeMultiplier(16)->Range(256, 1 << 20);     \
+    BENCHMARK_TEMPLATE(BM_SimdMagnitude, T)->RangeMultiplier(16)->Range(256, 1 << 20);        \
+    BENCHMARK_TEMPLATE(BM_VectorChainPasses, T)->RangeMultiplier(16)->Range(256, 1 << 20);    \
+    BENCHMARK_TEMPLATE(BM_VectorChainFused, T)->RangeMultiplier(16)->Range(256, 1 << 20);     \
+    BENCHMARK_TEMPLATE(BM_VectorChainExpression, T)->RangeMultiplier(16)->Range(256, 1 << 20)
+
+#define PRECISION_BENCHMARKS(T, Precision)                                                                \
+    BENCHMARK_TEMPLATE(BM_VectorMagnitudeWith, T, Precision)->RangeMultiplier(16)->Range(256, 1 << 20);  \
+    BENCHMARK_TEMPLATE(BM_VectorNormalizedWith, T, Precision)->RangeMultiplier(16)->Range(256, 1 << 20)
+
+VECTOR_BENCHMARKS(float);
+VECTOR_BENCHMARKS(double);
+VECTOR_BENCHMARKS(int);
+
+PRECISION_BENCHMARKS(float, precision::Fast);
+PRECISION_BENCHMARKS(float, precision::Precise);
+PRECISION_BENCHMARKS(double, precision::Fast);
+PRECISION_BENCHMARKS(double, precision::Precise);
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "geometry/Shape.h"
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Closed set of the built-in shapes, held by value.
+     *
+     * Use this where the shape types are known up front; the Shape
+     * hierarchy remains the extension point for user-defined shapes.
+     */
+    using AnyShape = std::variant<Rectangle, Circle>;
+
+    // Statically dispatched operations (qualified calls bypass the vtable)
+    inline double area(const AnyShape &shape)
+    {
+        return std::visit([](const auto &s)
+                          {
+                              using T = std::decay_t<decltype(s)>;
+                              return s.T::area();
+                          },
+                          shape);
+    }
+
+    inline double perimeter(const AnyShape &shape)
+    {
+        return std::visit([](const auto &s)
+                          {
+                              using T = std::decay_t<decltype(s)>;
+                              return s.T::perimeter();
+                          },
+                          shape);
+    }
+
+    inline void draw(const AnyShape &shape)
+    {
+        std::visit([](const auto &s)
+                   {
+                       using T = std::decay_t<decltype(s)>;
+                       s.T::draw();
+                   },
+                   shape);
+    }
+
+    inline void draw(const AnyShape &shape, DrawSink &sink)
+    {
+        std::visit([&sink](const auto &s)
+                   {
+                       using T = std::decay_t<decltype(s)>;
+                       s.T::draw(sink);
+                   },
+                   shape);
+    }
+
+    inline const Shape &asShape(const AnyShape &shape)
+    {
+        return std::visit([](const auto &s) -> const Shape & { return s; }, shape);
+    }
+
+    /**
+     * Contiguous, insertion-ordered list of AnyShape values.
+     *
+     * Bulk operations visit each element with the concrete type known at
+     * compile time, so area and perimeter inline into the loop instead of
+     * going through a virtual call per shape.
+     */
+    class AnyShapeList
+    {
+    public:
+        AnyShapeList() = default;
+        ~AnyShapeList() = default;
+
+        // Shape management (returns the shape's index)
+        size_t add(const AnyShape &shape);
+        template <typename T, typename... Args>
+        T &emplace(Args &&...args)
+        {
+            AnyShape &slot = shapes_.emplace_back(std::in_place_type<T>, std::forward<Args>(args)...);
+            return std::get<T>(slot);
+        }
+        void reserve(size_t capacity) { shapes_.reserve(capacity); }
+        void clear() { shapes_.clear(); }
+
+        // Bulk operations
+        double totalArea() const;
+        double totalPerimeter() const;
+        void drawAll() const;
+        void drawAll(DrawSink &sink) const;
+        void moveAll(double dx, double dy);
+
+        template <typename Visitor>
+        void forEach(Visitor &&visitor) const
+        {
+            for (const AnyShape &shape : shapes_)
+            {
+                std::visit(visitor, shape);
+            }
+        }
+
+        // Accessors
+        std::span<const AnyShape> getShapes() const { return shapes_; }
+        const AnyShape &at(size_t index) const { return shapes_[index]; }
+        size_t getShapeCount() const { return shapes_.size(); }
+        bool isEmpty() const { return shapes_.empty(); }
+
+    private:
+        std::vector<AnyShape> shapes_;
+    };
+
+} // namespace geometry
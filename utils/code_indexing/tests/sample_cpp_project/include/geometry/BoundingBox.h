@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace geometry
+{
+
+    /**
+     * Axis-aligned bounding box with inclusive edges.
+     */
+    struct BoundingBox
+    {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+
+        BoundingBox() : minX(0), minY(0), maxX(0), maxY(0) {}
+        BoundingBox(double x0, double y0, double x1, double y1)
+            : minX(x0), minY(y0), maxX(x1), maxY(y1) {}
+
+        double width() const { return maxX - minX; }
+        double height() const { return maxY - minY; }
+        double perimeter() const { return 2.0 * (width() + height()); }
+
+        bool intersects(const BoundingBox &other) const
+        {
+            return minX <= other.maxX && other.minX <= maxX &&
+                   minY <= other.maxY && other.minY <= maxY;
+        }
+
+        bool contains(double x, double y) const
+        {
+            return x >= minX && x <= maxX && y >= minY && y <= maxY;
+        }
+
+        bool contains(const BoundingBox &other) const
+        {
+            return other.minX >= minX && other.maxX <= maxX &&
+                   other.minY >= minY && other.maxY <= maxY;
+        }
+
+        BoundingBox merged(const BoundingBox &other) const
+        {
+            return BoundingBox(std::min(minX, other.minX), std::min(minY, other.minY),
+                               std::max(maxX, other.maxX), std::max(maxY, other.maxY));
+        }
+
+        BoundingBox expanded(double margin) const
+        {
+            return BoundingBox(minX - margin, minY - margin, maxX + margin, maxY + margin);
+        }
+
+        // Euclidean distance from a point to the box (zero inside)
+        double distanceTo(double x, double y) const
+        {
+            double dx = std::max({minX - x, 0.0, x - maxX});
+            double dy = std::max({minY - y, 0.0, y - maxY});
+            return std::sqrt(dx * dx + dy * dy);
+        }
+    };
+
+} // namespace geometry
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "geometry/SpatialIndex.h"
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Dynamic bounding volume hierarchy for sparse or unevenly sized scenes.
+     *
+     * Leaves store a box padded by a margin proportional to the entry's
+     * size, so small moves are absorbed without touching the tree. Larger
+     * changes reinsert the leaf, and rotations keep the tree height-balanced.
+     */
+    class BvhIndex : public SpatialIndex
+    {
+    public:
+        explicit BvhIndex(double marginRatio = DEFAULT_MARGIN_RATIO);
+
+        // Entry management
+        size_t insert(const BoundingBox &box) override;
+        void update(size_t id, const BoundingBox &box) override;
+        void remove(size_t id) override;
+        void clear() override;
+
+        // Queries
+        void query(const BoundingBox &region, std::vector<size_t> &out) const override;
+        void nearest(double x, double y, size_t k, std::vector<size_t> &out,
+                     const DistanceFunction &distance = {}) const override;
+
+        // Accessors
+        BoundingBox getBounds(size_t id) const override { return boxes_[id]; }
+        size_t getCount() const override { return count_; }
+        int getHeight() const { return (root_ == NONE) ? 0 : nodes_[root_].height; }
+
+        // Constants
+        static constexpr double DEFAULT_MARGIN_RATIO = 0.1;
+
+    private:
+        static constexpr int NONE = -1;
+
+        struct Node
+        {
+            BoundingBox box; // padded for leaves
+            int parent;
+            int left;
+            int right;
+            int height; // 0 for leaves
+            size_t id;
+
+            bool isLeaf() const { return left == NONE; }
+        };
+
+        double marginRatio_;
+        std::vector<Node> nodes_;
+        std::vector<int> freeNodes_;
+        int root_;
+
+        // Per-id exact box and leaf node (NONE for free ids)
+        std::vector<BoundingBox> boxes_;
+        std::vector<int> leaves_;
+        std::vector<size_t> freeIds_;
+        size_t count_;
+
+        // Helper methods
+        int allocateNode();
+        void releaseNode(int node);
+        BoundingBox padded(const BoundingBox &box) const;
+        void insertLeaf(int leaf);
+        void removeLeaf(int leaf);
+        void refitFrom(int node);
+        int balance(int node);
+    };
+
+} // namespace geometry
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "geometry/ShapeStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Two overlapping shapes, by store-order index (first < second).
+     */
+    struct CollisionPair
+    {
+        size_t first;
+        size_t second;
+
+        bool operator==(const CollisionPair &other) const = default;
+        bool operator<(const CollisionPair &other) const
+        {
+            return first < other.first || (first == other.first && second < other.second);
+        }
+    };
+
+    /**
+     * All-pairs collision detection over a ShapeStore, meant to run once
+     * per tick.
+     *
+     * The broad phase splits the scene into horizontal bands a few boxes
+     * high, files every bounding box under each band it overlaps, and sweeps
+     * each band along x, keeping pairs whose boxes also overlap in y; the
+     * bands keep the sweep near linear where a single sweep over the whole
+     * scene would pair each box with its entire x slab. The x order is kept
+     * between calls and repaired with an insertion sort, so a tick in which
+     * shapes moved a little skips most of the sorting; large reshuffles fall
+     * back to a full sort. Rectangle pairs are exact after the broad phase.
+     * Circle-circle and circle-rectangle candidates are gathered into blocks
+     * of columns and resolved by SIMD kernels chosen by
+     * utils::simd::activeInstructionSet(), which agree exactly with
+     * Intersection. Bands are swept in parallel once the store holds
+     * MIN_PARALLEL_SHAPES shapes (at most 2^32 shapes in all).
+     *
+     * A detector holds scratch buffers; use one per thread.
+     */
+    class CollisionDetector
+    {
+    public:
+        // Every overlapping pair (touching counts), sorted by first, then second
+        void findCollisions(const ShapeStore &store, std::vector<CollisionPair> &out);
+        std::vector<CollisionPair> findCollisions(const ShapeStore &store);
+
+        // Broad-phase pairs examined by the last call
+        size_t getCandidateCount() const { return candidateCount_; }
+
+        // Constants
+        static constexpr size_t MIN_PARALLEL_SHAPES = size_t{1} << 14;
+        static constexpr size_t SWEEPS_PER_THREAD = 4;
+        static constexpr size_t NARROW_BLOCK = 256;
+        static constexpr size_t MAX_REPAIR_SHIFTS_PER_SHAPE = 8;
+        static constexpr double BAND_HEIGHT_FACTOR = 4.0; // band height in mean box heights
+        static constexpr size_t MIN_SHAPES_PER_BAND = 4;
+
+    private:
+        // Output of one sweep range: narrow-phase candidates and confirmed hits
+        struct RangeResult
+        {
+            std::vector<CollisionPair> hits;
+            std::vector<CollisionPair> circleCircle;
+            std::vector<CollisionPair> circleRectangle;
+            size_t candidateCount = 0;
+        };
+
+        // Boxes in store order, and the sweep order over them
+        std::vector<double> minX_;
+        std::vector<double> minY_;
+        std::vector<double> maxX_;
+        std::vector<double> maxY_;
+        std::vector<uint32_t> order_;
+
+        // Bands: entries bandStart_[b] to bandStart_[b + 1] are band b's boxes in x order
+        size_t bandCount_ = 1;
+        double bandOrigin_ = 0.0;
+        double bandScale_ = 0.0;
+        std::vector<size_t> bandStart_;
+        std::vector<size_t> bandCursor_;
+        std::vector<uint32_t> sortedIndex_;
+        std::vector<double> sortedMinX_;
+        std::vector<double> sortedMinY_;
+        std::vector<double> sortedMaxX_;
+        std::vector<double> sortedMaxY_;
+
+        std::vector<RangeResult> ranges_;
+        size_t candidateCount_ = 0;
+
+        // Helper methods
+        void computeBounds(const ShapeStore &store);
+        void sortByMinX();
+        void buildBands();
+        size_t bandOf(double y) const;
+        void sweep(const ShapeStore &store);
+        void sweepRange(const ShapeStore &store, size_t bandBegin, size_t bandEnd, RangeResult &result) const;
+        static void resolveCircles(const ShapeStore &store, RangeResult &result);
+        static void resolveCircleRectangles(const ShapeStore &store, RangeResult &result);
+    };
+
+} // namespace geometry
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "geometry/Shape.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace geometry
+{
+
+    class DrawSink;
+
+    /**
+     * Owning shape collection with lock-free, multi-producer append.
+     *
+     * Each add makes sure the segment it will land in exists, claims a slot
+     * with one compare-and-swap and publishes the shape into it; slots live
+     * in segments of doubling size that are never moved, so producers never
+     * wait on each other, and nothing that can throw runs between claiming
+     * a slot and filling it. Readers take a Snapshot:
+     * the longest prefix of published shapes, which stays valid and
+     * unchanged while producers keep adding. Shapes are never removed
+     * except by clear(), which requires that no other thread is using the
+     * manager or a snapshot of it.
+     */
+    class ConcurrentShapeManager
+    {
+    private:
+        using Slot = std::atomic<Shape *>;
+
+    public:
+        /**
+         * Immutable view of the first getShapeCount() shapes.
+         */
+        class Snapshot
+        {
+        public:
+            // Calls fn(const Shape &) for each shape in insertion order
+            template <typename Fn>
+            void forEach(Fn &&fn) const
+            {
+                for (size_t segment = 0, begin = 0; begin < count_; ++segment)
+                {
+                    const Slot *slots = manager_->segments_[segment].load(std::memory_order_acquire);
+                    size_t end = std::min(count_, begin + segmentSize(segment));
+                    for (size_t i = 0; i < end - begin; ++i)
+                    {
+                        fn(static_cast<const Shape &>(*slots[i].load(std::memory_order_acquire)));
+                    }
+                    begin = end;
+                }
+            }
+
+            // Draws every shape into one batch with a single flush per call
+            void drawAll() const;
+            void drawAll(DrawSink &sink) const;
+
+            double calculateTotalArea() const;
+
+            const Shape &at(size_t index) const;
+            size_t getShapeCount() const { return count_; }
+            bool isEmpty() const { return count_ == 0; }
+
+        private:
+            friend class ConcurrentShapeManager;
+            Snapshot(const ConcurrentShapeManager *manager, size_t count) : manager_(manager), count_(count) {}
+
+            const ConcurrentShapeManager *manager_;
+            size_t count_;
+        };
+
+        ConcurrentShapeManager();
+        ~ConcurrentShapeManager();
+
+        ConcurrentShapeManager(const ConcurrentShapeManager &) = delete;
+        ConcurrentShapeManager &operator=(const ConcurrentShapeManager &) = delete;
+
+        // Shape management (thread-safe and lock-free; null shapes are ignored)
+        void addShape(std::unique_ptr<Shape> shape);
+        void addShapes(std::vector<std::unique_ptr<Shape>> shapes);
+
+        // Requires exclusive access
+        void clear();
+
+        // Readers (thread-safe; the convenience forms read a fresh snapshot)
+        Snapshot snapshot() const;
+        void drawAll() const { snapshot().drawAll(); }
+        void drawAll(DrawSink &sink) const { snapshot().drawAll(sink); }
+        double calculateTotalArea() const { return snapshot().calculateTotalArea(); }
+        size_t getShapeCount() const { return snapshot().getShapeCount(); }
+
+        // Constants
+        static constexpr size_t FIRST_SEGMENT_SIZE = 1 << 10;
+        static constexpr size_t MAX_SEGMENTS = 40;
+
+    private:
+        std::atomic<Slot *> segments_[MAX_SEGMENTS];
+        alignas(64) std::atomic<size_t> reserved_;          // slots claimed by producers
+        alignas(64) mutable std::atomic<size_t> published_; // every slot below is filled
+
+        // Helper methods
+        static constexpr size_t segmentSize(size_t segment) { return FIRST_SEGMENT_SIZE << segment; }
+        static void locate(size_t index, size_t &segment, size_t &offset);
+        Slot &slotAt(size_t index) const;
+        size_t reserve(size_t count);
+        void allocateSegment(size_t segment);
+    };
+
+} // namespace geometry
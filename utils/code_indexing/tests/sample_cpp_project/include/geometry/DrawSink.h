@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Destination for shape draw commands.
+     *
+     * Sinks may buffer freely; nothing is guaranteed to reach the output
+     * until flush(), which callers issue once per frame.
+     */
+    class DrawSink
+    {
+    public:
+        virtual ~DrawSink() = default;
+
+        virtual void drawRectangle(double x, double y, double width, double height) = 0;
+        virtual void drawCircle(double x, double y, double radius) = 0;
+        virtual void flush() = 0;
+    };
+
+    /**
+     * Formats commands as human-readable lines in one growing buffer.
+     *
+     * Numbers use the default ostream format (6 significant digits), so
+     * the output matches the unbuffered draw() methods.
+     */
+    class TextDrawSink : public DrawSink
+    {
+    public:
+        explicit TextDrawSink(std::ostream &out = std::cout);
+        ~TextDrawSink() override;
+
+        void drawRectangle(double x, double y, double width, double height) override;
+        void drawCircle(double x, double y, double radius) override;
+
+        // Writes the buffer with a single write and flushes the stream
+        void flush() override;
+
+        // Accessors
+        const std::string &getBuffer() const { return buffer_; }
+
+    private:
+        std::ostream &out_;
+        std::string buffer_;
+
+        // Helper methods
+        void appendNumber(double value);
+    };
+
+    /**
+     * Encodes commands as a compact binary stream.
+     *
+     * Each command is one opcode byte followed by its operands as native
+     * byte-order IEEE-754 doubles.
+     */
+    class BinaryDrawSink : public DrawSink
+    {
+    public:
+        enum class Command : uint8_t
+        {
+            Rectangle = 1,
+            Circle = 2
+        };
+
+        explicit BinaryDrawSink(std::ostream &out);
+        ~BinaryDrawSink() override;
+
+        void drawRectangle(double x, double y, double width, double height) override;
+        void drawCircle(double x, double y, double radius) override;
+        void flush() override;
+
+        // Accessors
+        const std::vector<char> &getBuffer() const { return buffer_; }
+
+    private:
+        std::ostream &out_;
+        std::vector<char> buffer_;
+
+        // Helper methods
+        void append(Command command, std::initializer_list<double> operands);
+    };
+
+    /**
+     * Discards commands, counting them; for benchmarks and dry runs.
+     */
+    class NullDrawSink : public DrawSink
+    {
+    public:
+        void drawRectangle(double, double, double, double) override { ++commandCount_; }
+        void drawCircle(double, double, double) override { ++commandCount_; }
+        void flush() override { ++flushCount_; }
+
+        // Accessors
+        size_t getCommandCount() const { return commandCount_; }
+        size_t getFlushCount() const { return flushCount_; }
+
+    private:
+        size_t commandCount_ = 0;
+        size_t flushCount_ = 0;
+    };
+
+} // namespace geometry
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "geometry/BoundingBox.h"
+#include <algorithm>
+
+namespace geometry
+{
+
+    /**
+     * Exact overlap tests between circles and axis-aligned boxes.
+     *
+     * Shapes are closed, so touching edges count as overlapping, matching
+     * BoundingBox::intersects. The tests compare squared distances and take
+     * no square roots; the batch narrow phase in CollisionDetector performs
+     * the same operations lane by lane and agrees with them exactly.
+     */
+    class Intersection
+    {
+    public:
+        static bool boxBox(const BoundingBox &a, const BoundingBox &b) { return a.intersects(b); }
+
+        static bool circleCircle(double ax, double ay, double aRadius, double bx, double by, double bRadius)
+        {
+            double dx = ax - bx;
+            double dy = ay - by;
+            double reach = aRadius + bRadius;
+            return dx * dx + dy * dy <= reach * reach;
+        }
+
+        // Distance from the center to the nearest point of the box
+        static bool circleBox(double x, double y, double radius, const BoundingBox &box)
+        {
+            double dx = x - std::min(std::max(x, box.minX), box.maxX);
+            double dy = y - std::min(std::max(y, box.minY), box.maxY);
+            return dx * dx + dy * dy <= radius * radius;
+        }
+
+    private:
+        // Prevent instantiation
+        Intersection() = delete;
+        ~Intersection() = delete;
+        Intersection(const Intersection &) = delete;
+        Intersection &operator=(const Intersection &) = delete;
+    };
+
+} // namespace geometry
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "geometry/SpatialIndex.h"
+#include "utils/MathUtils.h"
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * k-nearest-neighbour queries over a point set, backed by a SpatialIndex.
+     *
+     * Points are stored as degenerate boxes, so the index's box distance is
+     * already the exact Euclidean distance and nearest() needs no
+     * refinement callback. Point ids follow insertion order. Batched queries
+     * share the read-only index across hardwareThreads().
+     */
+    class PointIndex
+    {
+    public:
+        explicit PointIndex(std::unique_ptr<SpatialIndex> index);
+
+        // Point management
+        size_t add(const utils::Vec2d &point);
+        void add(std::span<const utils::Vec2d> points);
+        void clear();
+
+        // The k points nearest to query, closest first (ties in unspecified order)
+        void nearest(const utils::Vec2d &query, size_t k, std::vector<size_t> &out) const;
+
+        // min(k, getPointCount()) ids per query, row-major and closest first
+        void nearest(std::span<const utils::Vec2d> queries, size_t k, std::vector<size_t> &out) const;
+
+        // Accessors
+        const utils::Vec2d &getPoint(size_t id) const { return points_[id]; }
+        std::span<const utils::Vec2d> getPoints() const { return points_; }
+        size_t getPointCount() const { return points_.size(); }
+        const SpatialIndex &getIndex() const { return *index_; }
+
+        // Constants
+        static constexpr size_t MIN_PARALLEL_QUERIES = 256;
+
+    private:
+        std::unique_ptr<SpatialIndex> index_;
+        std::vector<utils::Vec2d> points_;
+        std::vector<size_t> pointIds_; // indexed by SpatialIndex id
+    };
+
+} // namespace geometry
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "geometry/BoundingBox.h"
+#include "geometry/Shape.h"
+#include "geometry/ShapeStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Flat on-disk scene whose layout mirrors ShapeStore.
+     *
+     * Format version 2, all fields little-endian and 8-byte aligned:
+     *
+     *   u32 magic, u16 version, u16 flags (0)
+     *   u64 generation, u64 rectangle count R, u64 circle count C
+     *   f64 rectangle x[R], y[R], width[R], height[R]
+     *   f64 circle x[C], y[C], radius[C]
+     *
+     * A scene file is mapped and viewed in place (MappedScene, SceneView)
+     * without parsing or per-shape allocation, or bulk-copied into a
+     * ShapeStore for editing. Edits made since the file was written live in
+     * a SceneLog; write() the edited store and reset() the log to compact.
+     * Every write stamps a fresh generation id that the log records, so a
+     * log left behind by a compaction interrupted between the two steps is
+     * recognised as stale instead of being replayed a second time.
+     */
+    class SceneFile
+    {
+    public:
+        // Serialization under a fresh generation id (serialize() into a span
+        // fails if it is too small)
+        static size_t getSerializedSize(const ShapeStore &store);
+        static std::vector<uint8_t> serialize(const ShapeStore &store);
+        static bool serialize(const ShapeStore &store, std::span<uint8_t> out);
+
+        // Writes to a temporary file, renames it over path and syncs the
+        // directory, so readers never see a partial scene and the new one
+        // survives a crash (false on any I/O error). generation receives the
+        // id stamped into the file.
+        static bool write(const ShapeStore &store, const std::string &path, uint64_t *generation = nullptr);
+
+        // Appends the scene's shapes to store (false if the file is unreadable or invalid)
+        static bool load(const std::string &path, ShapeStore &store, uint64_t *generation = nullptr);
+
+        // Format constants
+        static constexpr uint32_t MAGIC = 0x454E4353; // "SCNE" in little-endian byte order
+        static constexpr uint16_t FORMAT_VERSION = 2;
+        static constexpr size_t HEADER_BYTES = 32;
+
+    private:
+        // Prevent instantiation
+        SceneFile() = delete;
+        ~SceneFile() = delete;
+        SceneFile(const SceneFile &) = delete;
+        SceneFile &operator=(const SceneFile &) = delete;
+    };
+
+    /**
+     * Zero-copy, read-only view over a serialized scene.
+     *
+     * parse() checks the header and the exact length only; the columns are
+     * then used as stored, so the buffer must stay alive, unmodified and
+     * 8-byte aligned (as std::vector, operator new and mmap storage is).
+     * Indices are in store order: all rectangles, then all circles.
+     */
+    class SceneView
+    {
+    public:
+        // False on a short, misaligned, corrupt or other-version buffer
+        bool parse(std::span<const uint8_t> bytes);
+
+        // Bulk calculations (the same arithmetic as ShapeStore)
+        double totalArea() const;
+        double totalPerimeter() const;
+        BoundingBox getBounds() const;
+
+        // Linear-scan queries; store-order indices of the shapes overlapping
+        // the region or containing the point are appended to out
+        void query(const BoundingBox &region, std::vector<size_t> &out) const;
+        void queryPoint(double x, double y, std::vector<size_t> &out) const;
+
+        // Per-object access and bulk copy (appended to store)
+        Rectangle rectangleAt(size_t index) const;
+        Circle circleAt(size_t index) const;
+        void copyTo(ShapeStore &store) const;
+
+        // Column views
+        std::span<const double> getRectangleXColumn() const { return rectX_; }
+        std::span<const double> getRectangleYColumn() const { return rectY_; }
+        std::span<const double> getRectangleWidthColumn() const { return rectWidth_; }
+        std::span<const double> getRectangleHeightColumn() const { return rectHeight_; }
+        std::span<const double> getCircleXColumn() const { return circleX_; }
+        std::span<const double> getCircleYColumn() const { return circleY_; }
+        std::span<const double> getCircleRadiusColumn() const { return circleRadius_; }
+
+        // Accessors (valid after a successful parse)
+        uint16_t getVersion() const { return version_; }
+        uint64_t getGeneration() const { return generation_; }
+        size_t getRectangleCount() const { return rectX_.size(); }
+        size_t getCircleCount() const { return circleX_.size(); }
+        size_t getShapeCount() const { return rectX_.size() + circleX_.size(); }
+        bool isEmpty() const { return getShapeCount() == 0; }
+
+    private:
+        uint16_t version_ = 0;
+        uint64_t generation_ = 0;
+        std::span<const double> rectX_;
+        std::span<const double> rectY_;
+        std::span<const double> rectWidth_;
+        std::span<const double> rectHeight_;
+        std::span<const double> circleX_;
+        std::span<const double> circleY_;
+        std::span<const double> circleRadius_;
+    };
+
+    /**
+     * Scene file mapped read-only into memory, with a view over it.
+     *
+     * Opening costs one mmap regardless of scene size; pages are faulted
+     * in as queries touch them.
+     */
+    class MappedScene
+    {
+    public:
+        MappedScene() = default;
+        ~MappedScene();
+
+        MappedScene(const MappedScene &) = delete;
+        MappedScene &operator=(const MappedScene &) = delete;
+
+        // False if the file cannot be opened or mapped, or is not a valid scene
+        bool open(const std::string &path);
+        void close();
+
+        // Accessors
+        bool isOpen() const { return mapping_ != nullptr; }
+        const SceneView &getView() const { return view_; }
+
+    private:
+        void *mapping_ = nullptr;
+        size_t mappedBytes_ = 0;
+        SceneView view_;
+    };
+
+    /**
+     * Append-only log of edits to a scene file.
+     *
+     * Format version 2, little-endian:
+     *
+     *   u32 magic, u16 version, u16 flags (0)
+     *   u64 base generation, u64 base rectangle count, u64 base circle count
+     *   records of 48 bytes: u32 operation, u32 checksum, u64 index,
+     *   f64 values[4]
+     *
+     * The header names the generation and shape counts of the scene the log
+     * applies to. A log from another generation is stale (its edits are
+     * already in a newer scene, or belong to a replaced one): replay()
+     * skips it and open() starts it afresh. Edits are buffered and
+     * written with one write() per flush() (close() flushes too). A crash
+     * can leave a torn last record; the checksum exposes it, replay()
+     * ignores it and open() cuts it off before appending.
+     */
+    class SceneLog
+    {
+    public:
+        enum class Operation : uint32_t
+        {
+            AddRectangle = 1, // x, y, width, height
+            AddCircle,        // x, y, radius
+            SetRectangle,     // index, x, y, width, height
+            SetCircle,        // index, x, y, radius
+            MoveRectangle,    // index, dx, dy
+            MoveCircle        // index, dx, dy
+        };
+
+        SceneLog() = default;
+        ~SceneLog();
+
+        SceneLog(const SceneLog &) = delete;
+        SceneLog &operator=(const SceneLog &) = delete;
+
+        // Opens for appending, creating the log if missing and emptying a stale
+        // one; false if the file cannot be opened or is corrupt
+        bool open(const std::string &path, uint64_t baseGeneration, size_t baseRectangles, size_t baseCircles);
+        void close();
+
+        // Edits (indices within the shape's type, buffered until flush())
+        void addRectangle(double x, double y, double width, double height);
+        void addCircle(double x, double y, double radius);
+        void setRectangle(size_t index, double x, double y, double width, double height);
+        void setCircle(size_t index, double x, double y, double radius);
+        void moveRectangle(size_t index, double dx, double dy);
+        void moveCircle(size_t index, double dx, double dy);
+
+        // Durability (false on an I/O error; sync() also flushes)
+        bool flush();
+        bool sync();
+
+        // Empties the log for a freshly written base (after compaction)
+        bool reset(uint64_t baseGeneration, size_t baseRectangles, size_t baseCircles);
+
+        // Applies the log's edits to store, loaded from the baseGeneration
+        // scene, in order. A stale log applies nothing. Stops at the first torn
+        // or corrupt record; false if the log is unreadable, its base counts do
+        // not match store, or an edit names a missing shape. applied counts the
+        // records that took effect.
+        static bool replay(const std::string &path, uint64_t baseGeneration, ShapeStore &store,
+                           size_t *applied = nullptr);
+
+        // Accessors
+        bool isOpen() const { return fileDescriptor_ >= 0; }
+        size_t getPendingCount() const { return pending_.size() / RECORD_BYTES; }
+
+        // Format constants
+        static constexpr uint32_t MAGIC = 0x4C4E4353; // "SCNL" in little-endian byte order
+        static constexpr uint16_t FORMAT_VERSION = 2;
+        static constexpr size_t HEADER_BYTES = 32;
+        static constexpr size_t RECORD_BYTES = 48;
+
+    private:
+        int fileDescriptor_ = -1;
+        std::vector<uint8_t> pending_;
+
+        // Helper methods
+        void append(Operation operation, uint64_t index, double a, double b, double c = 0.0, double d = 0.0);
+        bool writeHeader(uint64_t baseGeneration, size_t baseRectangles, size_t baseCircles);
+    };
+
+} // namespace geometry
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "geometry/Shape.h"
+#include "utils/MathUtils.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace geometry
+{
+
+    class DrawSink;
+    class ShapeManager;
+
+    /**
+     * Four-stage scene pipeline: load, update, aggregate, draw.
+     *
+     * Shapes flow through in batches. A loader fills batches on one ingest
+     * thread, a pool of update workers applies the per-tick update to every
+     * shape, a pool of aggregate workers records shape areas into private
+     * StatisticsCalculators, and the calling thread draws each batch into
+     * the sink, flushes it and hands the shapes to a ShapeManager. Stages are
+     * linked by bounded lock-free queues, so sink I/O for one batch overlaps
+     * geometry work on the next ones and a slow stage applies back-pressure
+     * instead of buffering without limit; idle workers park rather than
+     * spin, leaving their cores to the stages that have work. Batches are
+     * drawn in load order whatever the worker counts, so the output matches
+     * a sequential run; the loader takes a credit per batch that drawing
+     * returns, which also bounds the batches held back for reordering when
+     * one of them stalls.
+     */
+    class ScenePipeline
+    {
+    public:
+        using Batch = std::vector<std::unique_ptr<Shape>>;
+
+        // Fills an empty batch; returns false (batch ignored) once the source is exhausted
+        using Loader = std::function<bool(Batch &batch)>;
+
+        // Per-tick update, called concurrently for different shapes
+        using Updater = std::function<void(Shape &shape)>;
+
+        struct Config
+        {
+            size_t queueCapacity = 16; // batches in flight between two stages
+            size_t maxInFlight = 0;    // batches loaded but not yet drawn; 0 = 4 * queueCapacity
+            size_t updateWorkers = 0;  // 0 = hardware threads left after the other stages (at least 1)
+            size_t aggregateWorkers = 1;
+        };
+
+        ScenePipeline();
+        explicit ScenePipeline(const Config &config);
+
+        // Runs every stage until the loader is exhausted and all batches are
+        // drawn; replaces the results of any previous run
+        void run(const Loader &loader, const Updater &update, DrawSink &sink, ShapeManager &scene);
+
+        // Results of the last run
+        const utils::StatisticsCalculator &getAreaStatistics() const { return areaStatistics_; }
+        size_t getBatchCount() const { return batchCount_; }
+        size_t getShapeCount() const { return areaStatistics_.getCount(); }
+
+        // Accessors
+        const Config &getConfig() const { return config_; }
+
+    private:
+        Config config_;
+        utils::StatisticsCalculator areaStatistics_;
+        size_t batchCount_;
+    };
+
+} // namespace geometry
@@ -1,8 +1,28 @@
 #pragma once
 
+#include "geometry/BoundingBox.h"
+#include <vector>
+
 namespace geometry
 {
 
+    class Circle;
+    class DrawSink;
+    class Rectangle;
+    class Shape;
+
+    /**
+     * Receives notifications when an observed shape's geometry changes.
+     */
+    class ShapeObserver
+    {
+    public:
+        virtual ~ShapeObserver() = default;
+
+        virtual void shapeChanged(const Shape &shape) = 0;
+        virtual void shapeDestroyed(const Shape &shape) = 0;
+    };
+
     /**
      * Abstract base class for geometric shapes.
      */
@@ -10,24 +30,52 @@ namespace geometry
     {
     public:
         Shape(double x = 0.0, double y = 0.0);
-        virtual ~Shape() = default;
+        virtual ~Shape();
+
+        // Copies take the geometry only; assignment keeps the target's observers
+        // and notifies them once the geometry has been copied
+        Shape(const Shape &other);
+        Shape &operator=(const Shape &other);
 
         // Pure virtual methods
         virtual double area() const = 0;
         virtual double perimeter() const = 0;
         virtual void draw() const = 0;
 
+        // Batched drawing (the default falls back to the unbuffered draw())
+        virtual void draw(DrawSink &sink) const;
+
+        // Spatial queries (defaults treat the shape as its bounding box)
+        virtual BoundingBox bounds() const;
+        virtual bool contains(double x, double y) const;
+        virtual double distanceTo(double x, double y) const;
+
+        // Overlap tests (touching counts; the general form dispatches on both
+        // shapes, and the defaults compare bounding boxes)
+        virtual bool intersects(const Shape &other) const;
+        virtual bool intersects(const Rectangle &rectangle) const;
+        virtual bool intersects(const Circle &circle) const;
+        virtual bool intersects(const BoundingBox &box) const;
+
         // Concrete methods
         void move(double dx, double dy);
         double getX() const { return x_; }
         double getY() const { return y_; }
 
+        // Change notification (observers are notified in registration order;
+        // adding one twice has no effect)
+        void addObserver(ShapeObserver *observer);
+        void removeObserver(ShapeObserver *observer);
+        bool hasObserver(const ShapeObserver *observer) const;
+
     protected:
         void setPosition(double x, double y);
+        void notifyChanged();
 
     private:
         double x_;
         double y_;
+        std::vector<ShapeObserver *> observers_;
     };
 
     /**
@@ -37,25 +85,36 @@ namespace geometry
     {
     public:
         Rectangle(double x, double y, double width, double height);
+        Rectangle(const Rectangle &other) = default;
+        Rectangle &operator=(const Rectangle &other);
 
-        // Override virtual methods
-        double area() const override;
-        double perimeter() const override;
+        // Override virtual methods (inline so statically dispatched calls can fold)
+        double area() const override { return width_ * height_; }
+        double perimeter() const override { return 2.0 * (width_ + height_); }
         void draw() const override;
+        void draw(DrawSink &sink) const override;
+
+        // Spatial queries ((x, y) is the minimum corner)
+        BoundingBox bounds() const override;
+        bool intersects(const Shape &other) const override;
+        bool intersects(const Rectangle &rectangle) const override;
+        bool intersects(const Circle &circle) const override;
+        bool intersects(const BoundingBox &box) const override;
 
         // Rectangle-specific methods
         double getWidth() const { return width_; }
         double getHeight() const { return height_; }
         void resize(double newWidth, double newHeight);
 
+        // Constants
+        static constexpr double MIN_SIZE = 0.001;
+
     protected:
         bool isSquare() const;
 
     private:
         double width_;
         double height_;
-
-        static constexpr double MIN_SIZE = 0.001;
     };
 
     /**
@@ -65,20 +124,33 @@ namespace geometry
     {
     public:
         explicit Circle(double x, double y, double radius);
+        Circle(const Circle &other) = default;
+        Circle &operator=(const Circle &other);
 
-        // Override virtual methods
-        double area() const override;
-        double perimeter() const override;
+        // Override virtual methods (inline so statically dispatched calls can fold)
+        double area() const override { return PI * radius_ * radius_; }
+        double perimeter() const override { return 2.0 * PI * radius_; }
         void draw() const override;
+        void draw(DrawSink &sink) const override;
+
+        // Spatial queries ((x, y) is the center)
+        BoundingBox bounds() const override;
+        bool contains(double x, double y) const override;
+        double distanceTo(double x, double y) const override;
+        bool intersects(const Shape &other) const override;
+        bool intersects(const Rectangle &rectangle) const override;
+        bool intersects(const Circle &circle) const override;
+        bool intersects(const BoundingBox &box) const override;
 
         // Circle-specific methods
         double getRadius() const { return radius_; }
         void setRadius(double newRadius);
 
+        // Constants
+        static constexpr double PI = 3.14159265359;
+
     private:
         double radius_;
-
-        static constexpr double PI = 3.14159265359;
     };
 
 } // namespace geometry
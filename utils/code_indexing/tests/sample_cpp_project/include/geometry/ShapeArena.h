@@ -0,0 +1,67 @@
+#pragma once
+
+#include "geometry/Shape.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Monotonic arena for building and tearing down scenes of shapes.
+     *
+     * Shapes are placement-constructed in a bump-allocated buffer and are
+     * used through ordinary Shape pointers. reset() destroys every shape and
+     * rewinds the arena in one step; the initial buffer is reused, so a
+     * scene that fits in it allocates nothing from the heap per frame.
+     */
+    class ShapeArena
+    {
+    public:
+        explicit ShapeArena(size_t initialBytes = DEFAULT_INITIAL_BYTES,
+                            std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+        ~ShapeArena();
+
+        ShapeArena(const ShapeArena &) = delete;
+        ShapeArena &operator=(const ShapeArena &) = delete;
+
+        // Shape construction (pointers stay valid until reset())
+        template <typename T, typename... Args>
+        T *create(Args &&...args)
+        {
+            static_assert(std::is_base_of_v<Shape, T>, "ShapeArena only holds Shape types");
+
+            // Grow the list first so the push_back below cannot throw and strand
+            // a constructed shape that reset() would never destroy
+            if (shapes_.size() == shapes_.capacity())
+                shapes_.reserve(std::max<size_t>(2 * shapes_.capacity(), 16));
+            void *memory = resource_.allocate(sizeof(T), alignof(T));
+            T *shape = ::new (memory) T(std::forward<Args>(args)...);
+            shapes_.push_back(shape);
+            return shape;
+        }
+
+        // Destroys all shapes and releases their memory at once
+        void reset();
+
+        // Accessors
+        std::span<Shape *const> getShapes() const { return shapes_; }
+        size_t getShapeCount() const { return shapes_.size(); }
+        std::pmr::memory_resource *getResource() { return &resource_; }
+
+        // Constants
+        static constexpr size_t DEFAULT_INITIAL_BYTES = 64 * 1024;
+
+    private:
+        std::unique_ptr<std::byte[]> buffer_;
+        std::pmr::monotonic_buffer_resource resource_;
+        std::vector<Shape *> shapes_;
+    };
+
+} // namespace geometry
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "geometry/Shape.h"
+#include "geometry/SpatialIndex.h"
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Spatial index over live Shape objects.
+     *
+     * Registered shapes report moves and resizes through ShapeObserver, so
+     * the underlying SpatialIndex is updated incrementally; destroyed shapes
+     * drop out automatically. Every query is refined with the shapes' exact
+     * intersects(), contains() and distanceTo(), so bounding-box candidates
+     * that miss the shape itself are not reported.
+     */
+    class ShapeIndex : public ShapeObserver
+    {
+    public:
+        explicit ShapeIndex(std::unique_ptr<SpatialIndex> index);
+        ~ShapeIndex() override;
+
+        ShapeIndex(const ShapeIndex &) = delete;
+        ShapeIndex &operator=(const ShapeIndex &) = delete;
+
+        // Shape management (the index observes each shape alongside any other observers)
+        void add(Shape &shape);
+        void remove(Shape &shape);
+        void clear();
+
+        // Queries
+        std::vector<Shape *> query(const BoundingBox &region) const;
+        std::vector<Shape *> queryPoint(double x, double y) const;
+        std::vector<Shape *> nearest(double x, double y, size_t k = 1) const;
+
+        // ShapeObserver
+        void shapeChanged(const Shape &shape) override;
+        void shapeDestroyed(const Shape &shape) override;
+
+        // Accessors
+        bool contains(const Shape &shape) const { return ids_.count(&shape) != 0; }
+        size_t getShapeCount() const { return ids_.size(); }
+        const SpatialIndex &getIndex() const { return *index_; }
+
+    private:
+        std::unique_ptr<SpatialIndex> index_;
+        std::unordered_map<const Shape *, size_t> ids_;
+        std::vector<Shape *> shapes_; // indexed by SpatialIndex id
+
+        // Helper methods
+        std::vector<Shape *> resolve(const std::vector<size_t> &ids) const;
+    };
+
+} // namespace geometry
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "geometry/Shape.h"
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry
+{
+
+    class DrawSink;
+
+    /**
+     * Owning collection of polymorphic shapes.
+     *
+     * Total area, total perimeter and bounds are cached and kept current
+     * through ShapeObserver as shapes are added, removed, moved or resized,
+     * so the aggregate queries are O(1). The bounds are rebuilt lazily, only
+     * after a shape on their edge shrinks, moves inward or is removed. Owned
+     * shapes may have other observers (e.g. a ShapeIndex); they are told
+     * when the manager destroys a shape. Shapes are drawn in insertion
+     * order, which removal preserves at O(n) cost.
+     */
+    class ShapeManager : public ShapeObserver
+    {
+    public:
+        ShapeManager() = default;
+        ~ShapeManager() override;
+
+        ShapeManager(const ShapeManager &) = delete;
+        ShapeManager &operator=(const ShapeManager &) = delete;
+
+        // Shape management (removal hands ownership back, or nullptr if not owned)
+        void addShape(std::unique_ptr<Shape> shape);
+        std::unique_ptr<Shape> removeShape(const Shape &shape);
+        void clear();
+
+        // Draws every shape into one batch with a single flush per call
+        void drawAll() const;
+        void drawAll(DrawSink &sink) const;
+
+        // Cached aggregates
+        double calculateTotalArea() const { return totalArea_.value(); }
+        double calculateTotalPerimeter() const { return totalPerimeter_.value(); }
+        BoundingBox getBounds() const;
+
+        // ShapeObserver
+        void shapeChanged(const Shape &shape) override;
+        void shapeDestroyed(const Shape &shape) override;
+
+        // Accessors
+        bool contains(const Shape &shape) const { return positions_.count(&shape) != 0; }
+        size_t getShapeCount() const { return shapes_.size(); }
+
+    private:
+        // Contributions last added to the aggregates
+        struct Entry
+        {
+            std::unique_ptr<Shape> shape;
+            double area;
+            double perimeter;
+            BoundingBox bounds;
+        };
+
+        // Neumaier-compensated sum, so add/subtract churn does not drift
+        class RunningSum
+        {
+        public:
+            void add(double value);
+            double value() const { return sum_ + compensation_; }
+            void reset() { sum_ = compensation_ = 0.0; }
+
+        private:
+            double sum_ = 0.0;
+            double compensation_ = 0.0;
+        };
+
+        std::vector<Entry> shapes_;
+        std::unordered_map<const Shape *, size_t> positions_;
+        RunningSum totalArea_;
+        RunningSum totalPerimeter_;
+        mutable BoundingBox bounds_;
+        mutable bool boundsDirty_ = false;
+
+        // Helper methods
+        void retractBounds(const BoundingBox &old);
+        void updateBounds(const BoundingBox &old, const BoundingBox &current);
+        void extendBounds(const BoundingBox &added);
+        std::unique_ptr<Shape> detach(size_t position);
+    };
+
+} // namespace geometry
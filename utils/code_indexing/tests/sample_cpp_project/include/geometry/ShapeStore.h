@@ -0,0 +1,93 @@
+#pragma once
+
+#include "geometry/Shape.h"
+#include "utils/MathUtils.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Structure-of-arrays storage for rectangles and circles.
+     *
+     * Each shape type keeps its fields in contiguous per-type columns, so
+     * bulk queries walk memory linearly with no virtual dispatch. Individual
+     * shapes can still be materialized through the Shape API.
+     *
+     * Batch kernels address shapes in store order: all rectangles by index,
+     * then all circles. They process the common length of the store and
+     * their span, and split across threads once that exceeds PARALLEL_CHUNK.
+     */
+    class ShapeStore
+    {
+    public:
+        ShapeStore() = default;
+        ~ShapeStore() = default;
+
+        // Shape management (returns the index within the shape's type)
+        size_t addRectangle(double x, double y, double width, double height);
+        size_t addCircle(double x, double y, double radius);
+        size_t add(const Rectangle &rectangle);
+        size_t add(const Circle &circle);
+        void reserve(size_t rectangles, size_t circles);
+        void clear();
+
+        // Bulk append from columns (common length of the spans; sizes clamped as above)
+        void addRectangles(std::span<const double> x, std::span<const double> y, std::span<const double> width,
+                           std::span<const double> height);
+        void addCircles(std::span<const double> x, std::span<const double> y, std::span<const double> radius);
+
+        // Per-object edits (index within the shape's type; sizes clamped as on add)
+        void setRectangle(size_t index, double x, double y, double width, double height);
+        void setCircle(size_t index, double x, double y, double radius);
+        void moveRectangle(size_t index, double dx, double dy);
+        void moveCircle(size_t index, double dx, double dy);
+
+        // Bulk calculations
+        double totalArea() const;
+        double totalPerimeter() const;
+
+        // Batch kernels (store order)
+        void moveAll(double dx, double dy);
+        void moveAll(std::span<const utils::Vec2d> deltas);
+        void areas(std::span<double> out) const;
+        void perimeters(std::span<double> out) const;
+
+        // Per-object access
+        Rectangle rectangleAt(size_t index) const;
+        Circle circleAt(size_t index) const;
+
+        // Column views (invalidated by add, reserve and clear)
+        std::span<const double> getRectangleXColumn() const { return rectX_; }
+        std::span<const double> getRectangleYColumn() const { return rectY_; }
+        std::span<const double> getRectangleWidthColumn() const { return rectWidth_; }
+        std::span<const double> getRectangleHeightColumn() const { return rectHeight_; }
+        std::span<const double> getCircleXColumn() const { return circleX_; }
+        std::span<const double> getCircleYColumn() const { return circleY_; }
+        std::span<const double> getCircleRadiusColumn() const { return circleRadius_; }
+
+        // Accessors
+        size_t getRectangleCount() const { return rectX_.size(); }
+        size_t getCircleCount() const { return circleX_.size(); }
+        size_t getShapeCount() const { return rectX_.size() + circleX_.size(); }
+        bool isEmpty() const { return rectX_.empty() && circleX_.empty(); }
+
+        // Constants
+        static constexpr size_t PARALLEL_CHUNK = 1 << 16;
+
+    private:
+        // Rectangle columns
+        std::vector<double> rectX_;
+        std::vector<double> rectY_;
+        std::vector<double> rectWidth_;
+        std::vector<double> rectHeight_;
+
+        // Circle columns
+        std::vector<double> circleX_;
+        std::vector<double> circleY_;
+        std::vector<double> circleRadius_;
+    };
+
+} // namespace geometry
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "geometry/BoundingBox.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Interface for indexes over axis-aligned boxes keyed by integer ids.
+     *
+     * Ids are assigned by insert() and reused after remove(); update() and
+     * remove() ignore an id that has been removed. Query results are
+     * appended to the output vector in unspecified order.
+     */
+    class SpatialIndex
+    {
+    public:
+        // Exact distance for an id; must never be less than the distance to its box
+        using DistanceFunction = std::function<double(size_t id)>;
+
+        virtual ~SpatialIndex() = default;
+
+        // Entry management
+        virtual size_t insert(const BoundingBox &box) = 0;
+        virtual void update(size_t id, const BoundingBox &box) = 0;
+        virtual void remove(size_t id) = 0;
+        virtual void clear() = 0;
+
+        // Queries
+        virtual void query(const BoundingBox &region, std::vector<size_t> &out) const = 0;
+        void queryPoint(double x, double y, std::vector<size_t> &out) const
+        {
+            query(BoundingBox(x, y, x, y), out);
+        }
+
+        // The k entries nearest to (x, y), closest first; box distance by default
+        virtual void nearest(double x, double y, size_t k, std::vector<size_t> &out,
+                             const DistanceFunction &distance = {}) const = 0;
+
+        // Accessors
+        virtual BoundingBox getBounds(size_t id) const = 0;
+        virtual size_t getCount() const = 0;
+        bool isEmpty() const { return getCount() == 0; }
+    };
+
+} // namespace geometry
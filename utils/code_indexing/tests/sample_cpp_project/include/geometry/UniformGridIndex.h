@@ -0,0 +1,84 @@
+#pragma once
+
+#include "geometry/SpatialIndex.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry
+{
+
+    /**
+     * Sparse uniform grid for dense scenes of similarly sized shapes.
+     *
+     * Each entry is listed in every cell its box overlaps, so the cell size
+     * should be on the order of a typical shape. Updates that stay within
+     * the same cells only rewrite the stored box. Entries spanning more than
+     * maxCellsPerEntry cells are kept in a separate oversize list instead,
+     * which keeps their insertion and moves O(1) but is scanned by every
+     * query.
+     */
+    class UniformGridIndex : public SpatialIndex
+    {
+    public:
+        explicit UniformGridIndex(double cellSize = 1.0, size_t maxCellsPerEntry = 64);
+
+        // Entry management
+        size_t insert(const BoundingBox &box) override;
+        void update(size_t id, const BoundingBox &box) override;
+        void remove(size_t id) override;
+        void clear() override;
+
+        // Queries
+        void query(const BoundingBox &region, std::vector<size_t> &out) const override;
+        void nearest(double x, double y, size_t k, std::vector<size_t> &out,
+                     const DistanceFunction &distance = {}) const override;
+
+        // Accessors
+        BoundingBox getBounds(size_t id) const override { return entries_[id].box; }
+        size_t getCount() const override { return count_; }
+        double getCellSize() const { return cellSize_; }
+        size_t getOccupiedCellCount() const { return cells_.size(); }
+        size_t getOversizeCount() const { return oversize_.size(); }
+
+    private:
+        struct CellRange
+        {
+            int32_t minX;
+            int32_t minY;
+            int32_t maxX;
+            int32_t maxY;
+
+            bool operator==(const CellRange &other) const = default;
+        };
+
+        struct Entry
+        {
+            BoundingBox box;
+            CellRange cells;
+            size_t oversizeSlot; // position in oversize_, if the entry is oversize
+            bool active;
+        };
+
+        double cellSize_;
+        double inverseCellSize_;
+        size_t maxCellsPerEntry_;
+        std::vector<Entry> entries_;
+        std::vector<size_t> freeIds_;
+        std::unordered_map<uint64_t, std::vector<size_t>> cells_;
+        std::vector<size_t> oversize_;
+        size_t count_;
+
+        // Cells ever occupied since the last clear (bounds the nearest() search)
+        CellRange occupied_;
+
+        // Helper methods
+        int32_t cellCoordinate(double value) const;
+        CellRange cellRange(const BoundingBox &box) const;
+        bool isOversize(const CellRange &range) const;
+        static uint64_t cellKey(int32_t x, int32_t y);
+        void link(size_t id, const CellRange &range);
+        void unlink(size_t id, const CellRange &range);
+    };
+
+} // namespace geometry
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace utils
+{
+
+    /**
+     * Fixed-capacity, lock-free multi-producer multi-consumer queue.
+     *
+     * Each cell carries a sequence number that tells producers and
+     * consumers whose turn it is, so a push or pop is one CAS on the shared
+     * position plus a store to the cell; threads never wait on a lock
+     * (Vyukov's bounded MPMC queue). The blocking push() and pop() spin for
+     * a short while and then park with std::atomic::wait until the other
+     * side makes progress, so idle stages do not hold on to a core. The
+     * capacity is rounded up to a power of two. close() marks the end of
+     * the stream: pushes then fail and pops drain what is left before
+     * failing.
+     */
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+        explicit BoundedQueue(size_t capacity)
+            : cells_(std::make_unique<Cell[]>(std::bit_ceil(std::max<size_t>(capacity, 2)))),
+              mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), enqueuePos_(0), dequeuePos_(0), closed_(false)
+        {
+            for (size_t i = 0; i <= mask_; ++i)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue &) = delete;
+        BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+        // Non-blocking (false if full or empty; value is left untouched on failure)
+        bool tryPush(T &&value)
+        {
+            size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = cells_[pos & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto lag = static_cast<std::ptrdiff_t>(sequence - pos);
+                if (lag == 0)
+                {
+                    if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (lag < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = enqueuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool tryPop(T &out)
+        {
+            size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &cell = cells_[pos & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto lag = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+                if (lag == 0)
+                {
+                    if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        out = std::move(cell.value);
+                        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (lag < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = dequeuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Blocking (spin, then park; push fails once closed, pop once closed and drained)
+        bool push(T &&value)
+        {
+            bool pushed = false;
+            waitFor(spaceFreed_, [&]()
+                    { return closed_.load(std::memory_order_acquire) || (pushed = tryPush(std::move(value))); });
+            if (pushed)
+            {
+                itemAdded_.notify();
+            }
+            return pushed;
+        }
+
+        bool pop(T &out)
+        {
+            bool popped = false;
+            waitFor(itemAdded_, [&]()
+                    {
+                        if ((popped = tryPop(out)))
+                            return true;
+                        if (!closed_.load(std::memory_order_acquire))
+                            return false;
+                        // Pushes that completed before close() are visible now
+                        popped = tryPop(out);
+                        return true; });
+            if (popped)
+            {
+                spaceFreed_.notify();
+            }
+            return popped;
+        }
+
+        // Call once every producer has finished pushing; wakes every parked thread
+        void close()
+        {
+            closed_.store(true, std::memory_order_release);
+            itemAdded_.notify();
+            spaceFreed_.notify();
+        }
+        bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+        // Accessors
+        size_t getCapacity() const { return mask_ + 1; }
+
+        // Constants
+        static constexpr unsigned SPIN_ATTEMPTS = 64;
+
+    private:
+        struct alignas(64) Cell
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        // Bumped whenever one side makes progress; the other side parks on it
+        struct alignas(64) Signal
+        {
+            std::atomic<uint32_t> epoch{0};
+            std::atomic<uint32_t> waiters{0};
+
+            void notify()
+            {
+                epoch.fetch_add(1, std::memory_order_seq_cst);
+                if (waiters.load(std::memory_order_seq_cst) != 0)
+                {
+                    epoch.notify_all();
+                }
+            }
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        size_t mask_;
+        alignas(64) std::atomic<size_t> enqueuePos_;
+        alignas(64) std::atomic<size_t> dequeuePos_;
+        alignas(64) std::atomic<bool> closed_;
+        Signal itemAdded_;
+        Signal spaceFreed_;
+
+        // Helper methods
+        // Retries attempt() until it returns true: spins first, then parks on
+        // the signal. The epoch is read before each retry, so progress made
+        // after a failed retry always changes it and wakes the waiter.
+        template <typename Attempt>
+        static void waitFor(Signal &signal, Attempt &&attempt)
+        {
+            for (unsigned spin = 0; spin < SPIN_ATTEMPTS; ++spin)
+            {
+                if (attempt())
+                {
+                    return;
+                }
+            }
+
+            signal.waiters.fetch_add(1, std::memory_order_seq_cst);
+            for (;;)
+            {
+                uint32_t epoch = signal.epoch.load(std::memory_order_seq_cst);
+                if (attempt())
+                {
+                    break;
+                }
+                signal.epoch.wait(epoch, std::memory_order_seq_cst);
+            }
+            signal.waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+} // namespace utils
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "utils/ExactStatistics.h"
+#include "utils/SampleSource.h"
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * Exact statistics over read-only samples, in sequential passes.
+     *
+     * Nothing is copied or reordered: moments take one pass, histograms two,
+     * and order statistics come from a most-significant-digit radix select
+     * over the samples' ordered bit patterns (four passes of 16-bit digits,
+     * shared by all requested ranks). Order statistics match
+     * StatisticsCalculator exactly, moments up to rounding. Functions return
+     * false if the source fails to read.
+     */
+    class ChunkedStatistics
+    {
+    public:
+        // Single-pass moments
+        static bool computeMoments(const SampleSource &source, SampleMoments &moments);
+
+        // Order statistics (ranks are 0-based positions in sorted order)
+        static bool selectRanks(const SampleSource &source, std::span<const size_t> ranks, std::span<double> out);
+        static bool selectPercentiles(const SampleSource &source, std::span<const double> percentiles,
+                                      std::span<double> out);
+
+        // Full summary with optional percentiles
+        static bool summarize(const SampleSource &source, Statistics &stats);
+        static bool summarize(const SampleSource &source, std::span<const double> percentiles,
+                              std::span<double> out, Statistics &stats);
+
+        // Equal-width bins over [minimum, maximum], as StatisticsCalculator::getHistogram
+        static bool histogram(const SampleSource &source, size_t bins, std::vector<double> &out);
+
+        // Maps doubles to unsigned keys whose integer order is the numeric order
+        static uint64_t orderedKey(double value)
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return (bits & SIGN_BIT) ? ~bits : (bits | SIGN_BIT);
+        }
+
+        static double fromOrderedKey(uint64_t key)
+        {
+            uint64_t bits = (key & SIGN_BIT) ? (key & ~SIGN_BIT) : ~key;
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        // Constants
+        static constexpr unsigned DIGIT_BITS = 16;
+        static constexpr uint64_t SIGN_BIT = uint64_t{1} << 63;
+
+    private:
+        // Prevent instantiation
+        ChunkedStatistics() = delete;
+        ~ChunkedStatistics() = delete;
+        ChunkedStatistics(const ChunkedStatistics &) = delete;
+        ChunkedStatistics &operator=(const ChunkedStatistics &) = delete;
+    };
+
+} // namespace utils
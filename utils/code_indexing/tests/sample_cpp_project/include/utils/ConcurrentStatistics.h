@@ -0,0 +1,101 @@
+#pragma once
+
+#include "utils/MathUtils.h"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * Statistics calculator with lock-free, per-thread sharded ingest.
+     *
+     * Each ingest thread obtains its own Writer, which appends to a private
+     * cache-line aligned shard without any synchronization. Reductions
+     * (moments, histogram, sort for order statistics) fan out across cores
+     * and must run from one thread while writers are idle, e.g. after
+     * joining the ingest threads; ingest may resume afterwards.
+     */
+    class ConcurrentStatisticsCalculator
+    {
+    private:
+        struct alignas(64) Shard
+        {
+            std::vector<double> data;
+        };
+
+    public:
+        /**
+         * Single-threaded handle onto one shard.
+         *
+         * Move-only, so a shard never has two writers; a moved-from writer
+         * must not be used again.
+         */
+        class Writer
+        {
+        public:
+            Writer(const Writer &) = delete;
+            Writer &operator=(const Writer &) = delete;
+            Writer(Writer &&other) noexcept : shard_(std::exchange(other.shard_, nullptr)) {}
+            Writer &operator=(Writer &&other) noexcept
+            {
+                shard_ = std::exchange(other.shard_, nullptr);
+                return *this;
+            }
+
+            void addValue(double value) { shard_->data.push_back(value); }
+            void addValues(const std::vector<double> &values);
+            void reserve(size_t capacity) { shard_->data.reserve(capacity); }
+            size_t getCount() const { return shard_->data.size(); }
+
+        private:
+            friend class ConcurrentStatisticsCalculator;
+            explicit Writer(Shard *shard) : shard_(shard) {}
+
+            Shard *shard_;
+        };
+
+        ConcurrentStatisticsCalculator();
+        ~ConcurrentStatisticsCalculator();
+
+        ConcurrentStatisticsCalculator(const ConcurrentStatisticsCalculator &) = delete;
+        ConcurrentStatisticsCalculator &operator=(const ConcurrentStatisticsCalculator &) = delete;
+
+        // Writer registration (thread-safe; writers stay valid for the calculator's lifetime)
+        Writer createWriter();
+
+        // Data management (requires idle writers)
+        void clear();
+
+        // Calculations (require idle writers)
+        Statistics calculate() const;
+        double getPercentile(double percentile) const;
+        std::vector<double> getPercentiles(const std::vector<double> &percentiles) const;
+        std::vector<double> getHistogram(size_t bins) const;
+
+        // Accessors
+        size_t getCount() const;
+        size_t getShardCount() const;
+        bool isEmpty() const { return getCount() == 0; }
+
+        // Constants
+        static constexpr size_t CHUNK_SIZE = 1 << 16;
+
+    private:
+        mutable std::mutex registryMutex_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+
+        // Merged, sorted copy of all shards for order statistics
+        mutable std::vector<double> sorted_;
+        mutable size_t sortedCount_;
+
+        // Helper methods
+        std::vector<std::span<const double>> chunks() const;
+        const std::vector<double> &sortedSamples() const;
+    };
+
+} // namespace utils
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "utils/MathUtils.h"
+#include <cstddef>
+#include <span>
+
+namespace utils
+{
+
+    /**
+     * Many-to-many distances between point sets.
+     *
+     * Matrices are row-major, rows by columns, with out[r * columns + c]
+     * the distance from rows[r] to columns[c]. Columns are processed in
+     * cache-sized tiles with the simd::squaredDistances kernels, and row
+     * ranges are spread over hardwareThreads() once there is enough work.
+     * The squared forms skip the sqrt and suit any query that only needs
+     * ordering; results match the scalar Vector2D arithmetic exactly.
+     */
+    class DistanceMatrix
+    {
+    public:
+        // Full matrices (false and untouched if out holds fewer than rows * columns values)
+        static bool squared(std::span<const Vec2f> rows, std::span<const Vec2f> columns, std::span<float> out);
+        static bool squared(std::span<const Vec2d> rows, std::span<const Vec2d> columns, std::span<double> out);
+        static bool euclidean(std::span<const Vec2f> rows, std::span<const Vec2f> columns, std::span<float> out);
+        static bool euclidean(std::span<const Vec2d> rows, std::span<const Vec2d> columns, std::span<double> out);
+
+        // Brute-force nearest point per query without storing the matrix; ties go to
+        // the lowest index (false if an output is shorter than queries or points is empty)
+        static bool nearest(std::span<const Vec2f> queries, std::span<const Vec2f> points,
+                            std::span<size_t> indices, std::span<float> squaredDistances);
+        static bool nearest(std::span<const Vec2d> queries, std::span<const Vec2d> points,
+                            std::span<size_t> indices, std::span<double> squaredDistances);
+
+        // Constants
+        static constexpr size_t TILE_COLUMNS = 1024;
+        static constexpr size_t MIN_PARALLEL_PAIRS = size_t{1} << 20;
+
+    private:
+        // Prevent instantiation
+        DistanceMatrix() = delete;
+        ~DistanceMatrix() = delete;
+        DistanceMatrix(const DistanceMatrix &) = delete;
+        DistanceMatrix &operator=(const DistanceMatrix &) = delete;
+    };
+
+} // namespace utils
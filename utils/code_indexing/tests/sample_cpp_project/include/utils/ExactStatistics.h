@@ -0,0 +1,82 @@
+#pragma once
+
+#include "utils/MathUtils.h"
+#include <cstddef>
+#include <span>
+
+namespace utils
+{
+
+    /**
+     * Count, mean, squared deviations and range gathered in one pass.
+     */
+    struct SampleMoments
+    {
+        size_t count;
+        double mean;
+        double sumSquaredDiff;
+        double minimum;
+        double maximum;
+
+        SampleMoments() : count(0), mean(0), sumSquaredDiff(0), minimum(0), maximum(0) {}
+
+        void merge(const SampleMoments &other);
+        double variance() const { return (count > 1) ? sumSquaredDiff / (count - 1) : 0.0; }
+    };
+
+    /**
+     * Exact statistics without a full sort.
+     *
+     * Moments are fused into a single blocked pass that the compiler can
+     * vectorize, and order statistics come from nth_element multi-selection
+     * (O(n log m) for m requested ranks). Results match the sort-based
+     * StatisticsCalculator up to floating-point rounding of the moments.
+     */
+    class ExactStatistics
+    {
+    public:
+        // Single-pass moments
+        static SampleMoments computeMoments(std::span<const double> values);
+
+        // Order statistics (values are reordered but keep their contents)
+        static double selectMedian(std::span<double> values);
+        static void selectPercentiles(std::span<double> values, std::span<const double> percentiles,
+                                      std::span<double> out);
+
+        // Order statistics over already sorted values
+        static double medianOfSorted(std::span<const double> sorted);
+        static double percentileOfSorted(std::span<const double> sorted, double percentile);
+
+        // Full summary with optional percentiles in one selection run (reorders values)
+        static Statistics summarize(std::span<double> values);
+        static Statistics summarize(std::span<double> values, std::span<const double> percentiles,
+                                    std::span<double> out);
+
+        // Native-sample forms of the above for BasicStatisticsCalculator: values stay
+        // in T and only the moment accumulators widen to Accum (instantiated for
+        // float, double and int samples with double accumulators)
+        template <typename T, typename Accum = double>
+        static SampleMoments computeMoments(std::span<const T> values);
+        template <typename T>
+        static void selectPercentiles(std::span<T> values, std::span<const double> percentiles,
+                                      std::span<double> out);
+        template <typename T>
+        static double medianOfSorted(std::span<const T> sorted);
+        template <typename T>
+        static double percentileOfSorted(std::span<const T> sorted, double percentile);
+        template <typename T, typename Accum = double>
+        static Statistics summarize(std::span<T> values, std::span<const double> percentiles,
+                                    std::span<double> out);
+
+        // Constants
+        static constexpr size_t BLOCK_SIZE = 2048;
+
+    private:
+        // Prevent instantiation
+        ExactStatistics() = delete;
+        ~ExactStatistics() = delete;
+        ExactStatistics(const ExactStatistics &) = delete;
+        ExactStatistics &operator=(const ExactStatistics &) = delete;
+    };
+
+} // namespace utils
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * Histogram with bin edges fixed at construction.
+     *
+     * Bin lookup is O(1) arithmetic for every scale, so counts can be kept
+     * up to date at insert time. Values below the first edge or above the
+     * last edge are tallied separately as underflow and overflow.
+     */
+    class Histogram
+    {
+    public:
+        enum class Scale
+        {
+            Linear,
+            Logarithmic,
+            LogLinear
+        };
+
+        // Factories
+        static Histogram linear(double minimum, double maximum, size_t bins);
+        static Histogram logarithmic(double minimum, double maximum, size_t bins);
+        static Histogram logLinear(double minimum, double maximum, unsigned subBucketBits = 4);
+
+        // Data management
+        void add(double value);
+        void add(double value, double count);
+        void clear();
+
+        // Adds another histogram's tallies; false (and unchanged) unless the layouts match
+        bool merge(const Histogram &other);
+        bool mergeCounts(std::span<const double> counts, double underflow, double overflow);
+        bool hasSameLayout(const Histogram &other) const;
+
+        // Calculations (binIndex returns getBinCount() for out-of-range values)
+        size_t binIndex(double value) const;
+        double lowerEdge(size_t bin) const;
+        double upperEdge(size_t bin) const;
+
+        // Accessors
+        Scale getScale() const { return scale_; }
+        size_t getBinCount() const { return counts_.size(); }
+        double getMinimum() const { return minimum_; }
+        double getMaximum() const { return maximum_; }
+        unsigned getSubBucketBits() const { return subBucketBits_; }
+        const std::vector<double> &getCounts() const { return counts_; }
+        double getUnderflow() const { return underflow_; }
+        double getOverflow() const { return overflow_; }
+        double getTotal() const { return total_; }
+
+    private:
+        Histogram(Scale scale, double minimum, double maximum, size_t bins, unsigned subBucketBits);
+
+        Scale scale_;
+        double minimum_;
+        double maximum_;
+        unsigned subBucketBits_;
+        double scaleFactor_; // bins per unit of the scale's transformed range
+        std::vector<double> counts_;
+        double underflow_;
+        double overflow_;
+        double total_;
+    };
+
+} // namespace utils
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Build with -DUTILS_ENABLE_INSTRUMENTATION=0 to compile every probe away
+#ifndef UTILS_ENABLE_INSTRUMENTATION
+#define UTILS_ENABLE_INSTRUMENTATION 1
+#endif
+
+namespace utils
+{
+
+    /**
+     * Monotonic event counter with relaxed atomic updates.
+     *
+     * Metrics register themselves on construction and must have static
+     * storage duration; define them with UTILS_DEFINE_COUNTER.
+     */
+    class Counter
+    {
+    public:
+        Counter(const char *name, const char *help);
+
+        Counter(const Counter &) = delete;
+        Counter &operator=(const Counter &) = delete;
+
+        void add(uint64_t amount = 1) { value_.fetch_add(amount, std::memory_order_relaxed); }
+        void reset() { value_.store(0, std::memory_order_relaxed); }
+
+        // Accessors
+        const char *getName() const { return name_; }
+        const char *getHelp() const { return help_; }
+        uint64_t getValue() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        const char *name_;
+        const char *help_;
+        std::atomic<uint64_t> value_;
+    };
+
+    /**
+     * Accumulated durations for one timed code region.
+     */
+    class TimerMetric
+    {
+    public:
+        TimerMetric(const char *name, const char *help);
+
+        TimerMetric(const TimerMetric &) = delete;
+        TimerMetric &operator=(const TimerMetric &) = delete;
+
+        void record(uint64_t nanoseconds);
+        void reset();
+
+        // Accessors
+        const char *getName() const { return name_; }
+        const char *getHelp() const { return help_; }
+        uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+        uint64_t getTotalNanoseconds() const { return totalNanoseconds_.load(std::memory_order_relaxed); }
+        uint64_t getMaxNanoseconds() const { return maxNanoseconds_.load(std::memory_order_relaxed); }
+
+    private:
+        const char *name_;
+        const char *help_;
+        std::atomic<uint64_t> count_;
+        std::atomic<uint64_t> totalNanoseconds_;
+        std::atomic<uint64_t> maxNanoseconds_;
+    };
+
+    /**
+     * Times the enclosing scope into a TimerMetric, and into the trace
+     * buffer while tracing is enabled.
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(TimerMetric &metric)
+            : metric_(metric), start_(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        TimerMetric &metric_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * Process-wide metric registry and exporters.
+     */
+    class Instrumentation
+    {
+    public:
+        // Exporters
+        static std::string exportPrometheus();
+        static std::string exportChromeTrace();
+
+        // Tracing (off by default; events beyond MAX_TRACE_EVENTS are dropped)
+        static void setTracingEnabled(bool enabled);
+        static bool isTracingEnabled() { return tracingEnabled_.load(std::memory_order_relaxed); }
+        static void clearTrace();
+        static uint64_t getDroppedTraceEvents();
+
+        // Registered metrics in registration order, e.g. to diff around a workload
+        static std::vector<const Counter *> getCounters();
+        static std::vector<const TimerMetric *> getTimers();
+
+        // Zeroes all metrics and discards the trace
+        static void reset();
+
+        // Constants
+        static constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+
+    private:
+        friend class Counter;
+        friend class TimerMetric;
+        friend class ScopedTimer;
+
+        static void registerCounter(Counter *counter);
+        static void registerTimer(TimerMetric *timer);
+        static void recordTraceEvent(const TimerMetric &metric, std::chrono::steady_clock::time_point start,
+                                     std::chrono::steady_clock::time_point end);
+
+        static std::atomic<bool> tracingEnabled_;
+
+        // Prevent instantiation
+        Instrumentation() = delete;
+        ~Instrumentation() = delete;
+        Instrumentation(const Instrumentation &) = delete;
+        Instrumentation &operator=(const Instrumentation &) = delete;
+    };
+
+} // namespace utils
+
+#define UTILS_INSTRUMENTATION_CONCAT_INNER(a, b) a##b
+#define UTILS_INSTRUMENTATION_CONCAT(a, b) UTILS_INSTRUMENTATION_CONCAT_INNER(a, b)
+
+#if UTILS_ENABLE_INSTRUMENTATION
+#define UTILS_DEFINE_COUNTER(variable, name, help) static ::utils::Counter variable(name, help)
+#define UTILS_DEFINE_TIMER(variable, name, help) static ::utils::TimerMetric variable(name, help)
+#define UTILS_COUNT(variable, amount) (variable).add(amount)
+#define UTILS_SCOPED_TIMER(variable) \
+    ::utils::ScopedTimer UTILS_INSTRUMENTATION_CONCAT(scopedTimer_, __LINE__)(variable)
+#else
+#define UTILS_DEFINE_COUNTER(variable, name, help) static_assert(true, "")
+#define UTILS_DEFINE_TIMER(variable, name, help) static_assert(true, "")
+#define UTILS_COUNT(variable, amount) ((void)0)
+#define UTILS_SCOPED_TIMER(variable) ((void)0)
+#endif
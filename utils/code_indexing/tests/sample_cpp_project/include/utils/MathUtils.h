@@ -1,27 +1,204 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
 
 namespace utils
 {
 
+    class Histogram;
+    class QuantileEstimator;
+    class SampleSource;
+    class StatisticsSummary;
+    enum class FileAccess; // utils/SampleSource.h
+
     /**
      * Utility class for mathematical operations.
+     *
+     * Everything is constexpr, so it inlines at every call site and can
+     * build lookup tables at compile time.
      */
     class MathUtils
     {
     public:
         // Static methods
-        static double clamp(double value, double min, double max);
-        static double lerp(double a, double b, double t);
-        static bool isNearZero(double value, double epsilon = 1e-9);
+        static constexpr double clamp(double value, double min, double max)
+        {
+            return std::max(min, std::min(value, max));
+        }
+
+        static constexpr double lerp(double a, double b, double t)
+        {
+            return a + t * (b - a);
+        }
+
+        static constexpr bool isNearZero(double value, double epsilon = 1e-9)
+        {
+            return abs(value) < epsilon;
+        }
+
+        template <typename T>
+        static constexpr T abs(T value)
+        {
+            return (value < T{}) ? -value : value;
+        }
+
+        // Square roots usable in constant expressions; std::sqrt at run time
+        static constexpr double sqrt(double value)
+        {
+            if (std::is_constant_evaluated())
+                return constexprSqrt(value);
+            return std::sqrt(value);
+        }
+
+        static constexpr float sqrt(float value)
+        {
+            if (std::is_constant_evaluated())
+                return static_cast<float>(constexprSqrt(value)); // 53 bits round to 24 exactly
+            return std::sqrt(value);
+        }
+
+        // a * b + c, fused where the target has fast FMA (e.g. -mfma or -march=native)
+        static float multiplyAdd(float a, float b, float c)
+        {
+#ifdef FP_FAST_FMAF
+            return std::fma(a, b, c);
+#else
+            return a * b + c;
+#endif
+        }
+
+        static double multiplyAdd(double a, double b, double c)
+        {
+#ifdef FP_FAST_FMA
+            return std::fma(a, b, c);
+#else
+            return a * b + c;
+#endif
+        }
+
+        // Approximate 1 / sqrt(value) for positive finite values: a bit-pattern
+        // seed refined by Newton steps (relative error below 5e-6 for float,
+        // 1e-10 for double). Plain arithmetic, so loops over it vectorize.
+        static float reciprocalSqrt(float value)
+        {
+            float estimate = std::bit_cast<float>(0x5f375a86u - (std::bit_cast<uint32_t>(value) >> 1));
+            estimate = refineReciprocalSqrt(value, estimate);
+            return refineReciprocalSqrt(value, estimate);
+        }
+
+        static double reciprocalSqrt(double value)
+        {
+            double estimate = std::bit_cast<double>(0x5fe6eb50c7b537a9ull - (std::bit_cast<uint64_t>(value) >> 1));
+            estimate = refineReciprocalSqrt(value, estimate);
+            estimate = refineReciprocalSqrt(value, estimate);
+            return refineReciprocalSqrt(value, estimate);
+        }
 
         // Constants
         static constexpr double EPSILON = 1e-9;
         static constexpr double GOLDEN_RATIO = 1.618033988749895;
 
     private:
+        // One Newton-Raphson step for 1 / sqrt(value)
+        template <typename T>
+        static T refineReciprocalSqrt(T value, T estimate)
+        {
+            T halfValue = static_cast<T>(0.5) * value;
+            return estimate * multiplyAdd(-halfValue * estimate, estimate, static_cast<T>(1.5));
+        }
+
+        // Full 128-bit product of two 64-bit values from 32-bit halves (the
+        // low half is returned), so no compiler-specific 128-bit type is needed
+        static constexpr uint64_t multiplyWide(uint64_t a, uint64_t b, uint64_t &high)
+        {
+            constexpr uint64_t LOW_MASK = 0xffffffffu;
+            uint64_t lowLow = (a & LOW_MASK) * (b & LOW_MASK);
+            uint64_t lowHigh = (a & LOW_MASK) * (b >> 32);
+            uint64_t highLow = (a >> 32) * (b & LOW_MASK);
+            uint64_t highHigh = (a >> 32) * (b >> 32);
+            uint64_t middle = (lowLow >> 32) + (lowHigh & LOW_MASK) + (highLow & LOW_MASK);
+            high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+            return (lowLow & LOW_MASK) | (middle << 32);
+        }
+
+        // Correctly rounded like std::sqrt: integer square root of the
+        // significand, then round-to-nearest-even
+        static constexpr double constexprSqrt(double value)
+        {
+            if (!(value > 0.0) || value == std::numeric_limits<double>::infinity())
+            {
+                return (value == 0.0 || value > 0.0) ? value : std::numeric_limits<double>::quiet_NaN();
+            }
+
+            // value = significand * 2^exponent with a 53-bit integer significand
+            uint64_t bits = std::bit_cast<uint64_t>(value);
+            int exponent = static_cast<int>(bits >> 52);
+            uint64_t significand = bits & ((uint64_t{1} << 52) - 1);
+            if (exponent == 0)
+            {
+                exponent = 1;
+                while (!(significand & (uint64_t{1} << 52)))
+                {
+                    significand <<= 1;
+                    --exponent;
+                }
+            }
+            else
+            {
+                significand |= uint64_t{1} << 52;
+            }
+            exponent -= 1075;
+            if (exponent & 1)
+            {
+                significand <<= 1;
+                --exponent;
+            }
+
+            // The root of significand * 2^56 has exactly 55 bits: 53 plus round and
+            // sticky. It is found bit by bit against the square's two 64-bit halves.
+            uint64_t squareHigh = significand >> 8;
+            uint64_t squareLow = significand << 56;
+            uint64_t root = 0;
+            uint64_t rootSquaredHigh = 0;
+            uint64_t rootSquaredLow = 0;
+            for (int bit = 54; bit >= 0; --bit)
+            {
+                uint64_t candidate = root | (uint64_t{1} << bit);
+                uint64_t high = 0;
+                uint64_t low = multiplyWide(candidate, candidate, high);
+                if (high < squareHigh || (high == squareHigh && low <= squareLow))
+                {
+                    root = candidate;
+                    rootSquaredHigh = high;
+                    rootSquaredLow = low;
+                }
+            }
+            bool inexact = rootSquaredHigh != squareHigh || rootSquaredLow != squareLow;
+
+            uint64_t result = static_cast<uint64_t>(root >> 2);
+            unsigned remainder = static_cast<unsigned>(root & 3);
+            if (remainder > 2 || (remainder == 2 && (inexact || (result & 1))))
+                ++result;
+
+            int resultExponent = (exponent - 56) / 2 + 2;
+            if (result == (uint64_t{1} << 53))
+            {
+                result >>= 1;
+                ++resultExponent;
+            }
+            uint64_t biased = static_cast<uint64_t>(resultExponent + 52 + 1023);
+            return std::bit_cast<double>((biased << 52) | (result & ((uint64_t{1} << 52) - 1)));
+        }
+
         // Prevent instantiation
         MathUtils() = delete;
         ~MathUtils() = delete;
@@ -29,6 +206,23 @@ namespace utils
         MathUtils &operator=(const MathUtils &) = delete;
     };
 
+    /**
+     * Precision policies for Vector2D lengths, chosen per call site.
+     *
+     * precision::fast multiplies by an approximate reciprocal square root
+     * (finite inputs only) instead of a square root and two divisions;
+     * precision::precise uses std::hypot (double arithmetic for float),
+     * which neither overflows nor underflows in the squared length.
+     */
+    namespace precision
+    {
+        struct Fast {};
+        struct Precise {};
+
+        inline constexpr Fast fast{};
+        inline constexpr Precise precise{};
+    } // namespace precision
+
     /**
      * Template class for 2D vectors.
      */
@@ -36,32 +230,118 @@ namespace utils
     class Vector2D
     {
     public:
-        Vector2D() : x(T{}), y(T{}) {}
-        Vector2D(T x_val, T y_val) : x(x_val), y(y_val) {}
+        constexpr Vector2D() : x(T{}), y(T{}) {}
+        constexpr Vector2D(T x_val, T y_val) : x(x_val), y(y_val) {}
 
         // Arithmetic operators
-        Vector2D operator+(const Vector2D &other) const;
-        Vector2D operator-(const Vector2D &other) const;
-        Vector2D operator*(T scalar) const;
-        Vector2D &operator+=(const Vector2D &other);
-        Vector2D &operator-=(const Vector2D &other);
-        Vector2D &operator*=(T scalar);
+        constexpr Vector2D operator+(const Vector2D &other) const { return Vector2D(x + other.x, y + other.y); }
+        constexpr Vector2D operator-(const Vector2D &other) const { return Vector2D(x - other.x, y - other.y); }
+        constexpr Vector2D operator*(T scalar) const { return Vector2D(x * scalar, y * scalar); }
+
+        constexpr Vector2D &operator+=(const Vector2D &other)
+        {
+            x += other.x;
+            y += other.y;
+            return *this;
+        }
+
+        constexpr Vector2D &operator-=(const Vector2D &other)
+        {
+            x -= other.x;
+            y -= other.y;
+            return *this;
+        }
+
+        constexpr Vector2D &operator*=(T scalar)
+        {
+            x *= scalar;
+            y *= scalar;
+            return *this;
+        }
 
         // Comparison operators
-        bool operator==(const Vector2D &other) const;
-        bool operator!=(const Vector2D &other) const;
+        constexpr bool operator==(const Vector2D &other) const
+        {
+            return MathUtils::abs(x - other.x) < EPSILON_VAL &&
+                   MathUtils::abs(y - other.y) < EPSILON_VAL;
+        }
+
+        constexpr bool operator!=(const Vector2D &other) const { return !(*this == other); }
 
         // Utility methods
-        T magnitude() const;
-        T magnitudeSquared() const;
-        Vector2D normalized() const;
-        T dot(const Vector2D &other) const;
+        constexpr T magnitude() const
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                return MathUtils::sqrt(x * x + y * y);
+            else
+                return static_cast<T>(MathUtils::sqrt(static_cast<double>(x * x + y * y)));
+        }
+
+        constexpr T magnitudeSquared() const { return x * x + y * y; }
+
+        constexpr Vector2D normalized() const
+        {
+            T mag = magnitude();
+            // EPSILON_VAL truncates to zero for integer vectors, so test zero explicitly
+            if (mag < EPSILON_VAL || mag == T{})
+            {
+                return Vector2D(T{}, T{});
+            }
+            return Vector2D(x / mag, y / mag);
+        }
+
+        constexpr T dot(const Vector2D &other) const { return x * other.x + y * other.y; }
+
+        // Precision policies (floating-point vectors only)
+        T magnitude(precision::Fast) const
+            requires std::is_floating_point_v<T>
+        {
+            // The seed for zero is finite, so zero maps to zero without a branch
+            T squared = MathUtils::multiplyAdd(x, x, y * y);
+            return squared * MathUtils::reciprocalSqrt(squared);
+        }
+
+        T magnitude(precision::Precise) const
+            requires std::is_floating_point_v<T>
+        {
+            return preciseMagnitude();
+        }
+
+        Vector2D normalized(precision::Fast) const
+            requires std::is_floating_point_v<T>
+        {
+            // Branch-free, so loops over it vectorize
+            T squared = MathUtils::multiplyAdd(x, x, y * y);
+            T inverse = MathUtils::reciprocalSqrt(squared);
+            inverse = squared < EPSILON_VAL * EPSILON_VAL ? T{} : inverse;
+            return Vector2D(x * inverse, y * inverse);
+        }
+
+        Vector2D normalized(precision::Precise) const
+            requires std::is_floating_point_v<T>
+        {
+            T mag = preciseMagnitude();
+            if (mag < EPSILON_VAL)
+            {
+                return Vector2D(T{}, T{});
+            }
+            return Vector2D(x / mag, y / mag);
+        }
 
         // Public members
         T x, y;
 
     private:
         static constexpr T EPSILON_VAL = static_cast<T>(1e-9);
+
+        // Float squares cannot overflow or lose bits in double, which is much faster than hypotf
+        T preciseMagnitude() const
+        {
+            if constexpr (std::is_same_v<T, float>)
+                return static_cast<float>(std::sqrt(static_cast<double>(x) * x + static_cast<double>(y) * y));
+            else
+                return std::hypot(x, y);
+        }
     };
 
     /**
@@ -87,38 +367,141 @@ namespace utils
     {
     public:
         StatisticsCalculator();
+        StatisticsCalculator(const StatisticsCalculator &other);
+        StatisticsCalculator(StatisticsCalculator &&other) noexcept;
+        StatisticsCalculator &operator=(const StatisticsCalculator &other);
+        StatisticsCalculator &operator=(StatisticsCalculator &&other) noexcept;
         ~StatisticsCalculator();
 
         // Data management
         void addValue(double value);
         void addValues(const std::vector<double> &values);
+        void addValues(std::vector<double> &&values);
+        void addValues(std::span<const double> values);
+        template <typename InputIt>
+        void addValues(InputIt first, InputIt last)
+        {
+            size_t previous = data_.size();
+            data_.insert(data_.end(), first, last);
+            valuesAppended(previous);
+        }
+        void addSortedValues(std::span<const double> sorted);
+        void reserve(size_t capacity) { data_.reserve(capacity); }
         void clear();
 
-        // Calculations
+        // Merging: the exact in-process merge appends other's samples (derived
+        // summaries update as for addValues); summarize() adds every sample to a
+        // compact summary for shipping, binned with the incremental histogram
+        // layout if summary is still empty. Both are false if a source fails.
+        bool merge(const StatisticsCalculator &other);
+        bool summarize(StatisticsSummary &summary) const;
+
+        // Quantile backend (nullptr restores exact, sort-based percentiles). The
+        // backend only makes percentile queries cheap: every sample is still
+        // kept for the exact moments, histograms and merges, so memory grows
+        // with the count. Use StatisticsSummary where memory must stay bounded.
+        void setQuantileBackend(std::unique_ptr<QuantileEstimator> backend);
+        const QuantileEstimator *getQuantileBackend() const { return quantileBackend_.get(); }
+
+        // Incremental histogram (fixed edges, counts updated on insert)
+        void setIncrementalHistogram(const Histogram &layout);
+        void clearIncrementalHistogram();
+        const Histogram *getIncrementalHistogram() const { return incrementalHistogram_.get(); }
+
+        // External samples, read in place alongside added values (nullptr detaches)
+        void attachSource(std::shared_ptr<const SampleSource> source);
+        void attachView(std::span<const double> samples);
+        bool attachFile(const std::string &path); // FileAccess::Mapped
+        bool attachFile(const std::string &path, FileAccess access);
+        void detachSource() { attachSource(nullptr); }
+        const SampleSource *getSource() const { return source_.get(); }
+
+        // Calculations (percentiles outside [0, 100] are clamped)
         Statistics calculate() const;
+        Statistics calculate(const std::vector<double> &percentiles, std::vector<double> &values) const;
         double getPercentile(double percentile) const;
+        std::vector<double> getPercentiles(const std::vector<double> &percentiles) const;
         std::vector<double> getHistogram(size_t bins) const;
+        std::vector<double> getHistogram() const;
 
         // Accessors
-        size_t getCount() const { return data_.size(); }
-        bool isEmpty() const { return data_.empty(); }
+        size_t getCount() const; // added values plus any attached source
+        bool isEmpty() const { return getCount() == 0; }
 
     protected:
         void sortDataIfNeeded() const;
 
     private:
-        std::vector<double> data_;
+        mutable std::vector<double> data_;
         mutable bool is_sorted_;
+        std::unique_ptr<QuantileEstimator> quantileBackend_;
+        std::unique_ptr<Histogram> incrementalHistogram_;
+        std::shared_ptr<const SampleSource> source_;
 
         // Helper methods
-        double calculateMean() const;
-        double calculateMedian() const;
-        double calculateStandardDeviation(double mean) const;
+        void valuesAppended(size_t first);
+        void feedDerived(const SampleSource &source);
+    };
+
+    /**
+     * Statistics over samples stored in their native type.
+     *
+     * Integer latencies or float32 readings stay in T, halving memory against
+     * double storage and letting selection and the moments pass work on the
+     * narrow type; only the moment accumulators widen to Accum. Results match
+     * StatisticsCalculator on the same samples. Instantiated for float, double
+     * and int with double accumulators; StatisticsCalculator remains the
+     * double calculator with quantile backends and external sources.
+     */
+    template <typename T, typename Accum = double>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    class BasicStatisticsCalculator
+    {
+    public:
+        using value_type = T;
+        using accumulator_type = Accum;
+
+        BasicStatisticsCalculator() : is_sorted_(true) {}
+
+        // Data management
+        void addValue(T value);
+        void addValues(const std::vector<T> &values);
+        void addValues(std::vector<T> &&values);
+        void addValues(std::span<const T> values);
+        template <typename InputIt>
+        void addValues(InputIt first, InputIt last)
+        {
+            data_.insert(data_.end(), first, last);
+            is_sorted_ = false;
+        }
+        void reserve(size_t capacity) { data_.reserve(capacity); }
+        void clear();
+
+        // Calculations (percentiles interpolate between samples in double)
+        Statistics calculate() const;
+        Statistics calculate(const std::vector<double> &percentiles, std::vector<double> &values) const;
+        double getPercentile(double percentile) const;
+        std::vector<double> getPercentiles(const std::vector<double> &percentiles) const;
+        std::vector<double> getHistogram(size_t bins) const;
+
+        // Accessors
+        size_t getCount() const { return data_.size(); }
+        bool isEmpty() const { return data_.empty(); }
+        std::span<const T> getValues() const { return data_; }
+
+    protected:
+        void sortDataIfNeeded() const;
+
+    private:
+        mutable std::vector<T> data_;
+        mutable bool is_sorted_;
     };
 
     // Type aliases
     using Vec2f = Vector2D<float>;
     using Vec2d = Vector2D<double>;
     using Vec2i = Vector2D<int>;
+    using FloatStatisticsCalculator = BasicStatisticsCalculator<float>;
+    using IntStatisticsCalculator = BasicStatisticsCalculator<int>;
 
 } // namespace utils
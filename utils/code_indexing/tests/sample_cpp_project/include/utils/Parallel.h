@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * Number of worker threads used by the parallel helpers.
+     */
+    inline size_t hardwareThreads()
+    {
+        unsigned threads = std::thread::hardware_concurrency();
+        return (threads > 0) ? threads : 1;
+    }
+
+    /**
+     * Fork-join loop: splits [0, count) into at most hardwareThreads()
+     * contiguous ranges of at least minChunk items and calls fn(begin, end)
+     * for each, running the first range on the calling thread.
+     */
+    template <typename Fn>
+    void parallelFor(size_t count, size_t minChunk, Fn &&fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        size_t chunks = std::min(hardwareThreads(), count / std::max<size_t>(minChunk, 1));
+        if (chunks <= 1)
+        {
+            fn(size_t{0}, count);
+            return;
+        }
+
+        size_t step = (count + chunks - 1) / chunks;
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        for (size_t begin = step; begin < count; begin += step)
+        {
+            size_t end = std::min(count, begin + step);
+            workers.emplace_back([&fn, begin, end]()
+                                 { fn(begin, end); });
+        }
+
+        fn(size_t{0}, step);
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * Sorts runs of at least minChunk items in parallel, then merges
+     * neighbouring runs pairwise (also in parallel) until one run remains.
+     */
+    template <typename RandomIt>
+    void parallelSort(RandomIt first, RandomIt last, size_t minChunk = 1 << 16)
+    {
+        size_t count = static_cast<size_t>(last - first);
+        size_t runs = std::min(hardwareThreads(), count / std::max<size_t>(minChunk, 1));
+        if (runs <= 1)
+        {
+            std::sort(first, last);
+            return;
+        }
+
+        std::vector<size_t> bounds;
+        for (size_t run = 0; run <= runs; ++run)
+        {
+            bounds.push_back(count * run / runs);
+        }
+
+        parallelFor(runs, 1, [&](size_t begin, size_t end)
+                    {
+                        for (size_t run = begin; run < end; ++run)
+                        {
+                            std::sort(first + bounds[run], first + bounds[run + 1]);
+                        } });
+
+        while (bounds.size() > 2)
+        {
+            size_t pairs = (bounds.size() - 1) / 2;
+            parallelFor(pairs, 1, [&](size_t begin, size_t end)
+                        {
+                            for (size_t pair = begin; pair < end; ++pair)
+                            {
+                                std::inplace_merge(first + bounds[2 * pair], first + bounds[2 * pair + 1],
+                                                   first + bounds[2 * pair + 2]);
+                            } });
+
+            std::vector<size_t> merged;
+            for (size_t i = 0; i < bounds.size(); i += 2)
+            {
+                merged.push_back(bounds[i]);
+            }
+            if (merged.back() != bounds.back())
+            {
+                merged.push_back(bounds.back());
+            }
+            bounds.swap(merged);
+        }
+    }
+
+} // namespace utils
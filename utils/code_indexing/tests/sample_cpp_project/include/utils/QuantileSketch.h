@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * Abstract interface for pluggable quantile backends.
+     */
+    class QuantileEstimator
+    {
+    public:
+        virtual ~QuantileEstimator() = default;
+
+        // Data management
+        virtual void add(double value) = 0;
+        virtual void clear() = 0;
+
+        // Calculations (quantile in [0, 1])
+        virtual double quantile(double quantile) const = 0;
+
+        // Accessors
+        virtual size_t getCount() const = 0;
+        virtual std::unique_ptr<QuantileEstimator> clone() const = 0;
+    };
+
+    /**
+     * KLL quantile sketch (Karnin, Lang & Liberty).
+     *
+     * Keeps a hierarchy of compactors whose capacities shrink geometrically
+     * with depth, so memory is O(k log(n / k)) and ingest is O(1) amortized.
+     * Rank error is roughly 1.7 / k^0.97 of the count with high probability.
+     * Sketches built on different threads or nodes can be merged.
+     */
+    class KllSketch : public QuantileEstimator
+    {
+    public:
+        explicit KllSketch(size_t k = DEFAULT_K);
+
+        // Data management
+        void add(double value) override;
+        void merge(const KllSketch &other);
+        void clear() override;
+
+        // Merges retained items given level by level (items at level h weigh 2^h),
+        // e.g. straight out of a serialized sketch
+        void mergeRetained(size_t k, size_t count, double minimum, double maximum,
+                           std::span<const std::span<const double>> levels);
+
+        // Calculations
+        double quantile(double quantile) const override;
+        double rank(double value) const;
+
+        // Accessors
+        size_t getCount() const override { return count_; }
+        size_t getK() const { return k_; }
+        size_t getRetainedCount() const;
+        const std::vector<std::vector<double>> &getLevels() const { return levels_; }
+        double getMinimum() const { return minimum_; }
+        double getMaximum() const { return maximum_; }
+        bool isEmpty() const { return count_ == 0; }
+        std::unique_ptr<QuantileEstimator> clone() const override;
+
+        // Constants
+        static constexpr size_t DEFAULT_K = 200;
+        static constexpr size_t MIN_LEVEL_CAPACITY = 8;
+
+    private:
+        size_t k_;
+        size_t count_;
+        double minimum_;
+        double maximum_;
+        uint64_t randomState_;
+        std::vector<std::vector<double>> levels_; // items at level h weigh 2^h
+
+        // Sorted (value, cumulative weight) view, rebuilt lazily
+        mutable std::vector<std::pair<double, uint64_t>> sortedView_;
+        mutable bool viewValid_;
+
+        // Helper methods
+        size_t levelCapacity(size_t level) const;
+        void compress();
+        bool nextRandomBit();
+        void buildSortedView() const;
+    };
+
+} // namespace utils
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace utils
+{
+
+    /**
+     * Least-significant-digit radix sort for doubles.
+     *
+     * Values are ordered by ChunkedStatistics::orderedKey, whose integer
+     * order is the numeric order, in 11-bit digits: six stable scatter
+     * passes, with passes skipped when every value shares the digit (e.g.
+     * the sign and exponent bits of same-magnitude data). The result is the
+     * ascending order std::sort gives; only equal values such as -0.0 and
+     * 0.0 may differ in relative order. NaNs sort to the ends by sign, where
+     * std::sort's behaviour is undefined. Sorting needs a scratch buffer
+     * the size of the input.
+     */
+    class RadixSort
+    {
+    public:
+        // Picks std::sort, serial or parallel radix sort by size
+        static void sort(std::span<double> values);
+
+        // Radix sort on the calling thread
+        static void serialSort(std::span<double> values);
+
+        // Radix sort with counting and scatter split over hardwareThreads()
+        static void parallelSort(std::span<double> values);
+
+        // Constants
+        static constexpr unsigned DIGIT_BITS = 11;
+        static constexpr unsigned PASSES = (64 + DIGIT_BITS - 1) / DIGIT_BITS;
+        static constexpr size_t BUCKETS = size_t{1} << DIGIT_BITS;
+        static constexpr size_t MIN_RADIX_SIZE = 1 << 12;
+        static constexpr size_t MIN_PARALLEL_SIZE = 1 << 21;
+        static constexpr size_t MIN_PARALLEL_CHUNK = 1 << 19;
+
+    private:
+        // Prevent instantiation
+        RadixSort() = delete;
+        ~RadixSort() = delete;
+        RadixSort(const RadixSort &) = delete;
+        RadixSort &operator=(const RadixSort &) = delete;
+    };
+
+} // namespace utils
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+
+    // How file-backed samples are read
+    enum class FileAccess
+    {
+        Mapped,  // mmap the whole file read-only
+        Streamed // pread fixed-size chunks, for files that cannot be mapped
+    };
+
+    /**
+     * Read-only sequence of samples visited chunk by chunk.
+     *
+     * Sources never copy samples into owned storage beyond a bounded read
+     * buffer, so algorithms written against forEachChunk() run over data
+     * far larger than memory with one sequential pass each.
+     */
+    class SampleSource
+    {
+    public:
+        using ChunkVisitor = std::function<void(std::span<const double> chunk)>;
+
+        virtual ~SampleSource() = default;
+
+        // Visits all samples in order; false on a read error
+        virtual bool forEachChunk(const ChunkVisitor &visitor) const = 0;
+        virtual size_t getCount() const = 0;
+        bool isEmpty() const { return getCount() == 0; }
+    };
+
+    /**
+     * Non-owning view of samples already in memory.
+     */
+    class SpanSource : public SampleSource
+    {
+    public:
+        explicit SpanSource(std::span<const double> samples) : samples_(samples) {}
+
+        bool forEachChunk(const ChunkVisitor &visitor) const override;
+        size_t getCount() const override { return samples_.size(); }
+
+    private:
+        std::span<const double> samples_;
+    };
+
+    /**
+     * Several sources visited back to back (sources must outlive this).
+     */
+    class ConcatenatedSource : public SampleSource
+    {
+    public:
+        explicit ConcatenatedSource(std::vector<const SampleSource *> sources) : sources_(std::move(sources)) {}
+
+        bool forEachChunk(const ChunkVisitor &visitor) const override;
+        size_t getCount() const override;
+
+    private:
+        std::vector<const SampleSource *> sources_;
+    };
+
+    /**
+     * File of raw native-endian doubles mapped read-only into memory.
+     *
+     * Pages are faulted in on demand and the mapping is advised as
+     * sequential, so the kernel can evict pages behind each pass. Trailing
+     * bytes that do not form a whole double are ignored.
+     */
+    class MappedFileSource : public SampleSource
+    {
+    public:
+        MappedFileSource() = default;
+        ~MappedFileSource() override;
+
+        MappedFileSource(const MappedFileSource &) = delete;
+        MappedFileSource &operator=(const MappedFileSource &) = delete;
+
+        // False if the file cannot be opened or mapped
+        bool open(const std::string &path);
+        void close();
+
+        bool forEachChunk(const ChunkVisitor &visitor) const override;
+        size_t getCount() const override { return count_; }
+
+        // Accessors
+        bool isOpen() const { return open_; }
+        std::span<const double> getSamples() const;
+
+        // Constants
+        static constexpr size_t CHUNK_SAMPLES = 1 << 20;
+
+    private:
+        void *mapping_ = nullptr;
+        size_t mappedBytes_ = 0;
+        size_t count_ = 0;
+        bool open_ = false;
+    };
+
+    /**
+     * File of raw native-endian doubles read with pread() into a buffer
+     * allocated per pass; memory use stays at the buffer size regardless
+     * of file size.
+     */
+    class FileStreamSource : public SampleSource
+    {
+    public:
+        explicit FileStreamSource(size_t bufferSamples = DEFAULT_BUFFER_SAMPLES);
+        ~FileStreamSource() override;
+
+        FileStreamSource(const FileStreamSource &) = delete;
+        FileStreamSource &operator=(const FileStreamSource &) = delete;
+
+        // False if the file cannot be opened
+        bool open(const std::string &path);
+        void close();
+
+        bool forEachChunk(const ChunkVisitor &visitor) const override;
+        size_t getCount() const override { return count_; }
+
+        // Accessors
+        bool isOpen() const { return fileDescriptor_ >= 0; }
+
+        // Constants
+        static constexpr size_t DEFAULT_BUFFER_SAMPLES = 1 << 20;
+
+    private:
+        int fileDescriptor_ = -1;
+        size_t count_ = 0;
+        size_t bufferSamples_;
+    };
+
+} // namespace utils
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "utils/ExactStatistics.h"
+#include "utils/Histogram.h"
+#include "utils/QuantileSketch.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace utils
+{
+
+    class StatisticsSummaryView;
+
+    /**
+     * Mergeable summary of a sample set: exact moments, a KLL sketch for
+     * quantiles and an optional fixed-edge histogram.
+     *
+     * A summary is a few kilobytes however many samples it describes, so
+     * workers ship summaries instead of samples and an aggregator merges
+     * them. The binary format is versioned; see StatisticsSummaryView.
+     */
+    class StatisticsSummary
+    {
+    public:
+        explicit StatisticsSummary(size_t sketchK = KllSketch::DEFAULT_K);
+
+        // Data management
+        void addValue(double value);
+        void addValues(std::span<const double> values);
+        void setHistogram(const Histogram &layout); // set before adding: only later samples are binned
+        void clear();
+
+        // Merging (false and unchanged unless both sides lack a histogram or share its layout)
+        bool merge(const StatisticsSummary &other);
+        bool merge(const StatisticsSummaryView &view);
+
+        // Calculations (median and percentiles are sketch estimates)
+        Statistics calculate() const;
+        double getPercentile(double percentile) const;
+
+        // Serialization (serialize() into a span fails if it is too small)
+        size_t getSerializedSize() const;
+        std::vector<uint8_t> serialize() const;
+        bool serialize(std::span<uint8_t> out) const;
+        static bool deserialize(std::span<const uint8_t> bytes, StatisticsSummary &summary);
+
+        // Accessors
+        size_t getCount() const { return moments_.count; }
+        bool isEmpty() const { return moments_.count == 0; }
+        const SampleMoments &getMoments() const { return moments_; }
+        const KllSketch &getSketch() const { return sketch_; }
+        const Histogram *getHistogram() const { return histogram_ ? &*histogram_ : nullptr; }
+
+        // Format constants
+        static constexpr uint32_t MAGIC = 0x4D535453; // "STSM" in little-endian byte order
+        static constexpr uint16_t FORMAT_VERSION = 1;
+        static constexpr uint16_t FLAG_HISTOGRAM = 1;
+
+    private:
+        SampleMoments moments_;
+        KllSketch sketch_;
+        std::optional<Histogram> histogram_;
+    };
+
+    /**
+     * Zero-copy reader over a serialized StatisticsSummary.
+     *
+     * Format version 1, all fields little-endian and 8-byte aligned:
+     *
+     *   u32 magic, u16 version, u16 flags
+     *   u64 count, f64 mean, f64 sumSquaredDiff, f64 minimum, f64 maximum
+     *   u64 sketch k, u64 level count, u64 level sizes[level count],
+     *   f64 retained items, level 0 first
+     *   if flags & FLAG_HISTOGRAM:
+     *     u32 scale, u32 sub-bucket bits, f64 minimum, f64 maximum,
+     *     u64 bin count, f64 underflow, f64 overflow, f64 counts[bin count]
+     *
+     * parse() checks the framing and that the moments and sketch agree:
+     * finite moments with minimum <= maximum, retained items within the
+     * extremes, and level weights (size << level) summing to count;
+     * histogram counts are taken as they are. The accessors then return
+     * spans straight into the buffer, so it must stay alive, unmodified and
+     * 8-byte aligned (as std::vector and operator new storage is).
+     */
+    class StatisticsSummaryView
+    {
+    public:
+        // False on a short, misaligned, corrupt, inconsistent or newer-version buffer
+        bool parse(std::span<const uint8_t> bytes);
+
+        // Accessors (valid after a successful parse)
+        uint16_t getVersion() const { return version_; }
+        const SampleMoments &getMoments() const { return moments_; }
+        size_t getSketchK() const { return sketchK_; }
+        size_t getSketchLevelCount() const { return levels_.size(); }
+        std::span<const double> getSketchLevel(size_t level) const { return levels_[level]; }
+        std::span<const std::span<const double>> getSketchLevels() const { return levels_; }
+
+        bool hasHistogram() const { return hasHistogram_; }
+        bool hasHistogramLayout(const Histogram &layout) const;
+        Histogram::Scale getHistogramScale() const { return histogramScale_; }
+        unsigned getHistogramSubBucketBits() const { return histogramSubBucketBits_; }
+        double getHistogramMinimum() const { return histogramMinimum_; }
+        double getHistogramMaximum() const { return histogramMaximum_; }
+        std::span<const double> getHistogramCounts() const { return histogramCounts_; }
+        double getHistogramUnderflow() const { return histogramUnderflow_; }
+        double getHistogramOverflow() const { return histogramOverflow_; }
+
+        // Constants
+        static constexpr size_t MAX_SKETCH_LEVELS = 64;
+
+    private:
+        uint16_t version_ = 0;
+        SampleMoments moments_;
+        size_t sketchK_ = 0;
+        std::vector<std::span<const double>> levels_;
+        bool hasHistogram_ = false;
+        Histogram::Scale histogramScale_ = Histogram::Scale::Linear;
+        unsigned histogramSubBucketBits_ = 0;
+        double histogramMinimum_ = 0.0;
+        double histogramMaximum_ = 0.0;
+        std::span<const double> histogramCounts_;
+        double histogramUnderflow_ = 0.0;
+        double histogramOverflow_ = 0.0;
+    };
+
+} // namespace utils
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "utils/MathUtils.h"
+#include <cstddef>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * Welford running mean/variance with min, max and count.
+     */
+    class RunningMoments
+    {
+    public:
+        RunningMoments();
+
+        // Data management
+        void add(double value);
+        void merge(const RunningMoments &other);
+        void clear();
+
+        // Accessors
+        size_t getCount() const { return count_; }
+        double getMean() const { return mean_; }
+        double getSumSquaredDiff() const { return m2_; }
+        double getMinimum() const { return minimum_; }
+        double getMaximum() const { return maximum_; }
+        double getVariance() const;
+        double getStandardDeviation() const;
+
+    private:
+        size_t count_;
+        double mean_;
+        double m2_;
+        double minimum_;
+        double maximum_;
+    };
+
+    /**
+     * P-square (Jain & Chlamtac) estimator for a single quantile.
+     *
+     * Tracks five markers, so memory stays constant regardless of the
+     * number of samples. Results are exact for up to five samples.
+     */
+    class P2QuantileEstimator
+    {
+    public:
+        explicit P2QuantileEstimator(double quantile = 0.5);
+
+        // Data management
+        void add(double value);
+        void clear();
+
+        // Calculations
+        double estimate() const;
+
+        // Accessors
+        double getQuantile() const { return quantile_; }
+        size_t getCount() const { return count_; }
+
+    private:
+        double quantile_;
+        size_t count_;
+        double heights_[5];
+        double positions_[5];
+        double desired_[5];
+        double increments_[5];
+
+        // Helper methods
+        double parabolic(int i, double d) const;
+        double linear(int i, int d) const;
+    };
+
+    /**
+     * Single-pass statistics that do not retain raw samples.
+     *
+     * Mean, standard deviation, minimum, maximum and count are exact; the
+     * median is a P-square estimate.
+     */
+    class StreamingStatistics
+    {
+    public:
+        StreamingStatistics();
+        ~StreamingStatistics();
+
+        // Data management
+        void addValue(double value);
+        void addValues(const std::vector<double> &values);
+        void clear();
+
+        // Calculations
+        Statistics calculate() const;
+
+        // Accessors
+        size_t getCount() const { return moments_.getCount(); }
+        bool isEmpty() const { return moments_.getCount() == 0; }
+        const RunningMoments &getMoments() const { return moments_; }
+
+    private:
+        RunningMoments moments_;
+        P2QuantileEstimator median_;
+    };
+
+} // namespace utils
@@ -0,0 +1,286 @@
+#pragma once
+
+#include "utils/MathUtils.h"
+#include "utils/VectorSimd.h"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace utils
+{
+    namespace expr
+    {
+
+        /**
+         * Lazily evaluated arithmetic over arrays of Vector2D.
+         *
+         * view() wraps an array and constant() a single vector; +, - and
+         * scaling combine them into an expression tree that copies its nodes
+         * (the viewed arrays must outlive it) and computes nothing until
+         * evaluate(), which runs the whole formula in one pass with no
+         * intermediate arrays. Every element is computed with the scalar
+         * Vector2D operators in the order written, so results match an
+         * operator-by-operator evaluation exactly.
+         */
+        template <typename E>
+        concept VectorExpression = requires(const E &expression, size_t index) {
+            typename E::ValueType;
+            { expression[index] } -> std::same_as<Vector2D<typename E::ValueType>>;
+            { expression.size() } -> std::same_as<size_t>;
+        };
+
+        template <typename L, typename R>
+        concept CompatibleExpressions = VectorExpression<L> && VectorExpression<R> &&
+                                        std::same_as<typename L::ValueType, typename R::ValueType>;
+
+        /**
+         * Leaf reading an array of vectors in place.
+         */
+        template <typename T>
+        class View
+        {
+        public:
+            using ValueType = T;
+
+            constexpr explicit View(std::span<const Vector2D<T>> vectors) : vectors_(vectors) {}
+
+            constexpr Vector2D<T> operator[](size_t index) const { return vectors_[index]; }
+            constexpr size_t size() const { return vectors_.size(); }
+
+        private:
+            std::span<const Vector2D<T>> vectors_;
+        };
+
+        /**
+         * Leaf repeating one vector for every element.
+         */
+        template <typename T>
+        class Constant
+        {
+        public:
+            using ValueType = T;
+
+            constexpr explicit Constant(const Vector2D<T> &value) : value_(value) {}
+
+            constexpr Vector2D<T> operator[](size_t) const { return value_; }
+            constexpr size_t size() const { return std::numeric_limits<size_t>::max(); }
+
+        private:
+            Vector2D<T> value_;
+        };
+
+        template <typename L, typename R>
+            requires CompatibleExpressions<L, R>
+        class Sum
+        {
+        public:
+            using ValueType = typename L::ValueType;
+
+            constexpr Sum(const L &left, const R &right) : left_(left), right_(right) {}
+
+            constexpr Vector2D<ValueType> operator[](size_t index) const { return left_[index] + right_[index]; }
+            constexpr size_t size() const { return std::min(left_.size(), right_.size()); }
+
+        private:
+            L left_;
+            R right_;
+        };
+
+        template <typename L, typename R>
+            requires CompatibleExpressions<L, R>
+        class Difference
+        {
+        public:
+            using ValueType = typename L::ValueType;
+
+            constexpr Difference(const L &left, const R &right) : left_(left), right_(right) {}
+
+            constexpr Vector2D<ValueType> operator[](size_t index) const { return left_[index] - right_[index]; }
+            constexpr size_t size() const { return std::min(left_.size(), right_.size()); }
+
+        private:
+            L left_;
+            R right_;
+        };
+
+        template <VectorExpression E>
+        class Scaled
+        {
+        public:
+            using ValueType = typename E::ValueType;
+
+            constexpr Scaled(const E &operand, ValueType scalar) : operand_(operand), scalar_(scalar) {}
+
+            constexpr Vector2D<ValueType> operator[](size_t index) const { return operand_[index] * scalar_; }
+            constexpr size_t size() const { return operand_.size(); }
+
+        private:
+            E operand_;
+            ValueType scalar_;
+        };
+
+        // Leaves
+        template <typename T>
+        constexpr View<T> view(std::span<const Vector2D<T>> vectors)
+        {
+            return View<T>(vectors);
+        }
+
+        template <typename T>
+        constexpr View<T> view(std::span<Vector2D<T>> vectors)
+        {
+            return View<T>(vectors);
+        }
+
+        template <typename T>
+        constexpr View<T> view(const std::vector<Vector2D<T>> &vectors)
+        {
+            return View<T>(vectors);
+        }
+
+        // A view of a temporary would dangle once the full expression ends
+        template <typename T>
+        View<T> view(const std::vector<Vector2D<T>> &&) = delete;
+
+        template <typename T>
+        constexpr Constant<T> constant(const Vector2D<T> &value)
+        {
+            return Constant<T>(value);
+        }
+
+        // Operators (a plain Vector2D operand acts as a constant)
+        template <typename L, typename R>
+            requires CompatibleExpressions<L, R>
+        constexpr Sum<L, R> operator+(const L &left, const R &right)
+        {
+            return Sum<L, R>(left, right);
+        }
+
+        template <VectorExpression L>
+        constexpr auto operator+(const L &left, const Vector2D<typename L::ValueType> &right)
+        {
+            return Sum<L, Constant<typename L::ValueType>>(left, constant(right));
+        }
+
+        template <VectorExpression R>
+        constexpr auto operator+(const Vector2D<typename R::ValueType> &left, const R &right)
+        {
+            return Sum<Constant<typename R::ValueType>, R>(constant(left), right);
+        }
+
+        template <typename L, typename R>
+            requires CompatibleExpressions<L, R>
+        constexpr Difference<L, R> operator-(const L &left, const R &right)
+        {
+            return Difference<L, R>(left, right);
+        }
+
+        template <VectorExpression L>
+        constexpr auto operator-(const L &left, const Vector2D<typename L::ValueType> &right)
+        {
+            return Difference<L, Constant<typename L::ValueType>>(left, constant(right));
+        }
+
+        template <VectorExpression R>
+        constexpr auto operator-(const Vector2D<typename R::ValueType> &left, const R &right)
+        {
+            return Difference<Constant<typename R::ValueType>, R>(constant(left), right);
+        }
+
+        template <VectorExpression E>
+        constexpr Scaled<E> operator*(const E &operand, typename E::ValueType scalar)
+        {
+            return Scaled<E>(operand, scalar);
+        }
+
+        template <VectorExpression E>
+        constexpr Scaled<E> operator*(typename E::ValueType scalar, const E &operand)
+        {
+            return Scaled<E>(operand, scalar);
+        }
+
+        namespace detail
+        {
+            // Elements per block: the block loop has a constant trip count and
+            // writes a local buffer no input can alias, so it vectorizes without
+            // runtime overlap checks
+            inline constexpr size_t EVALUATE_BLOCK = 64;
+
+            template <typename E>
+            [[gnu::always_inline]] inline void evaluateBlocks(const E &expression,
+                                                              Vector2D<typename E::ValueType> *out, size_t n)
+            {
+                using T = typename E::ValueType;
+                Vector2D<T> block[EVALUATE_BLOCK];
+                size_t i = 0;
+                for (; i + EVALUATE_BLOCK <= n; i += EVALUATE_BLOCK)
+                {
+                    for (size_t j = 0; j < EVALUATE_BLOCK; ++j)
+                    {
+                        block[j] = expression[i + j];
+                    }
+                    std::memcpy(out + i, block, sizeof(block));
+                }
+                for (; i < n; ++i)
+                {
+                    out[i] = expression[i];
+                }
+            }
+
+            template <typename E>
+            void evaluateScalar(const E &expression, Vector2D<typename E::ValueType> *out, size_t n)
+            {
+                evaluateBlocks(expression, out, n);
+            }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTILS_EXPR_X86 1
+            // The same loop compiled for AVX2. AVX-512 implies FMA, which would
+            // contract a * s - c and stop matching the scalar operators, so
+            // AVX-512 machines run this loop too.
+            template <typename E>
+            __attribute__((target("avx2"))) void evaluateAvx2(const E &expression,
+                                                               Vector2D<typename E::ValueType> *out, size_t n)
+            {
+                evaluateBlocks(expression, out, n);
+            }
+#endif
+        } // namespace detail
+
+        /**
+         * Evaluates expression into out in a single pass over the common
+         * length of its views and out, using the instruction set selected by
+         * simd::activeInstructionSet(). out may be one of the viewed arrays
+         * (element i is read before it is written) but must not overlap one
+         * at an offset.
+         */
+        template <VectorExpression E>
+        void evaluate(const E &expression, std::span<Vector2D<typename E::ValueType>> out)
+        {
+            size_t n = std::min(expression.size(), out.size());
+#ifdef UTILS_EXPR_X86
+            switch (simd::activeInstructionSet())
+            {
+            case simd::InstructionSet::AVX512:
+            case simd::InstructionSet::AVX2:
+                detail::evaluateAvx2(expression, out.data(), n);
+                return;
+            default:
+                break;
+            }
+#endif
+            detail::evaluateScalar(expression, out.data(), n);
+        }
+
+        template <VectorExpression E>
+        void evaluate(const E &expression, std::vector<Vector2D<typename E::ValueType>> &out)
+        {
+            evaluate(expression, std::span<Vector2D<typename E::ValueType>>(out));
+        }
+
+    } // namespace expr
+} // namespace utils
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "utils/MathUtils.h"
+#include <span>
+
+namespace utils
+{
+    namespace simd
+    {
+
+        /**
+         * Instruction sets the batch kernels can dispatch to.
+         */
+        enum class InstructionSet
+        {
+            Scalar,
+            AVX2,
+            AVX512,
+            NEON
+        };
+
+        // Dispatch control
+        InstructionSet detectInstructionSet();
+        InstructionSet activeInstructionSet();
+        void forceInstructionSet(InstructionSet instructionSet);
+        const char *instructionSetName(InstructionSet instructionSet);
+
+        /**
+         * Batch Vector2D kernels over spans.
+         *
+         * Each kernel processes the common length of its spans and matches
+         * the results of the scalar Vector2D operators element for element.
+         * Output spans may alias the inputs.
+         */
+        void add(std::span<const Vec2f> a, std::span<const Vec2f> b, std::span<Vec2f> out);
+        void add(std::span<const Vec2d> a, std::span<const Vec2d> b, std::span<Vec2d> out);
+        void add(std::span<const Vec2i> a, std::span<const Vec2i> b, std::span<Vec2i> out);
+
+        void subtract(std::span<const Vec2f> a, std::span<const Vec2f> b, std::span<Vec2f> out);
+        void subtract(std::span<const Vec2d> a, std::span<const Vec2d> b, std::span<Vec2d> out);
+        void subtract(std::span<const Vec2i> a, std::span<const Vec2i> b, std::span<Vec2i> out);
+
+        void dot(std::span<const Vec2f> a, std::span<const Vec2f> b, std::span<float> out);
+        void dot(std::span<const Vec2d> a, std::span<const Vec2d> b, std::span<double> out);
+        void dot(std::span<const Vec2i> a, std::span<const Vec2i> b, std::span<int> out);
+
+        void magnitude(std::span<const Vec2f> vectors, std::span<float> out);
+        void magnitude(std::span<const Vec2d> vectors, std::span<double> out);
+        void magnitude(std::span<const Vec2i> vectors, std::span<int> out);
+
+        void normalize(std::span<Vec2f> vectors);
+        void normalize(std::span<Vec2d> vectors);
+        void normalize(std::span<Vec2i> vectors);
+
+        // out[i] = (points[i] - origin).dot(points[i] - origin); no sqrt, for ordering
+        void squaredDistances(const Vec2f &origin, std::span<const Vec2f> points, std::span<float> out);
+        void squaredDistances(const Vec2d &origin, std::span<const Vec2d> points, std::span<double> out);
+        void squaredDistances(const Vec2i &origin, std::span<const Vec2i> points, std::span<int> out);
+
+    } // namespace simd
+} // namespace utils
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "utils/MathUtils.h"
+#include "utils/QuantileSketch.h"
+#include "utils/StreamingStatistics.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utils
+{
+
+    /**
+     * Fixed ring of per-interval sub-aggregates: running moments plus a KLL
+     * sketch for each time interval.
+     *
+     * A sample lands in the bucket of the interval containing its timestamp;
+     * a bucket is recycled when a later interval maps onto it, so memory is
+     * bounded by the bucket count regardless of how many samples arrive.
+     * Samples older than the ring are rejected and counted.
+     */
+    class IntervalBuckets
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Bucket
+        {
+            int64_t interval; // index of the interval held, INT64_MIN when unused
+            RunningMoments moments;
+            KllSketch sketch;
+
+            explicit Bucket(size_t sketchK) : interval(UNUSED), sketch(sketchK) {}
+        };
+
+        IntervalBuckets(Clock::duration interval, size_t buckets, size_t sketchK);
+
+        // Data management (false if the sample is older than the ring behind
+        // the newest interval added; clear() also resets the rejected count)
+        bool add(double value, Clock::time_point time);
+        void clear();
+
+        // Calls fn(bucket, age) for each bucket still inside the ring at now;
+        // age counts whole intervals back from the one containing now
+        template <typename Fn>
+        void forEachLive(Clock::time_point now, Fn &&fn) const
+        {
+            int64_t current = intervalOf(now);
+            for (const Bucket &bucket : buckets_)
+            {
+                if (bucket.interval == UNUSED || bucket.interval > current)
+                    continue;
+                int64_t age = current - bucket.interval;
+                if (age < static_cast<int64_t>(buckets_.size()))
+                    fn(bucket, age);
+            }
+        }
+
+        // Accessors
+        Clock::duration getInterval() const { return interval_; }
+        size_t getBucketCount() const { return buckets_.size(); }
+        size_t getRejectedCount() const { return rejected_; }
+
+        // Constants
+        static constexpr int64_t UNUSED = INT64_MIN;
+
+    private:
+        Clock::duration interval_;
+        std::vector<Bucket> buckets_;
+        int64_t newest_ = UNUSED; // latest interval added to
+        size_t rejected_ = 0;
+
+        // Helper methods
+        int64_t intervalOf(Clock::time_point time) const;
+    };
+
+    /**
+     * Statistics over a sliding time window, e.g. "p99 over the last 60s".
+     *
+     * The window is split into equal intervals and the window edge advances
+     * one interval at a time. Mean, standard deviation, minimum, maximum and
+     * count are exact for the covered intervals and cost O(buckets). The
+     * median and percentiles invert the combined rank function of the
+     * buckets' KLL sketches by bisection, which avoids the extra error of
+     * compacting a merged sketch.
+     */
+    class SlidingWindowStatistics
+    {
+    public:
+        using Clock = IntervalBuckets::Clock;
+
+        explicit SlidingWindowStatistics(Clock::duration window, size_t buckets = DEFAULT_BUCKETS,
+                                         size_t sketchK = KllSketch::DEFAULT_K);
+
+        // Data management (timestamps default to Clock::now(); false if the
+        // sample is too old for any bucket)
+        bool addValue(double value) { return addValue(value, Clock::now()); }
+        bool addValue(double value, Clock::time_point time) { return buckets_.add(value, time); }
+        void clear() { buckets_.clear(); }
+
+        // Calculations (percentiles in [0, 100], as StatisticsCalculator)
+        Statistics calculate() const { return calculate(Clock::now()); }
+        Statistics calculate(Clock::time_point now) const;
+        double getPercentile(double percentile) const { return getPercentile(percentile, Clock::now()); }
+        double getPercentile(double percentile, Clock::time_point now) const;
+        std::vector<double> getPercentiles(const std::vector<double> &percentiles, Clock::time_point now) const;
+
+        // Accessors
+        size_t getCount(Clock::time_point now) const;
+        size_t getRejectedCount() const { return buckets_.getRejectedCount(); }
+        Clock::duration getWindow() const { return buckets_.getInterval() * buckets_.getBucketCount(); }
+
+        // Constants
+        static constexpr size_t DEFAULT_BUCKETS = 60;
+
+    private:
+        IntervalBuckets buckets_;
+    };
+
+    /**
+     * Exponentially time-decayed statistics: a sample's weight halves every
+     * halfLife, so recent behaviour dominates without a hard window edge.
+     *
+     * Weights are applied per interval bucket (HORIZON_HALF_LIVES half-lives
+     * are kept; older samples weigh under 1/256 and are dropped). Mean and
+     * standard deviation weight each bucket's moments, and percentiles
+     * invert the weighted mixture of the buckets' KLL rank functions; with
+     * equal weights all match SlidingWindowStatistics.
+     * Minimum, maximum and count cover all retained samples.
+     */
+    class DecayedStatistics
+    {
+    public:
+        using Clock = IntervalBuckets::Clock;
+
+        explicit DecayedStatistics(Clock::duration halfLife, size_t buckets = DEFAULT_BUCKETS,
+                                   size_t sketchK = KllSketch::DEFAULT_K);
+
+        // Data management (timestamps default to Clock::now(); false if the
+        // sample is too old for any bucket)
+        bool addValue(double value) { return addValue(value, Clock::now()); }
+        bool addValue(double value, Clock::time_point time) { return buckets_.add(value, time); }
+        void clear() { buckets_.clear(); }
+
+        // Calculations (percentiles in [0, 100], as StatisticsCalculator)
+        Statistics calculate() const { return calculate(Clock::now()); }
+        Statistics calculate(Clock::time_point now) const;
+        double getPercentile(double percentile) const { return getPercentile(percentile, Clock::now()); }
+        double getPercentile(double percentile, Clock::time_point now) const;
+
+        // Accessors
+        size_t getCount(Clock::time_point now) const;
+        double getWeightedCount(Clock::time_point now) const;
+        size_t getRejectedCount() const { return buckets_.getRejectedCount(); }
+        Clock::duration getHalfLife() const { return halfLife_; }
+
+        // Constants
+        static constexpr size_t DEFAULT_BUCKETS = 64;
+        static constexpr size_t HORIZON_HALF_LIVES = 8;
+
+    private:
+        IntervalBuckets buckets_;
+        Clock::duration halfLife_;
+
+        // Helper methods
+        double weightOf(int64_t age) const;
+    };
+
+} // namespace utils
@@ -1,50 +1,36 @@
+#include "geometry/AnyShape.h"
+#include "geometry/BvhIndex.h"
+#include "geometry/CollisionDetector.h"
+#include "geometry/ConcurrentShapeManager.h"
+#include "geometry/DrawSink.h"
+#include "geometry/PointIndex.h"
+#include "geometry/SceneFile.h"
+#include "geometry/ScenePipeline.h"
 #include "geometry/Shape.h"
+#include "geometry/ShapeArena.h"
+#include "geometry/ShapeIndex.h"
+#include "geometry/ShapeManager.h"
+#include "geometry/ShapeStore.h"
+#include "utils/DistanceMatrix.h"
+#include "utils/Histogram.h"
+#include "utils/Instrumentation.h"
 #include "utils/MathUtils.h"
+#include "utils/QuantileSketch.h"
+#include "utils/StatisticsSummary.h"
+#include "utils/StreamingStatistics.h"
+#include "utils/VectorExpression.h"
+#include "utils/VectorSimd.h"
+#include "utils/WindowedStatistics.h"
+#include <filesystem>
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <sstream>
+#include <thread>
 
 using namespace geometry;
 using namespace utils;
 
-/**
- * Demo application showing inheritance and polymorphism.
- */
-class ShapeManager
-{
-public:
-    ShapeManager() = default;
-    ~ShapeManager() = default;
-
-    void addShape(std::unique_ptr<Shape> shape)
-    {
-        shapes_.push_back(std::move(shape));
-    }
-
-    void drawAll() const
-    {
-        for (const auto &shape : shapes_)
-        {
-            shape->draw();
-        }
-    }
-
-    double calculateTotalArea() const
-    {
-        double total = 0.0;
-        for (const auto &shape : shapes_)
-        {
-            total += shape->area();
-        }
-        return total;
-    }
-
-    size_t getShapeCount() const { return shapes_.size(); }
-
-private:
-    std::vector<std::unique_ptr<Shape>> shapes_;
-};
-
 // Global utility functions
 double calculateDistance(const Vec2d &point1, const Vec2d &point2)
 {
@@ -62,6 +48,8 @@ void demonstrateVectorOperations()
     std::cout << "Vector 1: (" << v1.x << ", " << v1.y << ")\n";
     std::cout << "Vector 2: (" << v2.x << ", " << v2.y << ")\n";
     std::cout << "Magnitude of v1: " << v1.magnitude() << "\n";
+    std::cout << "Magnitude of v1 (fast, precise): " << v1.magnitude(precision::fast) << ", "
+              << v1.magnitude(precision::precise) << "\n";
     std::cout << "Distance between vectors: " << calculateDistance(v1, v2) << "\n";
 
     Vec2d sum = v1 + v2;
@@ -69,6 +57,269 @@ void demonstrateVectorOperations()
 
     double dot_product = v1.dot(v2);
     std::cout << "Dot product: " << dot_product << "\n";
+
+    std::vector<Vec2d> points = {v1, v2, sum};
+    std::vector<double> lengths(points.size());
+    simd::magnitude(points, lengths);
+    std::cout << "Batch magnitudes (" << simd::instructionSetName(simd::activeInstructionSet()) << "):";
+    for (double length : lengths)
+    {
+        std::cout << " " << length;
+    }
+    std::cout << "\n";
+
+    // Zero vectors normalize to zero, integer components included
+    std::vector<Vec2i> directions = {Vec2i(6, 0), Vec2i(0, 0), Vec2i(0, -7)};
+    simd::normalize(directions);
+    std::cout << "Batch normalized integers:";
+    for (const Vec2i &v : directions)
+    {
+        std::cout << " (" << v.x << ", " << v.y << ")";
+    }
+    std::cout << "\n";
+
+    // Whole-array formula in one pass, no temporaries
+    std::vector<Vec2d> offsets = {v2, v2, v2};
+    std::vector<Vec2d> moved(points.size());
+    expr::evaluate((expr::view(points) + expr::view(offsets)) * 0.5 - Vec2d(1.0, 1.0), moved);
+    std::cout << "(points + offsets) * 0.5 - (1, 1):";
+    for (const Vec2d &v : moved)
+    {
+        std::cout << " (" << v.x << ", " << v.y << ")";
+    }
+    std::cout << "\n";
+}
+
+void demonstrateShapeStore()
+{
+    std::cout << "\n=== Shape Store Demo ===\n";
+
+    ShapeStore store;
+    store.addRectangle(0, 0, 5, 3);
+    store.addCircle(10, 10, 2.5);
+    store.addRectangle(20, 20, 4, 4);
+
+    std::cout << "Stored shapes: " << store.getShapeCount() << "\n";
+    std::cout << "Total area: " << store.totalArea() << "\n";
+    std::cout << "Total perimeter: " << store.totalPerimeter() << "\n";
+    std::cout << "First circle area: " << store.circleAt(0).area() << "\n";
+
+    std::vector<Vec2d> velocities = {Vec2d(1, 0), Vec2d(0, 1), Vec2d(-1, -1)};
+    store.moveAll(velocities);
+    std::vector<double> areas(store.getShapeCount());
+    store.areas(areas);
+    std::cout << "Areas (rectangles, then circles):";
+    for (double area : areas)
+    {
+        std::cout << " " << area;
+    }
+    std::cout << "\nFirst circle after move: (" << store.circleAt(0).getX() << ", " << store.circleAt(0).getY()
+              << ")\n";
+
+    // Touching shapes collide; indices are in store order
+    store.addCircle(26, 22, 2);
+    CollisionDetector detector;
+    std::cout << "Colliding pairs:";
+    for (const CollisionPair &pair : detector.findCollisions(store))
+    {
+        std::cout << " (" << pair.first << ", " << pair.second << ")";
+    }
+    std::cout << "\n";
+}
+
+void demonstrateAnyShapeList()
+{
+    std::cout << "\n=== Variant Shape Demo ===\n";
+
+    AnyShapeList list;
+    list.emplace<Rectangle>(0, 0, 5, 3);
+    list.emplace<Circle>(10, 10, 2.5);
+    list.moveAll(1.0, 1.0);
+
+    list.drawAll();
+    std::cout << "Total area: " << list.totalArea() << "\n";
+    std::cout << "Total perimeter: " << list.totalPerimeter() << "\n";
+}
+
+void demonstrateSpatialIndex()
+{
+    std::cout << "\n=== Spatial Index Demo ===\n";
+
+    Rectangle rect(0, 0, 5, 3);
+    Circle circle(10, 10, 2.5);
+
+    ShapeIndex index(std::make_unique<BvhIndex>());
+    index.add(rect);
+    index.add(circle);
+
+    std::cout << "Shapes near (1, 1): " << index.query(BoundingBox(0, 0, 2, 2)).size() << "\n";
+    std::cout << "Nearest to (9, 9) has area " << index.nearest(9, 9).front()->area() << "\n";
+
+    circle.move(-10, -10);
+    std::cout << "Hits at (0, 0) after move: " << index.queryPoint(0, 0).size() << "\n";
+
+    // Many-to-many distances in tiles, and k nearest neighbours through the index
+    std::vector<Vec2d> sites = {Vec2d(0, 0), Vec2d(3, 4), Vec2d(10, 10), Vec2d(-2, 1)};
+    std::vector<Vec2d> probes = {Vec2d(1, 1), Vec2d(9, 8)};
+    std::vector<double> squared(probes.size() * sites.size());
+    DistanceMatrix::squared(probes, sites, squared);
+    std::cout << "Squared distances from (1, 1):";
+    for (size_t site = 0; site < sites.size(); ++site)
+    {
+        std::cout << " " << squared[site];
+    }
+    std::cout << "\n";
+
+    PointIndex points(std::make_unique<BvhIndex>());
+    points.add(sites);
+    std::vector<size_t> neighbours;
+    points.nearest(probes, 2, neighbours);
+    std::cout << "Two nearest sites to (9, 8): " << neighbours[2] << ", " << neighbours[3] << "\n";
+}
+
+void demonstrateShapeArena()
+{
+    std::cout << "\n=== Shape Arena Demo ===\n";
+
+    ShapeArena arena;
+    arena.create<Rectangle>(0, 0, 5, 3);
+    arena.create<Circle>(10, 10, 2.5);
+
+    double total = 0.0;
+    for (const Shape *shape : arena.getShapes())
+    {
+        total += shape->area();
+    }
+    std::cout << "Arena shapes: " << arena.getShapeCount() << ", total area: " << total << "\n";
+
+    arena.reset();
+    std::cout << "After reset: " << arena.getShapeCount() << " shapes\n";
+}
+
+void demonstrateConcurrentShapeManager()
+{
+    std::cout << "\n=== Concurrent Shape Manager Demo ===\n";
+
+    ConcurrentShapeManager manager;
+    std::vector<std::thread> loaders;
+    for (int loader = 0; loader < 4; ++loader)
+    {
+        loaders.emplace_back([&manager, loader]()
+                             {
+                                 for (int i = 0; i < 250; ++i)
+                                 {
+                                     manager.addShape(std::make_unique<Rectangle>(loader, i, 1, 2));
+                                 } });
+    }
+
+    // Readers see a consistent prefix while the loaders are still running
+    ConcurrentShapeManager::Snapshot partial = manager.snapshot();
+    double partialArea = partial.calculateTotalArea();
+    for (auto &loader : loaders)
+    {
+        loader.join();
+    }
+
+    std::cout << "Snapshot during loading is consistent: "
+              << (partialArea == 2.0 * partial.getShapeCount() ? "Yes" : "No") << "\n";
+    std::cout << "Loaded shapes: " << manager.getShapeCount() << ", total area: " << manager.calculateTotalArea()
+              << "\n";
+}
+
+void demonstrateScenePipeline()
+{
+    std::cout << "\n=== Scene Pipeline Demo ===\n";
+
+    // Ten batches of 100 shapes, each moved one unit right before it is drawn
+    size_t loadedBatches = 0;
+    auto loader = [&loadedBatches](ScenePipeline::Batch &batch)
+    {
+        if (loadedBatches == 10)
+            return false;
+        for (int i = 0; i < 100; ++i)
+        {
+            if (i % 2 == 0)
+                batch.push_back(std::make_unique<Rectangle>(i, loadedBatches, 2, 1));
+            else
+                batch.push_back(std::make_unique<Circle>(i, loadedBatches, 1));
+        }
+        ++loadedBatches;
+        return true;
+    };
+
+    NullDrawSink sink;
+    ShapeManager scene;
+    ScenePipeline pipeline;
+    pipeline.run(loader, [](Shape &shape)
+                 { shape.move(1, 0); },
+                 sink, scene);
+
+    Statistics areas = pipeline.getAreaStatistics().calculate();
+    std::cout << "Drawn batches: " << pipeline.getBatchCount() << ", commands: " << sink.getCommandCount()
+              << ", flushes: " << sink.getFlushCount() << "\n";
+    std::cout << "Scene shapes: " << scene.getShapeCount() << ", total area: " << scene.calculateTotalArea()
+              << ", mean area: " << areas.mean << "\n";
+}
+
+void demonstrateSceneFile()
+{
+    std::cout << "\n=== Scene File Demo ===\n";
+
+    ShapeStore store;
+    for (int i = 0; i < 100; ++i)
+    {
+        store.addRectangle(i, 0, 2, 1);
+        store.addCircle(i, 5, 0.5);
+    }
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string scenePath = (directory / "geometry_demo.scene").string();
+    std::string logPath = (directory / "geometry_demo.scenelog").string();
+    uint64_t generation = 0;
+    if (!SceneFile::write(store, scenePath, &generation))
+    {
+        std::cout << "Could not write " << scenePath << "\n";
+        return;
+    }
+
+    // Queries run straight off the mapping
+    MappedScene scene;
+    if (scene.open(scenePath))
+    {
+        const SceneView &view = scene.getView();
+        std::vector<size_t> hits;
+        view.query(BoundingBox(10, 0, 12, 5), hits);
+        std::cout << "Mapped shapes: " << view.getShapeCount() << ", total area: " << view.totalArea()
+                  << ", shapes in [10,12]x[0,5]: " << hits.size() << "\n";
+    }
+
+    // Edits go to the log; replay rebuilds the edited scene, compaction folds it into the file
+    std::filesystem::remove(logPath);
+    SceneLog log;
+    if (log.open(logPath, generation, store.getRectangleCount(), store.getCircleCount()))
+    {
+        log.addRectangle(200, 0, 10, 10);
+        log.moveCircle(0, 1, 1);
+        log.flush();
+
+        ShapeStore edited;
+        size_t applied = 0;
+        if (SceneFile::load(scenePath, edited, &generation) &&
+            SceneLog::replay(logPath, generation, edited, &applied))
+        {
+            std::cout << "Replayed edits: " << applied << ", total area: " << edited.totalArea() << "\n";
+            if (SceneFile::write(edited, scenePath, &generation) &&
+                log.reset(generation, edited.getRectangleCount(), edited.getCircleCount()))
+            {
+                std::cout << "Compacted to " << edited.getShapeCount() << " shapes\n";
+            }
+        }
+        log.close();
+    }
+
+    scene.close();
+    std::filesystem::remove(scenePath);
+    std::filesystem::remove(logPath);
 }
 
 void demonstrateStatistics()
@@ -89,6 +340,71 @@ void demonstrateStatistics()
 
     double percentile_75 = calc.getPercentile(75.0);
     std::cout << "75th percentile: " << percentile_75 << "\n";
+
+    StatisticsCalculator sketched;
+    sketched.setQuantileBackend(std::make_unique<KllSketch>());
+    sketched.addValues(data);
+    std::cout << "75th percentile (KLL sketch): " << sketched.getPercentile(75.0) << "\n";
+
+    calc.setIncrementalHistogram(Histogram::linear(0.0, 10.0, 5));
+    calc.addValue(9.5);
+    std::cout << "Incremental histogram:";
+    for (double count : calc.getHistogram())
+    {
+        std::cout << " " << count;
+    }
+    std::cout << "\n";
+
+    StatisticsCalculator viewed;
+    viewed.attachView(data);
+    std::cout << "90th percentile (zero-copy view): " << viewed.getPercentile(90.0) << "\n";
+
+    // Integer microsecond latencies stay 4 bytes each; only the accumulators widen
+    IntStatisticsCalculator latencies;
+    latencies.addValues(std::vector<int>{120, 95, 310, 101, 99, 2400, 130});
+    std::cout << "Integer latencies: median " << latencies.calculate().median << "us, p90 "
+              << latencies.getPercentile(90.0) << "us\n";
+
+    StreamingStatistics streaming;
+    streaming.addValues(data);
+
+    Statistics streamed = streaming.calculate();
+    std::cout << "Streaming mean: " << streamed.mean << "\n";
+    std::cout << "Streaming median estimate: " << streamed.median << "\n";
+    std::cout << "Streaming standard deviation: " << streamed.standardDeviation << "\n";
+
+    // One sample per second for two minutes; the window only sees the last minute
+    SlidingWindowStatistics lastMinute(std::chrono::seconds(60));
+    DecayedStatistics decayed(std::chrono::seconds(10));
+    auto start = SlidingWindowStatistics::Clock::time_point();
+    for (int second = 0; second < 120; ++second)
+    {
+        double latency = (second < 60) ? 1.0 : 2.0 + (second % 10);
+        lastMinute.addValue(latency, start + std::chrono::seconds(second));
+        decayed.addValue(latency, start + std::chrono::seconds(second));
+    }
+    auto now = start + std::chrono::seconds(119);
+    std::cout << "Last 60s: " << lastMinute.getCount(now) << " samples, p99 " << lastMinute.getPercentile(99.0, now)
+              << ", mean " << lastMinute.calculate(now).mean << "\n";
+    std::cout << "Decayed mean (10s half-life): " << decayed.calculate(now).mean << "\n";
+
+    // A sample from before the window's oldest bucket is rejected, not silently lost
+    bool lateAccepted = lastMinute.addValue(5.0, start);
+    std::cout << "Late sample accepted: " << (lateAccepted ? "Yes" : "No") << ", rejected "
+              << lastMinute.getRejectedCount() << "\n";
+
+    // Each worker ships a compact summary; the aggregator merges without copying samples
+    StatisticsSummary firstWorker;
+    StatisticsSummary secondWorker;
+    firstWorker.setHistogram(Histogram::linear(0.0, 10.0, 5));
+    secondWorker.setHistogram(Histogram::linear(0.0, 10.0, 5));
+    calc.summarize(firstWorker);
+    sketched.summarize(secondWorker);
+    std::vector<uint8_t> wire = secondWorker.serialize();
+    StatisticsSummaryView received;
+    bool merged = received.parse(wire) && firstWorker.merge(received);
+    std::cout << "Merged summary from " << wire.size() << " bytes: " << (merged ? "Yes" : "No") << ", count "
+              << firstWorker.getCount() << ", mean " << firstWorker.calculate().mean << "\n";
 }
 
 int main()
@@ -108,6 +424,7 @@ int main()
     std::cout << "Square area: " << square->area() << "\n";
 
     // Add to manager
+    Circle *managedCircle = circle.get();
     manager.addShape(std::move(rect));
     manager.addShape(std::move(circle));
     manager.addShape(std::move(square));
@@ -115,9 +432,21 @@ int main()
     std::cout << "\nTotal shapes: " << manager.getShapeCount() << "\n";
     std::cout << "Total area: " << manager.calculateTotalArea() << "\n";
 
+    // Cached aggregates follow shape changes without rescanning
+    managedCircle->setRadius(1.0);
+    BoundingBox bounds = manager.getBounds();
+    std::cout << "After shrinking the circle: area " << manager.calculateTotalArea() << ", perimeter "
+              << manager.calculateTotalPerimeter() << ", bounds (" << bounds.minX << ", " << bounds.minY << ") - ("
+              << bounds.maxX << ", " << bounds.maxY << ")\n";
+
     std::cout << "\nDrawing all shapes:\n";
     manager.drawAll();
 
+    std::ostringstream encoded;
+    BinaryDrawSink binary(encoded);
+    manager.drawAll(binary);
+    std::cout << "Binary command stream: " << encoded.str().size() << " bytes\n";
+
     // Demonstrate math utilities
     std::cout << "\n=== Math Utilities Demo ===\n";
     double value = 15.7;
@@ -133,8 +462,21 @@ int main()
     // Demonstrate vector operations
     demonstrateVectorOperations();
 
+    // Demonstrate structure-of-arrays shape storage
+    demonstrateShapeStore();
+    demonstrateAnyShapeList();
+    demonstrateShapeArena();
+    demonstrateSpatialIndex();
+    demonstrateConcurrentShapeManager();
+    demonstrateScenePipeline();
+    demonstrateSceneFile();
+
     // Demonstrate statistics
     demonstrateStatistics();
 
+    // Metrics collected by the instrumented hot paths above
+    std::cout << "\n=== Instrumentation Snapshot ===\n";
+    std::cout << Instrumentation::exportPrometheus();
+
     return 0;
 }
@@ -0,0 +1,56 @@
+#include "geometry/AnyShape.h"
+#include "geometry/DrawSink.h"
+
+namespace geometry
+{
+
+    size_t AnyShapeList::add(const AnyShape &shape)
+    {
+        shapes_.push_back(shape);
+        return shapes_.size() - 1;
+    }
+
+    double AnyShapeList::totalArea() const
+    {
+        double total = 0.0;
+        for (const AnyShape &shape : shapes_)
+        {
+            total += area(shape);
+        }
+        return total;
+    }
+
+    double AnyShapeList::totalPerimeter() const
+    {
+        double total = 0.0;
+        for (const AnyShape &shape : shapes_)
+        {
+            total += perimeter(shape);
+        }
+        return total;
+    }
+
+    void AnyShapeList::drawAll() const
+    {
+        TextDrawSink sink(std::cout);
+        drawAll(sink);
+    }
+
+    void AnyShapeList::drawAll(DrawSink &sink) const
+    {
+        for (const AnyShape &shape : shapes_)
+        {
+            draw(shape, sink);
+        }
+        sink.flush();
+    }
+
+    void AnyShapeList::moveAll(double dx, double dy)
+    {
+        for (AnyShape &shape : shapes_)
+        {
+            std::visit([dx, dy](auto &s) { s.move(dx, dy); }, shape);
+        }
+    }
+
+} // namespace geometry
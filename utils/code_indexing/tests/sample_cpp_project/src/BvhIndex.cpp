@@ -0,0 +1,328 @@
+#include "geometry/BvhIndex.h"
+#include <algorithm>
+#include <queue>
+
+namespace geometry
+{
+
+    BvhIndex::BvhIndex(double marginRatio)
+        : marginRatio_((marginRatio > 0.0) ? marginRatio : 0.0), root_(NONE), count_(0)
+    {
+    }
+
+    size_t BvhIndex::insert(const BoundingBox &box)
+    {
+        size_t id;
+        if (!freeIds_.empty())
+        {
+            id = freeIds_.back();
+            freeIds_.pop_back();
+        }
+        else
+        {
+            id = boxes_.size();
+            boxes_.emplace_back();
+            leaves_.push_back(NONE);
+        }
+
+        int leaf = allocateNode();
+        nodes_[leaf].box = padded(box);
+        nodes_[leaf].id = id;
+        insertLeaf(leaf);
+
+        boxes_[id] = box;
+        leaves_[id] = leaf;
+        ++count_;
+        return id;
+    }
+
+    void BvhIndex::update(size_t id, const BoundingBox &box)
+    {
+        int leaf = leaves_[id];
+        if (leaf == NONE)
+            return;
+
+        boxes_[id] = box;
+        if (nodes_[leaf].box.contains(box))
+            return;
+
+        removeLeaf(leaf);
+        nodes_[leaf].box = padded(box);
+        insertLeaf(leaf);
+    }
+
+    void BvhIndex::remove(size_t id)
+    {
+        int leaf = leaves_[id];
+        if (leaf == NONE)
+            return;
+
+        removeLeaf(leaf);
+        releaseNode(leaf);
+        leaves_[id] = NONE;
+        freeIds_.push_back(id);
+        --count_;
+    }
+
+    void BvhIndex::clear()
+    {
+        nodes_.clear();
+        freeNodes_.clear();
+        root_ = NONE;
+        boxes_.clear();
+        leaves_.clear();
+        freeIds_.clear();
+        count_ = 0;
+    }
+
+    void BvhIndex::query(const BoundingBox &region, std::vector<size_t> &out) const
+    {
+        if (root_ == NONE)
+            return;
+
+        std::vector<int> stack{root_};
+        while (!stack.empty())
+        {
+            const Node &node = nodes_[stack.back()];
+            stack.pop_back();
+            if (!node.box.intersects(region))
+                continue;
+
+            if (node.isLeaf())
+            {
+                if (boxes_[node.id].intersects(region))
+                    out.push_back(node.id);
+            }
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+    void BvhIndex::nearest(double x, double y, size_t k, std::vector<size_t> &out,
+                           const DistanceFunction &distance) const
+    {
+        if (k == 0 || root_ == NONE)
+            return;
+
+        // Best-first search; a popped leaf with its exact distance is final
+        struct Candidate
+        {
+            double distance;
+            int node;
+            bool exact;
+
+            bool operator>(const Candidate &other) const { return distance > other.distance; }
+        };
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> frontier;
+        frontier.push({nodes_[root_].box.distanceTo(x, y), root_, false});
+
+        size_t found = 0;
+        while (!frontier.empty() && found < k)
+        {
+            Candidate candidate = frontier.top();
+            frontier.pop();
+
+            const Node &node = nodes_[candidate.node];
+            if (candidate.exact)
+            {
+                out.push_back(node.id);
+                ++found;
+            }
+            else if (node.isLeaf())
+            {
+                double d = distance ? distance(node.id) : boxes_[node.id].distanceTo(x, y);
+                frontier.push({d, candidate.node, true});
+            }
+            else
+            {
+                frontier.push({nodes_[node.left].box.distanceTo(x, y), node.left, false});
+                frontier.push({nodes_[node.right].box.distanceTo(x, y), node.right, false});
+            }
+        }
+    }
+
+    int BvhIndex::allocateNode()
+    {
+        int node;
+        if (!freeNodes_.empty())
+        {
+            node = freeNodes_.back();
+            freeNodes_.pop_back();
+        }
+        else
+        {
+            node = static_cast<int>(nodes_.size());
+            nodes_.emplace_back();
+        }
+
+        nodes_[node] = Node{BoundingBox(), NONE, NONE, NONE, 0, 0};
+        return node;
+    }
+
+    void BvhIndex::releaseNode(int node)
+    {
+        freeNodes_.push_back(node);
+    }
+
+    BoundingBox BvhIndex::padded(const BoundingBox &box) const
+    {
+        return box.expanded(marginRatio_ * std::max(box.width(), box.height()));
+    }
+
+    void BvhIndex::insertLeaf(int leaf)
+    {
+        if (root_ == NONE)
+        {
+            root_ = leaf;
+            nodes_[leaf].parent = NONE;
+            return;
+        }
+
+        // Descend towards the sibling that least increases total perimeter
+        BoundingBox leafBox = nodes_[leaf].box;
+        int sibling = root_;
+        while (!nodes_[sibling].isLeaf())
+        {
+            const Node &node = nodes_[sibling];
+            double combined = node.box.merged(leafBox).perimeter();
+            double cost = 2.0 * combined;
+            double inheritance = 2.0 * (combined - node.box.perimeter());
+
+            auto descendCost = [&](int child)
+            {
+                const BoundingBox &box = nodes_[child].box;
+                double grown = box.merged(leafBox).perimeter();
+                return (nodes_[child].isLeaf() ? grown : grown - box.perimeter()) + inheritance;
+            };
+            double leftCost = descendCost(node.left);
+            double rightCost = descendCost(node.right);
+
+            if (cost < leftCost && cost < rightCost)
+                break;
+            sibling = (leftCost < rightCost) ? node.left : node.right;
+        }
+
+        int oldParent = nodes_[sibling].parent;
+        int parent = allocateNode();
+        nodes_[parent].parent = oldParent;
+        nodes_[parent].box = leafBox.merged(nodes_[sibling].box);
+        nodes_[parent].height = nodes_[sibling].height + 1;
+        nodes_[parent].left = sibling;
+        nodes_[parent].right = leaf;
+        nodes_[sibling].parent = parent;
+        nodes_[leaf].parent = parent;
+
+        if (oldParent == NONE)
+        {
+            root_ = parent;
+        }
+        else if (nodes_[oldParent].left == sibling)
+        {
+            nodes_[oldParent].left = parent;
+        }
+        else
+        {
+            nodes_[oldParent].right = parent;
+        }
+
+        refitFrom(oldParent);
+    }
+
+    void BvhIndex::removeLeaf(int leaf)
+    {
+        if (leaf == root_)
+        {
+            root_ = NONE;
+            return;
+        }
+
+        int parent = nodes_[leaf].parent;
+        int grandParent = nodes_[parent].parent;
+        int sibling = (nodes_[parent].left == leaf) ? nodes_[parent].right : nodes_[parent].left;
+
+        if (grandParent == NONE)
+        {
+            root_ = sibling;
+            nodes_[sibling].parent = NONE;
+            releaseNode(parent);
+            return;
+        }
+
+        if (nodes_[grandParent].left == parent)
+            nodes_[grandParent].left = sibling;
+        else
+            nodes_[grandParent].right = sibling;
+        nodes_[sibling].parent = grandParent;
+        releaseNode(parent);
+
+        refitFrom(grandParent);
+    }
+
+    void BvhIndex::refitFrom(int node)
+    {
+        while (node != NONE)
+        {
+            node = balance(node);
+
+            Node &current = nodes_[node];
+            const Node &left = nodes_[current.left];
+            const Node &right = nodes_[current.right];
+            current.height = 1 + std::max(left.height, right.height);
+            current.box = left.box.merged(right.box);
+
+            node = current.parent;
+        }
+    }
+
+    int BvhIndex::balance(int a)
+    {
+        // Rotates the taller grandchild up when the subtrees differ by more than one
+        Node &nodeA = nodes_[a];
+        if (nodeA.isLeaf() || nodeA.height < 2)
+            return a;
+
+        int b = nodeA.left;
+        int c = nodeA.right;
+        int difference = nodes_[c].height - nodes_[b].height;
+        if (difference >= -1 && difference <= 1)
+            return a;
+
+        // Promote the taller child (up) over a; its shorter child (down) moves to a
+        bool promoteRight = difference > 1;
+        int up = promoteRight ? c : b;
+        int other = promoteRight ? b : c;
+        Node &nodeUp = nodes_[up];
+        int f = nodeUp.left;
+        int g = nodeUp.right;
+
+        nodeUp.left = a;
+        nodeUp.parent = nodeA.parent;
+        nodeA.parent = up;
+
+        if (nodeUp.parent == NONE)
+            root_ = up;
+        else if (nodes_[nodeUp.parent].left == a)
+            nodes_[nodeUp.parent].left = up;
+        else
+            nodes_[nodeUp.parent].right = up;
+
+        int keep = (nodes_[f].height > nodes_[g].height) ? f : g;
+        int down = (keep == f) ? g : f;
+        nodeUp.right = keep;
+        if (promoteRight)
+            nodeA.right = down;
+        else
+            nodeA.left = down;
+        nodes_[down].parent = a;
+
+        nodeA.box = nodes_[other].box.merged(nodes_[down].box);
+        nodeA.height = 1 + std::max(nodes_[other].height, nodes_[down].height);
+        nodeUp.box = nodeA.box.merged(nodes_[keep].box);
+        nodeUp.height = 1 + std::max(nodeA.height, nodes_[keep].height);
+        return up;
+    }
+
+} // namespace geometry
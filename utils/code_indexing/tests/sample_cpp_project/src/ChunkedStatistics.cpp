@@ -0,0 +1,257 @@
+#include "utils/ChunkedStatistics.h"
+#include "utils/MathUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+
+    namespace
+    {
+        constexpr size_t DIGIT_COUNT = size_t{1} << ChunkedStatistics::DIGIT_BITS;
+        constexpr unsigned PASSES = 64 / ChunkedStatistics::DIGIT_BITS;
+
+        struct RankTarget
+        {
+            uint64_t remaining; // rank within the samples sharing prefix
+            uint64_t prefix;    // key digits resolved so far
+        };
+
+        double percentileIndex(double percentile, size_t size)
+        {
+            return MathUtils::clamp(percentile, 0.0, 100.0) * (size - 1) / 100.0;
+        }
+
+        // Radix select for all targets at once; fills moments during the first pass if requested
+        bool radixSelect(const SampleSource &source, std::vector<RankTarget> &targets, SampleMoments *moments)
+        {
+            std::vector<uint64_t> prefixes;
+            std::vector<uint64_t> counts;
+
+            for (unsigned pass = 0; pass < PASSES; ++pass)
+            {
+                unsigned shift = 64 - ChunkedStatistics::DIGIT_BITS * (pass + 1);
+
+                prefixes.clear();
+                for (const RankTarget &target : targets)
+                {
+                    prefixes.push_back(target.prefix);
+                }
+                std::sort(prefixes.begin(), prefixes.end());
+                prefixes.erase(std::unique(prefixes.begin(), prefixes.end()), prefixes.end());
+                counts.assign(prefixes.size() * DIGIT_COUNT, 0);
+
+                bool ok = source.forEachChunk([&](std::span<const double> chunk)
+                {
+                    if (pass == 0)
+                    {
+                        if (moments)
+                            moments->merge(ExactStatistics::computeMoments(chunk));
+                        for (double value : chunk)
+                        {
+                            ++counts[ChunkedStatistics::orderedKey(value) >> shift];
+                        }
+                        return;
+                    }
+
+                    for (double value : chunk)
+                    {
+                        uint64_t key = ChunkedStatistics::orderedKey(value);
+                        uint64_t high = key >> (shift + ChunkedStatistics::DIGIT_BITS);
+                        auto match = std::lower_bound(prefixes.begin(), prefixes.end(), high);
+                        if (match != prefixes.end() && *match == high)
+                        {
+                            size_t group = static_cast<size_t>(match - prefixes.begin());
+                            ++counts[group * DIGIT_COUNT + ((key >> shift) & (DIGIT_COUNT - 1))];
+                        }
+                    }
+                });
+                if (!ok)
+                {
+                    return false;
+                }
+
+                for (RankTarget &target : targets)
+                {
+                    size_t group = static_cast<size_t>(
+                        std::lower_bound(prefixes.begin(), prefixes.end(), target.prefix) - prefixes.begin());
+                    const uint64_t *digits = counts.data() + group * DIGIT_COUNT;
+
+                    size_t digit = 0;
+                    while (digit + 1 < DIGIT_COUNT && target.remaining >= digits[digit])
+                    {
+                        target.remaining -= digits[digit];
+                        ++digit;
+                    }
+                    target.prefix = (target.prefix << ChunkedStatistics::DIGIT_BITS) | digit;
+                }
+            }
+            return true;
+        }
+
+        // Ranks needed for the median and percentiles of size samples
+        std::vector<size_t> summaryRanks(size_t size, std::span<const double> percentiles)
+        {
+            std::vector<size_t> ranks;
+            if (size % 2 == 0)
+            {
+                ranks.push_back(size / 2 - 1);
+            }
+            ranks.push_back(size / 2);
+            for (double percentile : percentiles)
+            {
+                double index = percentileIndex(percentile, size);
+                ranks.push_back(static_cast<size_t>(std::floor(index)));
+                ranks.push_back(static_cast<size_t>(std::ceil(index)));
+            }
+            std::sort(ranks.begin(), ranks.end());
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+            return ranks;
+        }
+
+        // Value at a rank from the sorted ranks list and their selected values
+        double valueAtRank(const std::vector<size_t> &ranks, const std::vector<double> &values, size_t rank)
+        {
+            return values[std::lower_bound(ranks.begin(), ranks.end(), rank) - ranks.begin()];
+        }
+
+        double interpolate(const std::vector<size_t> &ranks, const std::vector<double> &values,
+                           double percentile, size_t size)
+        {
+            double index = percentileIndex(percentile, size);
+            size_t lower = static_cast<size_t>(std::floor(index));
+            size_t upper = static_cast<size_t>(std::ceil(index));
+
+            if (lower == upper)
+            {
+                return valueAtRank(ranks, values, lower);
+            }
+
+            double weight = index - lower;
+            return valueAtRank(ranks, values, lower) * (1.0 - weight) + valueAtRank(ranks, values, upper) * weight;
+        }
+
+        bool selectWithMoments(const SampleSource &source, std::span<const size_t> ranks, std::span<double> out,
+                               SampleMoments *moments)
+        {
+            size_t size = source.getCount();
+            std::vector<RankTarget> targets;
+            targets.reserve(ranks.size());
+            for (size_t rank : ranks)
+            {
+                targets.push_back(RankTarget{std::min(rank, size - 1), 0});
+            }
+
+            if (!radixSelect(source, targets, moments))
+            {
+                return false;
+            }
+            for (size_t i = 0; i < targets.size(); ++i)
+            {
+                out[i] = ChunkedStatistics::fromOrderedKey(targets[i].prefix);
+            }
+            return true;
+        }
+    }
+
+    bool ChunkedStatistics::computeMoments(const SampleSource &source, SampleMoments &moments)
+    {
+        moments = SampleMoments();
+        return source.forEachChunk([&moments](std::span<const double> chunk)
+                                   { moments.merge(ExactStatistics::computeMoments(chunk)); });
+    }
+
+    bool ChunkedStatistics::selectRanks(const SampleSource &source, std::span<const size_t> ranks,
+                                        std::span<double> out)
+    {
+        if (source.isEmpty())
+        {
+            std::fill(out.begin(), out.end(), 0.0);
+            return true;
+        }
+        return selectWithMoments(source, ranks, out, nullptr);
+    }
+
+    bool ChunkedStatistics::selectPercentiles(const SampleSource &source, std::span<const double> percentiles,
+                                              std::span<double> out)
+    {
+        Statistics stats;
+        return summarize(source, percentiles, out, stats);
+    }
+
+    bool ChunkedStatistics::summarize(const SampleSource &source, Statistics &stats)
+    {
+        return summarize(source, std::span<const double>(), std::span<double>(), stats);
+    }
+
+    bool ChunkedStatistics::summarize(const SampleSource &source, std::span<const double> percentiles,
+                                      std::span<double> out, Statistics &stats)
+    {
+        stats = Statistics();
+        std::fill(out.begin(), out.end(), 0.0);
+
+        size_t size = source.getCount();
+        if (size == 0)
+        {
+            return true;
+        }
+
+        std::vector<size_t> ranks = summaryRanks(size, percentiles);
+        std::vector<double> values(ranks.size());
+        SampleMoments moments;
+        if (!selectWithMoments(source, ranks, values, &moments))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < percentiles.size() && i < out.size(); ++i)
+        {
+            out[i] = interpolate(ranks, values, percentiles[i], size);
+        }
+
+        stats.count = moments.count;
+        stats.mean = moments.mean;
+        stats.median = (size % 2 == 0)
+                           ? (valueAtRank(ranks, values, size / 2 - 1) + valueAtRank(ranks, values, size / 2)) / 2.0
+                           : valueAtRank(ranks, values, size / 2);
+        stats.standardDeviation = std::sqrt(moments.variance());
+        stats.minimum = moments.minimum;
+        stats.maximum = moments.maximum;
+        return true;
+    }
+
+    bool ChunkedStatistics::histogram(const SampleSource &source, size_t bins, std::vector<double> &out)
+    {
+        out.assign(bins, 0.0);
+        if (source.isEmpty() || bins == 0)
+        {
+            return true;
+        }
+
+        SampleMoments moments;
+        if (!computeMoments(source, moments))
+        {
+            return false;
+        }
+
+        double minimum = moments.minimum;
+        double range = moments.maximum - minimum;
+        if (range == 0.0)
+        {
+            out[0] = static_cast<double>(moments.count);
+            return true;
+        }
+
+        return source.forEachChunk([&](std::span<const double> chunk)
+        {
+            for (double value : chunk)
+            {
+                size_t bin = static_cast<size_t>((value - minimum) / range * bins);
+                if (bin >= bins)
+                    bin = bins - 1;
+                out[bin] += 1.0;
+            }
+        });
+    }
+
+} // namespace utils
@@ -0,0 +1,484 @@
+#include "geometry/CollisionDetector.h"
+#include "geometry/Intersection.h"
+#include "utils/Parallel.h"
+#include "utils/VectorSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEOMETRY_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace geometry
+{
+
+    namespace
+    {
+
+        // Narrow-phase kernels: hit[i] = 1 if pair i overlaps, else 0
+        using CircleCircleKernel = void (*)(const double *, const double *, const double *, const double *,
+                                            const double *, const double *, uint8_t *, size_t);
+        using CircleBoxKernel = void (*)(const double *, const double *, const double *, const double *,
+                                         const double *, const double *, const double *, uint8_t *, size_t);
+
+        // Scalar kernels built on Intersection
+        void circleCircleScalar(const double *ax, const double *ay, const double *ar, const double *bx,
+                                const double *by, const double *br, uint8_t *hit, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                hit[i] = Intersection::circleCircle(ax[i], ay[i], ar[i], bx[i], by[i], br[i]);
+        }
+
+        void circleBoxScalar(const double *x, const double *y, const double *r, const double *minX,
+                             const double *minY, const double *maxX, const double *maxY, uint8_t *hit, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                hit[i] = Intersection::circleBox(x[i], y[i], r[i], BoundingBox(minX[i], minY[i], maxX[i], maxY[i]));
+        }
+
+#ifdef GEOMETRY_SIMD_X86
+        // Spreads a comparison mask over one byte per lane
+        inline void storeHits(unsigned bits, int lanes, uint8_t *hit)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+                hit[lane] = static_cast<uint8_t>((bits >> lane) & 1);
+        }
+
+        // AVX2 kernels (four pairs per step; mul and add stay separate, as in the scalar tests)
+        __attribute__((target("avx2"))) void circleCircleAvx2(const double *ax, const double *ay, const double *ar,
+                                                              const double *bx, const double *by, const double *br,
+                                                              uint8_t *hit, size_t n)
+        {
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(ax + i), _mm256_loadu_pd(bx + i));
+                __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ay + i), _mm256_loadu_pd(by + i));
+                __m256d reach = _mm256_add_pd(_mm256_loadu_pd(ar + i), _mm256_loadu_pd(br + i));
+                __m256d distance = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+                __m256d overlap = _mm256_cmp_pd(distance, _mm256_mul_pd(reach, reach), _CMP_LE_OQ);
+                storeHits(_mm256_movemask_pd(overlap), 4, hit + i);
+            }
+            circleCircleScalar(ax + i, ay + i, ar + i, bx + i, by + i, br + i, hit + i, n - i);
+        }
+
+        __attribute__((target("avx2"))) void circleBoxAvx2(const double *x, const double *y, const double *r,
+                                                           const double *minX, const double *minY,
+                                                           const double *maxX, const double *maxY, uint8_t *hit,
+                                                           size_t n)
+        {
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                __m256d cx = _mm256_loadu_pd(x + i);
+                __m256d cy = _mm256_loadu_pd(y + i);
+                __m256d radius = _mm256_loadu_pd(r + i);
+                __m256d nearX = _mm256_max_pd(cx, _mm256_loadu_pd(minX + i));
+                nearX = _mm256_min_pd(nearX, _mm256_loadu_pd(maxX + i));
+                __m256d nearY = _mm256_max_pd(cy, _mm256_loadu_pd(minY + i));
+                nearY = _mm256_min_pd(nearY, _mm256_loadu_pd(maxY + i));
+                __m256d dx = _mm256_sub_pd(cx, nearX);
+                __m256d dy = _mm256_sub_pd(cy, nearY);
+                __m256d distance = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+                __m256d overlap = _mm256_cmp_pd(distance, _mm256_mul_pd(radius, radius), _CMP_LE_OQ);
+                storeHits(_mm256_movemask_pd(overlap), 4, hit + i);
+            }
+            circleBoxScalar(x + i, y + i, r + i, minX + i, minY + i, maxX + i, maxY + i, hit + i, n - i);
+        }
+
+        // AVX-512 kernels (eight pairs per step)
+#if defined(__GNUC__) && !defined(__clang__)
+            // GCC 12 headers trip -Wmaybe-uninitialized on _mm512_undefined_*()
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+        __attribute__((target("avx512f"))) void circleCircleAvx512(const double *ax, const double *ay,
+                                                                   const double *ar, const double *bx,
+                                                                   const double *by, const double *br, uint8_t *hit,
+                                                                   size_t n)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(ax + i), _mm512_loadu_pd(bx + i));
+                __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(ay + i), _mm512_loadu_pd(by + i));
+                __m512d reach = _mm512_add_pd(_mm512_loadu_pd(ar + i), _mm512_loadu_pd(br + i));
+                __m512d distance = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+                storeHits(_mm512_cmp_pd_mask(distance, _mm512_mul_pd(reach, reach), _CMP_LE_OQ), 8, hit + i);
+            }
+            circleCircleScalar(ax + i, ay + i, ar + i, bx + i, by + i, br + i, hit + i, n - i);
+        }
+
+        __attribute__((target("avx512f"))) void circleBoxAvx512(const double *x, const double *y, const double *r,
+                                                                const double *minX, const double *minY,
+                                                                const double *maxX, const double *maxY, uint8_t *hit,
+                                                                size_t n)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                __m512d cx = _mm512_loadu_pd(x + i);
+                __m512d cy = _mm512_loadu_pd(y + i);
+                __m512d radius = _mm512_loadu_pd(r + i);
+                __m512d nearX = _mm512_max_pd(cx, _mm512_loadu_pd(minX + i));
+                nearX = _mm512_min_pd(nearX, _mm512_loadu_pd(maxX + i));
+                __m512d nearY = _mm512_max_pd(cy, _mm512_loadu_pd(minY + i));
+                nearY = _mm512_min_pd(nearY, _mm512_loadu_pd(maxY + i));
+                __m512d dx = _mm512_sub_pd(cx, nearX);
+                __m512d dy = _mm512_sub_pd(cy, nearY);
+                __m512d distance = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+                storeHits(_mm512_cmp_pd_mask(distance, _mm512_mul_pd(radius, radius), _CMP_LE_OQ), 8, hit + i);
+            }
+            circleBoxScalar(x + i, y + i, r + i, minX + i, minY + i, maxX + i, maxY + i, hit + i, n - i);
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif // GEOMETRY_SIMD_X86
+
+        // Kernel selection follows the shared SIMD dispatch setting; NEON uses the
+        // scalar kernels, which the compiler vectorizes at higher optimization levels
+        CircleCircleKernel circleCircleKernel()
+        {
+#ifdef GEOMETRY_SIMD_X86
+            switch (utils::simd::activeInstructionSet())
+            {
+            case utils::simd::InstructionSet::AVX512:
+                return circleCircleAvx512;
+            case utils::simd::InstructionSet::AVX2:
+                return circleCircleAvx2;
+            default:
+                break;
+            }
+#endif
+            return circleCircleScalar;
+        }
+
+        CircleBoxKernel circleBoxKernel()
+        {
+#ifdef GEOMETRY_SIMD_X86
+            switch (utils::simd::activeInstructionSet())
+            {
+            case utils::simd::InstructionSet::AVX512:
+                return circleBoxAvx512;
+            case utils::simd::InstructionSet::AVX2:
+                return circleBoxAvx2;
+            default:
+                break;
+            }
+#endif
+            return circleBoxScalar;
+        }
+
+    } // namespace
+
+    void CollisionDetector::findCollisions(const ShapeStore &store, std::vector<CollisionPair> &out)
+    {
+        out.clear();
+        computeBounds(store);
+        sortByMinX();
+        buildBands();
+        sweep(store);
+
+        size_t hitCount = 0;
+        candidateCount_ = 0;
+        for (const RangeResult &range : ranges_)
+        {
+            hitCount += range.hits.size();
+            candidateCount_ += range.candidateCount;
+        }
+        out.reserve(hitCount);
+        for (const RangeResult &range : ranges_)
+        {
+            out.insert(out.end(), range.hits.begin(), range.hits.end());
+        }
+        std::sort(out.begin(), out.end());
+    }
+
+    std::vector<CollisionPair> CollisionDetector::findCollisions(const ShapeStore &store)
+    {
+        std::vector<CollisionPair> pairs;
+        findCollisions(store, pairs);
+        return pairs;
+    }
+
+    void CollisionDetector::computeBounds(const ShapeStore &store)
+    {
+        std::span<const double> rectX = store.getRectangleXColumn();
+        std::span<const double> rectY = store.getRectangleYColumn();
+        std::span<const double> rectWidth = store.getRectangleWidthColumn();
+        std::span<const double> rectHeight = store.getRectangleHeightColumn();
+        std::span<const double> circleX = store.getCircleXColumn();
+        std::span<const double> circleY = store.getCircleYColumn();
+        std::span<const double> circleRadius = store.getCircleRadiusColumn();
+
+        // Same arithmetic as Rectangle::bounds() and Circle::bounds()
+        size_t rectangleCount = rectX.size();
+        size_t count = store.getShapeCount();
+        minX_.resize(count);
+        minY_.resize(count);
+        maxX_.resize(count);
+        maxY_.resize(count);
+        for (size_t i = 0; i < rectangleCount; ++i)
+        {
+            minX_[i] = rectX[i];
+            minY_[i] = rectY[i];
+            maxX_[i] = rectX[i] + rectWidth[i];
+            maxY_[i] = rectY[i] + rectHeight[i];
+        }
+        for (size_t i = 0; i < circleX.size(); ++i)
+        {
+            minX_[rectangleCount + i] = circleX[i] - circleRadius[i];
+            minY_[rectangleCount + i] = circleY[i] - circleRadius[i];
+            maxX_[rectangleCount + i] = circleX[i] + circleRadius[i];
+            maxY_[rectangleCount + i] = circleY[i] + circleRadius[i];
+        }
+    }
+
+    void CollisionDetector::sortByMinX()
+    {
+        // Ties broken by index, so the order (and the output) is deterministic
+        auto before = [this](uint32_t a, uint32_t b)
+        {
+            return minX_[a] < minX_[b] || (minX_[a] == minX_[b] && a < b);
+        };
+
+        size_t count = minX_.size();
+        if (order_.size() != count)
+        {
+            order_.resize(count);
+            std::iota(order_.begin(), order_.end(), uint32_t{0});
+            std::sort(order_.begin(), order_.end(), before);
+        }
+        else
+        {
+            // Repair last tick's order; give up on it once shapes moved too far
+            size_t shiftsLeft = count * MAX_REPAIR_SHIFTS_PER_SHAPE;
+            for (size_t i = 1; i < count && shiftsLeft > 0; ++i)
+            {
+                uint32_t index = order_[i];
+                size_t slot = i;
+                for (; slot > 0 && shiftsLeft > 0 && before(index, order_[slot - 1]); --slot, --shiftsLeft)
+                {
+                    order_[slot] = order_[slot - 1];
+                }
+                order_[slot] = index;
+            }
+            if (shiftsLeft == 0)
+            {
+                std::sort(order_.begin(), order_.end(), before);
+            }
+        }
+    }
+
+    void CollisionDetector::buildBands()
+    {
+        size_t count = order_.size();
+        double lowest = std::numeric_limits<double>::infinity();
+        double highest = -std::numeric_limits<double>::infinity();
+        double totalHeight = 0.0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            lowest = std::min(lowest, minY_[i]);
+            highest = std::max(highest, maxY_[i]);
+            totalHeight += maxY_[i] - minY_[i];
+        }
+
+        // Bands a few boxes high: each box then meets few bands and few neighbours
+        double bandHeight = BAND_HEIGHT_FACTOR * totalHeight / static_cast<double>(std::max<size_t>(count, 1));
+        double bands = (highest - lowest) / bandHeight;
+        bandCount_ = 1;
+        if (bands > 1.0 && std::isfinite(bands))
+        {
+            bandCount_ = std::min(static_cast<size_t>(bands), std::max<size_t>(count / MIN_SHAPES_PER_BAND, 1));
+        }
+        bandOrigin_ = lowest;
+        bandScale_ = (bandCount_ > 1) ? static_cast<double>(bandCount_) / (highest - lowest) : 0.0;
+
+        // Counting sort of the x-sorted boxes into every band they overlap keeps
+        // each band sorted by minimum x
+        bandStart_.assign(bandCount_ + 1, 0);
+        for (uint32_t index : order_)
+        {
+            for (size_t band = bandOf(minY_[index]), last = bandOf(maxY_[index]); band <= last; ++band)
+            {
+                ++bandStart_[band + 1];
+            }
+        }
+        for (size_t band = 0; band < bandCount_; ++band)
+        {
+            bandStart_[band + 1] += bandStart_[band];
+        }
+
+        size_t entries = bandStart_[bandCount_];
+        sortedIndex_.resize(entries);
+        sortedMinX_.resize(entries);
+        sortedMinY_.resize(entries);
+        sortedMaxX_.resize(entries);
+        sortedMaxY_.resize(entries);
+        bandCursor_.assign(bandStart_.begin(), bandStart_.end() - 1);
+        for (uint32_t index : order_)
+        {
+            for (size_t band = bandOf(minY_[index]), last = bandOf(maxY_[index]); band <= last; ++band)
+            {
+                size_t slot = bandCursor_[band]++;
+                sortedIndex_[slot] = index;
+                sortedMinX_[slot] = minX_[index];
+                sortedMinY_[slot] = minY_[index];
+                sortedMaxX_[slot] = maxX_[index];
+                sortedMaxY_[slot] = maxY_[index];
+            }
+        }
+    }
+
+    size_t CollisionDetector::bandOf(double y) const
+    {
+        double band = (y - bandOrigin_) * bandScale_;
+        if (!(band > 0.0))
+            return 0;
+        return std::min(static_cast<size_t>(band), bandCount_ - 1);
+    }
+
+    void CollisionDetector::sweep(const ShapeStore &store)
+    {
+        size_t rangeCount = 1;
+        if (order_.size() >= MIN_PARALLEL_SHAPES)
+        {
+            rangeCount = std::min(utils::hardwareThreads() * SWEEPS_PER_THREAD, bandCount_);
+        }
+
+        ranges_.resize(rangeCount);
+        utils::parallelFor(rangeCount, 1, [&](size_t begin, size_t end)
+                           {
+                               for (size_t range = begin; range < end; ++range)
+                               {
+                                   sweepRange(store, bandCount_ * range / rangeCount,
+                                              bandCount_ * (range + 1) / rangeCount, ranges_[range]);
+                               }
+                           });
+    }
+
+    void CollisionDetector::sweepRange(const ShapeStore &store, size_t bandBegin, size_t bandEnd,
+                                       RangeResult &result) const
+    {
+        result.hits.clear();
+        result.circleCircle.clear();
+        result.circleRectangle.clear();
+
+        // Within a band, each box is paired with the later boxes that start before
+        // it ends in x. A pair sharing several bands is kept only in the band
+        // holding the lower edge of its y overlap.
+        size_t rectangleCount = store.getRectangleCount();
+        for (size_t band = bandBegin; band < bandEnd; ++band)
+        {
+            size_t end = bandStart_[band + 1];
+            for (size_t a = bandStart_[band]; a < end; ++a)
+            {
+                double maxX = sortedMaxX_[a];
+                double minY = sortedMinY_[a];
+                double maxY = sortedMaxY_[a];
+                for (size_t b = a + 1; b < end && sortedMinX_[b] <= maxX; ++b)
+                {
+                    if (sortedMinY_[b] > maxY || minY > sortedMaxY_[b])
+                        continue;
+                    if (bandCount_ > 1 && bandOf(std::max(minY, sortedMinY_[b])) != band)
+                        continue;
+
+                    uint32_t first = std::min(sortedIndex_[a], sortedIndex_[b]);
+                    uint32_t second = std::max(sortedIndex_[a], sortedIndex_[b]);
+                    CollisionPair pair = {first, second};
+                    if (second < rectangleCount)
+                        result.hits.push_back(pair);
+                    else if (first >= rectangleCount)
+                        result.circleCircle.push_back(pair);
+                    else
+                        result.circleRectangle.push_back(pair);
+                }
+            }
+        }
+
+        result.candidateCount = result.hits.size() + result.circleCircle.size() + result.circleRectangle.size();
+        resolveCircles(store, result);
+        resolveCircleRectangles(store, result);
+    }
+
+    void CollisionDetector::resolveCircles(const ShapeStore &store, RangeResult &result)
+    {
+        std::span<const double> circleX = store.getCircleXColumn();
+        std::span<const double> circleY = store.getCircleYColumn();
+        std::span<const double> circleRadius = store.getCircleRadiusColumn();
+        size_t rectangleCount = store.getRectangleCount();
+        CircleCircleKernel kernel = circleCircleKernel();
+
+        // Gather a block of candidates into columns, then test it in one kernel call
+        double ax[NARROW_BLOCK], ay[NARROW_BLOCK], ar[NARROW_BLOCK];
+        double bx[NARROW_BLOCK], by[NARROW_BLOCK], br[NARROW_BLOCK];
+        uint8_t hit[NARROW_BLOCK];
+        const std::vector<CollisionPair> &pairs = result.circleCircle;
+        for (size_t base = 0; base < pairs.size(); base += NARROW_BLOCK)
+        {
+            size_t block = std::min(NARROW_BLOCK, pairs.size() - base);
+            for (size_t k = 0; k < block; ++k)
+            {
+                size_t a = pairs[base + k].first - rectangleCount;
+                size_t b = pairs[base + k].second - rectangleCount;
+                ax[k] = circleX[a];
+                ay[k] = circleY[a];
+                ar[k] = circleRadius[a];
+                bx[k] = circleX[b];
+                by[k] = circleY[b];
+                br[k] = circleRadius[b];
+            }
+            kernel(ax, ay, ar, bx, by, br, hit, block);
+            for (size_t k = 0; k < block; ++k)
+            {
+                if (hit[k])
+                    result.hits.push_back(pairs[base + k]);
+            }
+        }
+    }
+
+    void CollisionDetector::resolveCircleRectangles(const ShapeStore &store, RangeResult &result)
+    {
+        std::span<const double> rectX = store.getRectangleXColumn();
+        std::span<const double> rectY = store.getRectangleYColumn();
+        std::span<const double> rectWidth = store.getRectangleWidthColumn();
+        std::span<const double> rectHeight = store.getRectangleHeightColumn();
+        std::span<const double> circleX = store.getCircleXColumn();
+        std::span<const double> circleY = store.getCircleYColumn();
+        std::span<const double> circleRadius = store.getCircleRadiusColumn();
+        size_t rectangleCount = store.getRectangleCount();
+        CircleBoxKernel kernel = circleBoxKernel();
+
+        double x[NARROW_BLOCK], y[NARROW_BLOCK], r[NARROW_BLOCK];
+        double minX[NARROW_BLOCK], minY[NARROW_BLOCK], maxX[NARROW_BLOCK], maxY[NARROW_BLOCK];
+        uint8_t hit[NARROW_BLOCK];
+        const std::vector<CollisionPair> &pairs = result.circleRectangle;
+        for (size_t base = 0; base < pairs.size(); base += NARROW_BLOCK)
+        {
+            size_t block = std::min(NARROW_BLOCK, pairs.size() - base);
+            for (size_t k = 0; k < block; ++k)
+            {
+                size_t rectangle = pairs[base + k].first;
+                size_t circle = pairs[base + k].second - rectangleCount;
+                x[k] = circleX[circle];
+                y[k] = circleY[circle];
+                r[k] = circleRadius[circle];
+                minX[k] = rectX[rectangle];
+                minY[k] = rectY[rectangle];
+                maxX[k] = rectX[rectangle] + rectWidth[rectangle];
+                maxY[k] = rectY[rectangle] + rectHeight[rectangle];
+            }
+            kernel(x, y, r, minX, minY, maxX, maxY, hit, block);
+            for (size_t k = 0; k < block; ++k)
+            {
+                if (hit[k])
+                    result.hits.push_back(pairs[base + k]);
+            }
+        }
+    }
+
+} // namespace geometry
@@ -0,0 +1,158 @@
+#include "geometry/ConcurrentShapeManager.h"
+#include "geometry/DrawSink.h"
+#include <bit>
+#include <iostream>
+
+namespace geometry
+{
+
+    // Snapshot implementation
+    void ConcurrentShapeManager::Snapshot::drawAll() const
+    {
+        TextDrawSink sink(std::cout);
+        drawAll(sink);
+    }
+
+    void ConcurrentShapeManager::Snapshot::drawAll(DrawSink &sink) const
+    {
+        forEach([&sink](const Shape &shape)
+                { shape.draw(sink); });
+        sink.flush();
+    }
+
+    double ConcurrentShapeManager::Snapshot::calculateTotalArea() const
+    {
+        double total = 0.0;
+        forEach([&total](const Shape &shape)
+                { total += shape.area(); });
+        return total;
+    }
+
+    const Shape &ConcurrentShapeManager::Snapshot::at(size_t index) const
+    {
+        return *manager_->slotAt(index).load(std::memory_order_acquire);
+    }
+
+    // ConcurrentShapeManager implementation
+    ConcurrentShapeManager::ConcurrentShapeManager() : reserved_(0), published_(0)
+    {
+        for (auto &segment : segments_)
+        {
+            segment.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentShapeManager::~ConcurrentShapeManager()
+    {
+        clear();
+        for (auto &segment : segments_)
+        {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    void ConcurrentShapeManager::addShape(std::unique_ptr<Shape> shape)
+    {
+        // A null slot reads as unpublished, so nullptr would stall every snapshot
+        if (!shape)
+            return;
+
+        size_t index = reserve(1);
+        slotAt(index).store(shape.release(), std::memory_order_release);
+    }
+
+    void ConcurrentShapeManager::addShapes(std::vector<std::unique_ptr<Shape>> shapes)
+    {
+        std::erase(shapes, nullptr);
+        if (shapes.empty())
+            return;
+
+        // One reservation for the whole batch keeps it contiguous
+        size_t first = reserve(shapes.size());
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            slotAt(first + i).store(shapes[i].release(), std::memory_order_release);
+        }
+    }
+
+    void ConcurrentShapeManager::clear()
+    {
+        size_t count = reserved_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i)
+        {
+            delete slotAt(i).exchange(nullptr, std::memory_order_relaxed);
+        }
+        reserved_.store(0, std::memory_order_relaxed);
+        published_.store(0, std::memory_order_relaxed);
+    }
+
+    ConcurrentShapeManager::Snapshot ConcurrentShapeManager::snapshot() const
+    {
+        // Extend the published prefix past every slot filled since the last snapshot
+        size_t published = published_.load(std::memory_order_acquire);
+        size_t reserved = reserved_.load(std::memory_order_relaxed);
+        size_t count = published;
+        while (count < reserved)
+        {
+            size_t segment, offset;
+            locate(count, segment, offset);
+            const Slot *slots = segments_[segment].load(std::memory_order_acquire);
+            if (!slots || !slots[offset].load(std::memory_order_acquire))
+                break;
+            ++count;
+        }
+
+        while (count > published &&
+               !published_.compare_exchange_weak(published, count, std::memory_order_acq_rel))
+        {
+        }
+        return Snapshot(this, std::max(count, published));
+    }
+
+    void ConcurrentShapeManager::locate(size_t index, size_t &segment, size_t &offset)
+    {
+        // Segment k starts at FIRST_SEGMENT_SIZE * (2^k - 1)
+        segment = static_cast<size_t>(std::bit_width(index / FIRST_SEGMENT_SIZE + 1)) - 1;
+        offset = index - FIRST_SEGMENT_SIZE * ((size_t{1} << segment) - 1);
+    }
+
+    ConcurrentShapeManager::Slot &ConcurrentShapeManager::slotAt(size_t index) const
+    {
+        size_t segment, offset;
+        locate(index, segment, offset);
+        return segments_[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    size_t ConcurrentShapeManager::reserve(size_t count)
+    {
+        // Segments are allocated before the slots are claimed, so a producer
+        // that throws (bad_alloc) owns no slot and cannot leave a hole that
+        // would stall every later snapshot; once claimed, publishing cannot fail
+        size_t first = reserved_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            size_t firstSegment, lastSegment, offset;
+            locate(first, firstSegment, offset);
+            locate(first + count - 1, lastSegment, offset);
+            for (size_t segment = firstSegment; segment <= lastSegment; ++segment)
+            {
+                allocateSegment(segment);
+            }
+            if (reserved_.compare_exchange_weak(first, first + count, std::memory_order_relaxed))
+                return first;
+        }
+    }
+
+    void ConcurrentShapeManager::allocateSegment(size_t segment)
+    {
+        Slot *slots = segments_[segment].load(std::memory_order_acquire);
+        if (!slots)
+        {
+            // Racing producers each allocate; the loser frees its copy
+            Slot *allocated = new Slot[segmentSize(segment)]();
+            if (!segments_[segment].compare_exchange_strong(slots, allocated, std::memory_order_acq_rel))
+                delete[] allocated;
+        }
+    }
+
+} // namespace geometry
@@ -0,0 +1,213 @@
+#include "utils/ConcurrentStatistics.h"
+#include "utils/ExactStatistics.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace utils
+{
+
+    // Writer implementation
+    void ConcurrentStatisticsCalculator::Writer::addValues(const std::vector<double> &values)
+    {
+        shard_->data.insert(shard_->data.end(), values.begin(), values.end());
+    }
+
+    // ConcurrentStatisticsCalculator implementation
+    ConcurrentStatisticsCalculator::ConcurrentStatisticsCalculator() : sortedCount_(0)
+    {
+    }
+
+    ConcurrentStatisticsCalculator::~ConcurrentStatisticsCalculator() = default;
+
+    ConcurrentStatisticsCalculator::Writer ConcurrentStatisticsCalculator::createWriter()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        shards_.push_back(std::make_unique<Shard>());
+        return Writer(shards_.back().get());
+    }
+
+    void ConcurrentStatisticsCalculator::clear()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        for (auto &shard : shards_)
+        {
+            shard->data.clear();
+        }
+        sorted_.clear();
+        sortedCount_ = 0;
+    }
+
+    Statistics ConcurrentStatisticsCalculator::calculate() const
+    {
+        std::vector<std::span<const double>> parts = chunks();
+        if (parts.empty())
+        {
+            return Statistics{};
+        }
+
+        // Per-chunk fused moments in parallel, then a Chan merge
+        std::vector<SampleMoments> partial(parts.size());
+        parallelFor(parts.size(), 1, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            partial[i] = ExactStatistics::computeMoments(parts[i]);
+                        } });
+
+        SampleMoments moments;
+        for (const SampleMoments &part : partial)
+        {
+            moments.merge(part);
+        }
+
+        Statistics stats;
+        stats.count = moments.count;
+        stats.mean = moments.mean;
+        stats.median = ExactStatistics::medianOfSorted(sortedSamples());
+        stats.standardDeviation = std::sqrt(moments.variance());
+        stats.minimum = moments.minimum;
+        stats.maximum = moments.maximum;
+        return stats;
+    }
+
+    double ConcurrentStatisticsCalculator::getPercentile(double percentile) const
+    {
+        return ExactStatistics::percentileOfSorted(sortedSamples(), percentile);
+    }
+
+    std::vector<double> ConcurrentStatisticsCalculator::getPercentiles(const std::vector<double> &percentiles) const
+    {
+        const std::vector<double> &sorted = sortedSamples();
+
+        std::vector<double> values(percentiles.size(), 0.0);
+        for (size_t i = 0; i < percentiles.size(); ++i)
+        {
+            values[i] = ExactStatistics::percentileOfSorted(sorted, percentiles[i]);
+        }
+        return values;
+    }
+
+    std::vector<double> ConcurrentStatisticsCalculator::getHistogram(size_t bins) const
+    {
+        std::vector<double> histogram(bins, 0.0);
+
+        std::vector<std::span<const double>> parts = chunks();
+        if (parts.empty() || bins == 0)
+        {
+            return histogram;
+        }
+
+        double min_val = parts[0][0];
+        double max_val = parts[0][0];
+        std::vector<double> partMin(parts.size()), partMax(parts.size());
+        parallelFor(parts.size(), 1, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            auto minmax = std::minmax_element(parts[i].begin(), parts[i].end());
+                            partMin[i] = *minmax.first;
+                            partMax[i] = *minmax.second;
+                        } });
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            min_val = std::min(min_val, partMin[i]);
+            max_val = std::max(max_val, partMax[i]);
+        }
+
+        double range = max_val - min_val;
+        if (range == 0.0)
+        {
+            histogram[0] = static_cast<double>(getCount());
+            return histogram;
+        }
+
+        // Same binning as StatisticsCalculator::getHistogram, one local histogram per chunk
+        std::vector<std::vector<double>> partial(parts.size());
+        parallelFor(parts.size(), 1, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            partial[i].assign(bins, 0.0);
+                            for (double value : parts[i])
+                            {
+                                size_t bin = static_cast<size_t>((value - min_val) / range * bins);
+                                if (bin >= bins)
+                                    bin = bins - 1;
+                                partial[i][bin] += 1.0;
+                            }
+                        } });
+
+        for (const auto &part : partial)
+        {
+            for (size_t bin = 0; bin < bins; ++bin)
+            {
+                histogram[bin] += part[bin];
+            }
+        }
+        return histogram;
+    }
+
+    size_t ConcurrentStatisticsCalculator::getCount() const
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        size_t count = 0;
+        for (const auto &shard : shards_)
+        {
+            count += shard->data.size();
+        }
+        return count;
+    }
+
+    size_t ConcurrentStatisticsCalculator::getShardCount() const
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        return shards_.size();
+    }
+
+    std::vector<std::span<const double>> ConcurrentStatisticsCalculator::chunks() const
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        std::vector<std::span<const double>> parts;
+        for (const auto &shard : shards_)
+        {
+            std::span<const double> data(shard->data);
+            for (size_t offset = 0; offset < data.size(); offset += CHUNK_SIZE)
+            {
+                parts.push_back(data.subspan(offset, std::min(CHUNK_SIZE, data.size() - offset)));
+            }
+        }
+        return parts;
+    }
+
+    const std::vector<double> &ConcurrentStatisticsCalculator::sortedSamples() const
+    {
+        // Shards only grow between clears, so an unchanged count means unchanged data
+        size_t count = getCount();
+        if (count == sortedCount_ && sorted_.size() == count)
+        {
+            return sorted_;
+        }
+
+        std::vector<std::span<const double>> parts = chunks();
+        std::vector<size_t> offsets(parts.size() + 1, 0);
+        for (size_t i = 0; i < parts.size(); ++i)
+        {
+            offsets[i + 1] = offsets[i] + parts[i].size();
+        }
+
+        sorted_.resize(count);
+        parallelFor(parts.size(), 1, [&](size_t begin, size_t end)
+                    {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            std::memcpy(sorted_.data() + offsets[i], parts[i].data(), parts[i].size() * sizeof(double));
+                        } });
+        parallelSort(sorted_.begin(), sorted_.end());
+
+        sortedCount_ = count;
+        return sorted_;
+    }
+
+} // namespace utils
@@ -0,0 +1,154 @@
+#include "utils/DistanceMatrix.h"
+#include "utils/Parallel.h"
+#include "utils/VectorSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace utils
+{
+    namespace
+    {
+        // Enough rows per worker that each one evaluates MIN_PARALLEL_PAIRS distances
+        size_t minParallelRows(size_t columns)
+        {
+            return std::max<size_t>(1, DistanceMatrix::MIN_PARALLEL_PAIRS / std::max<size_t>(columns, 1));
+        }
+
+        template <typename T>
+        bool squaredImpl(std::span<const Vector2D<T>> rows, std::span<const Vector2D<T>> columns, std::span<T> out)
+        {
+            size_t width = columns.size();
+            if (width != 0 && out.size() / width < rows.size())
+            {
+                return false;
+            }
+
+            // Each column tile stays in cache while every row of the range visits it
+            parallelFor(rows.size(), minParallelRows(width), [&](size_t begin, size_t end)
+                        {
+                            for (size_t tile = 0; tile < width; tile += DistanceMatrix::TILE_COLUMNS)
+                            {
+                                size_t count = std::min(DistanceMatrix::TILE_COLUMNS, width - tile);
+                                for (size_t row = begin; row < end; ++row)
+                                {
+                                    simd::squaredDistances(rows[row], columns.subspan(tile, count),
+                                                           out.subspan(row * width + tile, count));
+                                }
+                            } });
+            return true;
+        }
+
+        template <typename T>
+        bool euclideanImpl(std::span<const Vector2D<T>> rows, std::span<const Vector2D<T>> columns, std::span<T> out)
+        {
+            if (!squaredImpl(rows, columns, out))
+            {
+                return false;
+            }
+
+            size_t total = rows.size() * columns.size();
+            parallelFor(total, DistanceMatrix::MIN_PARALLEL_PAIRS, [&](size_t begin, size_t end)
+                        {
+                            for (size_t i = begin; i < end; ++i)
+                            {
+                                out[i] = std::sqrt(out[i]);
+                            } });
+            return true;
+        }
+
+        // Minimum over independent lanes, which the compiler keeps in vector registers
+        template <typename T>
+        T tileMinimum(const T *values, size_t n)
+        {
+            constexpr size_t LANES = 8;
+            T minimum[LANES];
+            std::fill(minimum, minimum + LANES, std::numeric_limits<T>::infinity());
+
+            size_t i = 0;
+            for (; i + LANES <= n; i += LANES)
+            {
+                for (size_t lane = 0; lane < LANES; ++lane)
+                {
+                    minimum[lane] = (values[i + lane] < minimum[lane]) ? values[i + lane] : minimum[lane];
+                }
+            }
+            for (; i < n; ++i)
+            {
+                minimum[0] = std::min(minimum[0], values[i]);
+            }
+            return *std::min_element(minimum, minimum + LANES);
+        }
+
+        template <typename T>
+        bool nearestImpl(std::span<const Vector2D<T>> queries, std::span<const Vector2D<T>> points,
+                         std::span<size_t> indices, std::span<T> squaredDistances)
+        {
+            if (points.empty() || indices.size() < queries.size() || squaredDistances.size() < queries.size())
+            {
+                return false;
+            }
+
+            parallelFor(queries.size(), minParallelRows(points.size()), [&](size_t begin, size_t end)
+                        {
+                            std::fill(squaredDistances.begin() + begin, squaredDistances.begin() + end,
+                                      std::numeric_limits<T>::infinity());
+                            std::fill(indices.begin() + begin, indices.begin() + end, size_t{0});
+
+                            T distances[DistanceMatrix::TILE_COLUMNS];
+                            for (size_t tile = 0; tile < points.size(); tile += DistanceMatrix::TILE_COLUMNS)
+                            {
+                                size_t count = std::min(DistanceMatrix::TILE_COLUMNS, points.size() - tile);
+                                for (size_t query = begin; query < end; ++query)
+                                {
+                                    simd::squaredDistances(queries[query], points.subspan(tile, count),
+                                                           std::span<T>(distances, count));
+
+                                    // Strict comparison and the first match keep the lowest index on ties
+                                    T best = tileMinimum(distances, count);
+                                    if (best < squaredDistances[query])
+                                    {
+                                        const T *position = std::find(distances, distances + count, best);
+                                        squaredDistances[query] = best;
+                                        indices[query] = tile + static_cast<size_t>(position - distances);
+                                    }
+                                }
+                            } });
+            return true;
+        }
+    } // namespace
+
+    bool DistanceMatrix::squared(std::span<const Vec2f> rows, std::span<const Vec2f> columns, std::span<float> out)
+    {
+        return squaredImpl(rows, columns, out);
+    }
+
+    bool DistanceMatrix::squared(std::span<const Vec2d> rows, std::span<const Vec2d> columns, std::span<double> out)
+    {
+        return squaredImpl(rows, columns, out);
+    }
+
+    bool DistanceMatrix::euclidean(std::span<const Vec2f> rows, std::span<const Vec2f> columns, std::span<float> out)
+    {
+        return euclideanImpl(rows, columns, out);
+    }
+
+    bool DistanceMatrix::euclidean(std::span<const Vec2d> rows, std::span<const Vec2d> columns,
+                                   std::span<double> out)
+    {
+        return euclideanImpl(rows, columns, out);
+    }
+
+    bool DistanceMatrix::nearest(std::span<const Vec2f> queries, std::span<const Vec2f> points,
+                                 std::span<size_t> indices, std::span<float> squaredDistances)
+    {
+        return nearestImpl(queries, points, indices, squaredDistances);
+    }
+
+    bool DistanceMatrix::nearest(std::span<const Vec2d> queries, std::span<const Vec2d> points,
+                                 std::span<size_t> indices, std::span<double> squaredDistances)
+    {
+        return nearestImpl(queries, points, indices, squaredDistances);
+    }
+
+} // namespace utils
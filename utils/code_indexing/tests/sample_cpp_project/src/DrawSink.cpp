@@ -0,0 +1,94 @@
+#include "geometry/DrawSink.h"
+#include <charconv>
+#include <cstring>
+
+namespace geometry
+{
+
+    // TextDrawSink implementation
+    TextDrawSink::TextDrawSink(std::ostream &out) : out_(out)
+    {
+    }
+
+    TextDrawSink::~TextDrawSink()
+    {
+        if (!buffer_.empty())
+            flush();
+    }
+
+    void TextDrawSink::drawRectangle(double x, double y, double width, double height)
+    {
+        buffer_ += "Drawing rectangle at (";
+        appendNumber(x);
+        buffer_ += ", ";
+        appendNumber(y);
+        buffer_ += ") with width ";
+        appendNumber(width);
+        buffer_ += " and height ";
+        appendNumber(height);
+        buffer_ += '\n';
+    }
+
+    void TextDrawSink::drawCircle(double x, double y, double radius)
+    {
+        buffer_ += "Drawing circle at (";
+        appendNumber(x);
+        buffer_ += ", ";
+        appendNumber(y);
+        buffer_ += ") with radius ";
+        appendNumber(radius);
+        buffer_ += '\n';
+    }
+
+    void TextDrawSink::flush()
+    {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        out_.flush();
+        buffer_.clear();
+    }
+
+    void TextDrawSink::appendNumber(double value)
+    {
+        // Same as printf("%g"), which is what a default-formatted ostream produces
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+        buffer_.append(digits, result.ptr);
+    }
+
+    // BinaryDrawSink implementation
+    BinaryDrawSink::BinaryDrawSink(std::ostream &out) : out_(out)
+    {
+    }
+
+    BinaryDrawSink::~BinaryDrawSink()
+    {
+        if (!buffer_.empty())
+            flush();
+    }
+
+    void BinaryDrawSink::drawRectangle(double x, double y, double width, double height)
+    {
+        append(Command::Rectangle, {x, y, width, height});
+    }
+
+    void BinaryDrawSink::drawCircle(double x, double y, double radius)
+    {
+        append(Command::Circle, {x, y, radius});
+    }
+
+    void BinaryDrawSink::flush()
+    {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        out_.flush();
+        buffer_.clear();
+    }
+
+    void BinaryDrawSink::append(Command command, std::initializer_list<double> operands)
+    {
+        size_t offset = buffer_.size();
+        buffer_.resize(offset + 1 + operands.size() * sizeof(double));
+        buffer_[offset] = static_cast<char>(command);
+        std::memcpy(buffer_.data() + offset + 1, operands.begin(), operands.size() * sizeof(double));
+    }
+
+} // namespace geometry
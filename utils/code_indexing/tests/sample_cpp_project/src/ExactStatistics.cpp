@@ -0,0 +1,325 @@
+#include "utils/ExactStatistics.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace utils
+{
+    namespace
+    {
+        // Moments of one cache-resident block, shifted by its first value
+        template <typename T, typename Accum>
+        SampleMoments blockMoments(const T *values, size_t n)
+        {
+            constexpr size_t LANES = 4;
+            const Accum shift = static_cast<Accum>(values[0]);
+
+            Accum sum[LANES] = {};
+            Accum sumSquares[LANES] = {};
+            T minimum[LANES] = {values[0], values[0], values[0], values[0]};
+            T maximum[LANES] = {values[0], values[0], values[0], values[0]};
+
+            size_t i = 0;
+            for (; i + LANES <= n; i += LANES)
+            {
+                for (size_t lane = 0; lane < LANES; ++lane)
+                {
+                    T value = values[i + lane];
+                    Accum diff = static_cast<Accum>(value) - shift;
+                    sum[lane] += diff;
+                    sumSquares[lane] += diff * diff;
+                    minimum[lane] = (value < minimum[lane]) ? value : minimum[lane];
+                    maximum[lane] = (value > maximum[lane]) ? value : maximum[lane];
+                }
+            }
+            for (; i < n; ++i)
+            {
+                Accum diff = static_cast<Accum>(values[i]) - shift;
+                sum[0] += diff;
+                sumSquares[0] += diff * diff;
+                minimum[0] = std::min(minimum[0], values[i]);
+                maximum[0] = std::max(maximum[0], values[i]);
+            }
+
+            Accum totalSum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+            Accum totalSquares = (sumSquares[0] + sumSquares[1]) + (sumSquares[2] + sumSquares[3]);
+
+            SampleMoments moments;
+            moments.count = n;
+            moments.mean = static_cast<double>(shift + totalSum / n);
+            moments.sumSquaredDiff = static_cast<double>(std::max(Accum(0), totalSquares - totalSum * totalSum / n));
+            moments.minimum = static_cast<double>(
+                std::min(std::min(minimum[0], minimum[1]), std::min(minimum[2], minimum[3])));
+            moments.maximum = static_cast<double>(
+                std::max(std::max(maximum[0], maximum[1]), std::max(maximum[2], maximum[3])));
+            return moments;
+        }
+
+        // Places every requested (sorted, unique) rank at its sorted position
+        template <typename T>
+        void multiSelect(T *data, size_t lo, size_t hi, const size_t *ranksBegin, const size_t *ranksEnd)
+        {
+            while (ranksBegin != ranksEnd && lo < hi)
+            {
+                const size_t *mid = ranksBegin + (ranksEnd - ranksBegin) / 2;
+                std::nth_element(data + lo, data + *mid, data + hi);
+
+                // Recurse into the smaller side, loop on the larger one
+                if (mid - ranksBegin < ranksEnd - (mid + 1))
+                {
+                    multiSelect(data, lo, *mid, ranksBegin, mid);
+                    lo = *mid + 1;
+                    ranksBegin = mid + 1;
+                }
+                else
+                {
+                    multiSelect(data, *mid + 1, hi, mid + 1, ranksEnd);
+                    hi = *mid;
+                    ranksEnd = mid;
+                }
+            }
+        }
+
+        // Interpolation index shared with StatisticsCalculator::getPercentile
+        double percentileIndex(double percentile, size_t size)
+        {
+            return MathUtils::clamp(percentile, 0.0, 100.0) * (size - 1) / 100.0;
+        }
+
+        void addPercentileRanks(std::vector<size_t> &ranks, double percentile, size_t size)
+        {
+            double index = percentileIndex(percentile, size);
+            ranks.push_back(static_cast<size_t>(std::floor(index)));
+            ranks.push_back(static_cast<size_t>(std::ceil(index)));
+        }
+
+        void addMedianRanks(std::vector<size_t> &ranks, size_t size)
+        {
+            if (size % 2 == 0)
+            {
+                ranks.push_back(size / 2 - 1);
+            }
+            ranks.push_back(size / 2);
+        }
+
+        template <typename T>
+        void selectRanks(std::span<T> values, std::vector<size_t> &ranks)
+        {
+            std::sort(ranks.begin(), ranks.end());
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+            multiSelect(values.data(), 0, values.size(), ranks.data(), ranks.data() + ranks.size());
+        }
+    } // namespace
+
+    // SampleMoments implementation
+    void SampleMoments::merge(const SampleMoments &other)
+    {
+        if (other.count == 0)
+        {
+            return;
+        }
+        if (count == 0)
+        {
+            *this = other;
+            return;
+        }
+
+        // Chan et al. pairwise combination
+        double total = static_cast<double>(count + other.count);
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        sumSquaredDiff += other.sumSquaredDiff + delta * delta * count * other.count / total;
+        minimum = std::min(minimum, other.minimum);
+        maximum = std::max(maximum, other.maximum);
+        count += other.count;
+    }
+
+    // ExactStatistics implementation
+    SampleMoments ExactStatistics::computeMoments(std::span<const double> values)
+    {
+        return computeMoments<double, double>(values);
+    }
+
+    template <typename T, typename Accum>
+    SampleMoments ExactStatistics::computeMoments(std::span<const T> values)
+    {
+        SampleMoments total;
+        for (size_t start = 0; start < values.size(); start += BLOCK_SIZE)
+        {
+            size_t n = std::min(BLOCK_SIZE, values.size() - start);
+            total.merge(blockMoments<T, Accum>(values.data() + start, n));
+        }
+        return total;
+    }
+
+    double ExactStatistics::selectMedian(std::span<double> values)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+
+        size_t size = values.size();
+        auto upper = values.begin() + size / 2;
+        std::nth_element(values.begin(), upper, values.end());
+        if (size % 2 != 0)
+        {
+            return *upper;
+        }
+
+        // The lower middle value is the largest of the left partition
+        double lower = *std::max_element(values.begin(), upper);
+        return (lower + *upper) / 2.0;
+    }
+
+    void ExactStatistics::selectPercentiles(std::span<double> values, std::span<const double> percentiles,
+                                            std::span<double> out)
+    {
+        selectPercentiles<double>(values, percentiles, out);
+    }
+
+    template <typename T>
+    void ExactStatistics::selectPercentiles(std::span<T> values, std::span<const double> percentiles,
+                                            std::span<double> out)
+    {
+        size_t count = std::min(percentiles.size(), out.size());
+        if (values.empty())
+        {
+            std::fill(out.begin(), out.begin() + count, 0.0);
+            return;
+        }
+
+        std::vector<size_t> ranks;
+        ranks.reserve(2 * count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            addPercentileRanks(ranks, percentiles[i], values.size());
+        }
+        selectRanks(values, ranks);
+
+        // Selected ranks now sit at their sorted positions
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = percentileOfSorted<T>(values, percentiles[i]);
+        }
+    }
+
+    double ExactStatistics::medianOfSorted(std::span<const double> sorted)
+    {
+        return medianOfSorted<double>(sorted);
+    }
+
+    template <typename T>
+    double ExactStatistics::medianOfSorted(std::span<const T> sorted)
+    {
+        size_t size = sorted.size();
+        if (size == 0)
+        {
+            return 0.0;
+        }
+        if (size % 2 == 0)
+        {
+            return (static_cast<double>(sorted[size / 2 - 1]) + static_cast<double>(sorted[size / 2])) / 2.0;
+        }
+        return static_cast<double>(sorted[size / 2]);
+    }
+
+    double ExactStatistics::percentileOfSorted(std::span<const double> sorted, double percentile)
+    {
+        return percentileOfSorted<double>(sorted, percentile);
+    }
+
+    template <typename T>
+    double ExactStatistics::percentileOfSorted(std::span<const T> sorted, double percentile)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+
+        double index = percentileIndex(percentile, sorted.size());
+        size_t lower = static_cast<size_t>(std::floor(index));
+        size_t upper = static_cast<size_t>(std::ceil(index));
+
+        if (lower == upper)
+        {
+            return static_cast<double>(sorted[lower]);
+        }
+
+        double weight = index - lower;
+        return static_cast<double>(sorted[lower]) * (1.0 - weight) + static_cast<double>(sorted[upper]) * weight;
+    }
+
+    Statistics ExactStatistics::summarize(std::span<double> values)
+    {
+        return summarize<double, double>(values, std::span<const double>(), std::span<double>());
+    }
+
+    Statistics ExactStatistics::summarize(std::span<double> values, std::span<const double> percentiles,
+                                          std::span<double> out)
+    {
+        return summarize<double, double>(values, percentiles, out);
+    }
+
+    template <typename T, typename Accum>
+    Statistics ExactStatistics::summarize(std::span<T> values, std::span<const double> percentiles,
+                                          std::span<double> out)
+    {
+        size_t count = std::min(percentiles.size(), out.size());
+        if (values.empty())
+        {
+            std::fill(out.begin(), out.begin() + count, 0.0);
+            return Statistics{};
+        }
+
+        SampleMoments moments = computeMoments<T, Accum>(values);
+
+        std::vector<size_t> ranks;
+        ranks.reserve(2 + 2 * count);
+        addMedianRanks(ranks, values.size());
+        for (size_t i = 0; i < count; ++i)
+        {
+            addPercentileRanks(ranks, percentiles[i], values.size());
+        }
+        selectRanks(values, ranks);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = percentileOfSorted<T>(values, percentiles[i]);
+        }
+
+        Statistics stats;
+        stats.count = moments.count;
+        stats.mean = moments.mean;
+        stats.median = medianOfSorted<T>(values);
+        stats.standardDeviation = std::sqrt(moments.variance());
+        stats.minimum = moments.minimum;
+        stats.maximum = moments.maximum;
+        return stats;
+    }
+
+    // Explicit template instantiations for the native sample types
+    template SampleMoments ExactStatistics::computeMoments<float, double>(std::span<const float>);
+    template void ExactStatistics::selectPercentiles<float>(std::span<float>, std::span<const double>,
+                                                            std::span<double>);
+    template double ExactStatistics::medianOfSorted<float>(std::span<const float>);
+    template double ExactStatistics::percentileOfSorted<float>(std::span<const float>, double);
+    template Statistics ExactStatistics::summarize<float, double>(std::span<float>, std::span<const double>,
+                                                                  std::span<double>);
+
+    template SampleMoments ExactStatistics::computeMoments<double, double>(std::span<const double>);
+    template void ExactStatistics::selectPercentiles<double>(std::span<double>, std::span<const double>,
+                                                             std::span<double>);
+    template double ExactStatistics::medianOfSorted<double>(std::span<const double>);
+    template double ExactStatistics::percentileOfSorted<double>(std::span<const double>, double);
+    template Statistics ExactStatistics::summarize<double, double>(std::span<double>, std::span<const double>,
+                                                                   std::span<double>);
+
+    template SampleMoments ExactStatistics::computeMoments<int, double>(std::span<const int>);
+    template void ExactStatistics::selectPercentiles<int>(std::span<int>, std::span<const double>, std::span<double>);
+    template double ExactStatistics::medianOfSorted<int>(std::span<const int>);
+    template double ExactStatistics::percentileOfSorted<int>(std::span<const int>, double);
+    template Statistics ExactStatistics::summarize<int, double>(std::span<int>, std::span<const double>,
+                                                                std::span<double>);
+
+} // namespace utils
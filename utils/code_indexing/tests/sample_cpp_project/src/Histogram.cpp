@@ -0,0 +1,178 @@
+#include "utils/Histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace utils
+{
+
+    Histogram::Histogram(Scale scale, double minimum, double maximum, size_t bins, unsigned subBucketBits)
+        : scale_(scale), minimum_(minimum), maximum_(maximum), subBucketBits_(subBucketBits),
+          scaleFactor_(0.0), counts_(bins, 0.0), underflow_(0.0), overflow_(0.0), total_(0.0)
+    {
+        switch (scale_)
+        {
+        case Scale::Linear:
+            scaleFactor_ = bins / (maximum_ - minimum_);
+            break;
+        case Scale::Logarithmic:
+            scaleFactor_ = bins / std::log(maximum_ / minimum_);
+            break;
+        case Scale::LogLinear:
+            scaleFactor_ = static_cast<double>(size_t{1} << subBucketBits_);
+            break;
+        }
+    }
+
+    Histogram Histogram::linear(double minimum, double maximum, size_t bins)
+    {
+        if (!(maximum > minimum))
+            maximum = minimum + 1.0;
+        return Histogram(Scale::Linear, minimum, maximum, std::max<size_t>(bins, 1), 0);
+    }
+
+    Histogram Histogram::logarithmic(double minimum, double maximum, size_t bins)
+    {
+        if (!(minimum > 0.0))
+            minimum = std::numeric_limits<double>::min();
+        if (!(maximum > minimum))
+            maximum = minimum * 2.0;
+        return Histogram(Scale::Logarithmic, minimum, maximum, std::max<size_t>(bins, 1), 0);
+    }
+
+    Histogram Histogram::logLinear(double minimum, double maximum, unsigned subBucketBits)
+    {
+        if (!(minimum > 0.0))
+            minimum = std::numeric_limits<double>::min();
+        if (!(maximum > minimum))
+            maximum = minimum * 2.0;
+        subBucketBits = std::min(subBucketBits, 16u);
+
+        // Whole powers of two, each split into 2^subBucketBits linear bins;
+        // the top edge rounds up to the next power of two above minimum
+        int octaves = std::max(1, static_cast<int>(std::ceil(std::log2(maximum / minimum))));
+        double top = std::ldexp(minimum, octaves);
+        size_t bins = static_cast<size_t>(octaves) << subBucketBits;
+        return Histogram(Scale::LogLinear, minimum, top, bins, subBucketBits);
+    }
+
+    void Histogram::add(double value)
+    {
+        add(value, 1.0);
+    }
+
+    void Histogram::add(double value, double count)
+    {
+        total_ += count;
+        if (value < minimum_)
+        {
+            underflow_ += count;
+        }
+        else if (!(value <= maximum_))
+        {
+            overflow_ += count;
+        }
+        else
+        {
+            counts_[binIndex(value)] += count;
+        }
+    }
+
+    void Histogram::clear()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0.0);
+        underflow_ = 0.0;
+        overflow_ = 0.0;
+        total_ = 0.0;
+    }
+
+    bool Histogram::merge(const Histogram &other)
+    {
+        if (!hasSameLayout(other))
+        {
+            return false;
+        }
+        return mergeCounts(other.counts_, other.underflow_, other.overflow_);
+    }
+
+    bool Histogram::mergeCounts(std::span<const double> counts, double underflow, double overflow)
+    {
+        if (counts.size() != counts_.size())
+        {
+            return false;
+        }
+
+        for (size_t bin = 0; bin < counts.size(); ++bin)
+        {
+            counts_[bin] += counts[bin];
+            total_ += counts[bin];
+        }
+        underflow_ += underflow;
+        overflow_ += overflow;
+        total_ += underflow + overflow;
+        return true;
+    }
+
+    bool Histogram::hasSameLayout(const Histogram &other) const
+    {
+        return scale_ == other.scale_ && minimum_ == other.minimum_ && maximum_ == other.maximum_ &&
+               subBucketBits_ == other.subBucketBits_ && counts_.size() == other.counts_.size();
+    }
+
+    size_t Histogram::binIndex(double value) const
+    {
+        size_t bins = counts_.size();
+        if (!(value >= minimum_ && value <= maximum_))
+        {
+            return bins;
+        }
+
+        double position = 0.0;
+        switch (scale_)
+        {
+        case Scale::Linear:
+            position = (value - minimum_) * scaleFactor_;
+            break;
+        case Scale::Logarithmic:
+            position = std::log(value / minimum_) * scaleFactor_;
+            break;
+        case Scale::LogLinear:
+        {
+            // value / minimum = mantissa * 2^exponent with mantissa in [0.5, 1)
+            int exponent = 0;
+            double mantissa = std::frexp(value / minimum_, &exponent);
+            position = (exponent - 1) * scaleFactor_ + (2.0 * mantissa - 1.0) * scaleFactor_;
+            break;
+        }
+        }
+
+        // The top edge belongs to the last bin
+        size_t bin = static_cast<size_t>(position);
+        return (bin >= bins) ? bins - 1 : bin;
+    }
+
+    double Histogram::lowerEdge(size_t bin) const
+    {
+        switch (scale_)
+        {
+        case Scale::Linear:
+            return minimum_ + bin / scaleFactor_;
+        case Scale::Logarithmic:
+            return minimum_ * std::exp(bin / scaleFactor_);
+        case Scale::LogLinear:
+        {
+            size_t subBuckets = size_t{1} << subBucketBits_;
+            int octave = static_cast<int>(bin >> subBucketBits_);
+            double fraction = static_cast<double>(bin & (subBuckets - 1)) / subBuckets;
+            return std::ldexp(minimum_ * (1.0 + fraction), octave);
+        }
+        }
+        return minimum_;
+    }
+
+    double Histogram::upperEdge(size_t bin) const
+    {
+        return (bin + 1 >= counts_.size()) ? maximum_ : lowerEdge(bin + 1);
+    }
+
+} // namespace utils
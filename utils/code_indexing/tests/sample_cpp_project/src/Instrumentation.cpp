@@ -0,0 +1,252 @@
+#include "utils/Instrumentation.h"
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace utils
+{
+
+    namespace
+    {
+        struct TraceEvent
+        {
+            const char *name;
+            uint32_t threadId;
+            int64_t startMicroseconds;
+            int64_t durationMicroseconds;
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<Counter *> counters;
+            std::vector<TimerMetric *> timers;
+            std::vector<TraceEvent> trace;
+            std::atomic<uint64_t> droppedTraceEvents{0};
+            std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        };
+
+        Registry &registry()
+        {
+            static Registry instance;
+            return instance;
+        }
+
+        uint32_t currentThreadId()
+        {
+            static std::atomic<uint32_t> nextId{1};
+            thread_local uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+            return id;
+        }
+
+        void appendJsonString(std::string &out, const char *text)
+        {
+            out += '"';
+            for (const char *c = text; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                    out += '\\';
+                out += *c;
+            }
+            out += '"';
+        }
+
+        void appendHeader(std::string &out, const char *name, const char *help, const char *type)
+        {
+            out += "# HELP ";
+            out += name;
+            out += ' ';
+            out += help;
+            out += "\n# TYPE ";
+            out += name;
+            out += ' ';
+            out += type;
+            out += '\n';
+        }
+
+        void appendSample(std::string &out, const char *name, const char *suffix, double value)
+        {
+            char number[32];
+            std::snprintf(number, sizeof(number), "%.9g", value);
+            out += name;
+            out += suffix;
+            out += ' ';
+            out += number;
+            out += '\n';
+        }
+    }
+
+    std::atomic<bool> Instrumentation::tracingEnabled_{false};
+
+    // Counter implementation
+    Counter::Counter(const char *name, const char *help) : name_(name), help_(help), value_(0)
+    {
+        Instrumentation::registerCounter(this);
+    }
+
+    // TimerMetric implementation
+    TimerMetric::TimerMetric(const char *name, const char *help)
+        : name_(name), help_(help), count_(0), totalNanoseconds_(0), maxNanoseconds_(0)
+    {
+        Instrumentation::registerTimer(this);
+    }
+
+    void TimerMetric::record(uint64_t nanoseconds)
+    {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        totalNanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+        uint64_t previous = maxNanoseconds_.load(std::memory_order_relaxed);
+        while (nanoseconds > previous &&
+               !maxNanoseconds_.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void TimerMetric::reset()
+    {
+        count_.store(0, std::memory_order_relaxed);
+        totalNanoseconds_.store(0, std::memory_order_relaxed);
+        maxNanoseconds_.store(0, std::memory_order_relaxed);
+    }
+
+    // ScopedTimer implementation
+    ScopedTimer::~ScopedTimer()
+    {
+        auto end = std::chrono::steady_clock::now();
+        metric_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count()));
+
+        if (Instrumentation::isTracingEnabled())
+        {
+            Instrumentation::recordTraceEvent(metric_, start_, end);
+        }
+    }
+
+    // Instrumentation implementation
+    std::string Instrumentation::exportPrometheus()
+    {
+        Registry &state = registry();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        std::string out;
+        for (const Counter *counter : state.counters)
+        {
+            appendHeader(out, counter->getName(), counter->getHelp(), "counter");
+            appendSample(out, counter->getName(), "", static_cast<double>(counter->getValue()));
+        }
+        for (const TimerMetric *timer : state.timers)
+        {
+            appendHeader(out, timer->getName(), timer->getHelp(), "summary");
+            appendSample(out, timer->getName(), "_sum", timer->getTotalNanoseconds() * 1e-9);
+            appendSample(out, timer->getName(), "_count", static_cast<double>(timer->getCount()));
+        }
+        return out;
+    }
+
+    std::string Instrumentation::exportChromeTrace()
+    {
+        Registry &state = registry();
+        std::lock_guard<std::mutex> lock(state.mutex);
+
+        // Complete ("X") events, loadable in chrome://tracing and Perfetto
+        std::string out = "{\"traceEvents\":[";
+        for (size_t i = 0; i < state.trace.size(); ++i)
+        {
+            const TraceEvent &event = state.trace[i];
+            if (i > 0)
+                out += ',';
+            out += "{\"name\":";
+            appendJsonString(out, event.name);
+            out += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(event.threadId);
+            out += ",\"ts\":" + std::to_string(event.startMicroseconds);
+            out += ",\"dur\":" + std::to_string(event.durationMicroseconds) + "}";
+        }
+        out += "],\"displayTimeUnit\":\"ns\"}";
+        return out;
+    }
+
+    void Instrumentation::setTracingEnabled(bool enabled)
+    {
+        tracingEnabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    void Instrumentation::clearTrace()
+    {
+        Registry &state = registry();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.trace.clear();
+        state.droppedTraceEvents.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t Instrumentation::getDroppedTraceEvents()
+    {
+        return registry().droppedTraceEvents.load(std::memory_order_relaxed);
+    }
+
+    std::vector<const Counter *> Instrumentation::getCounters()
+    {
+        Registry &state = registry();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return std::vector<const Counter *>(state.counters.begin(), state.counters.end());
+    }
+
+    std::vector<const TimerMetric *> Instrumentation::getTimers()
+    {
+        Registry &state = registry();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return std::vector<const TimerMetric *>(state.timers.begin(), state.timers.end());
+    }
+
+    void Instrumentation::reset()
+    {
+        {
+            Registry &state = registry();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            for (Counter *counter : state.counters)
+            {
+                counter->reset();
+            }
+            for (TimerMetric *timer : state.timers)
+            {
+                timer->reset();
+            }
+        }
+        clearTrace();
+    }
+
+    void Instrumentation::registerCounter(Counter *counter)
+    {
+        Registry &state = registry();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.counters.push_back(counter);
+    }
+
+    void Instrumentation::registerTimer(TimerMetric *timer)
+    {
+        Registry &state = registry();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.timers.push_back(timer);
+    }
+
+    void Instrumentation::recordTraceEvent(const TimerMetric &metric, std::chrono::steady_clock::time_point start,
+                                           std::chrono::steady_clock::time_point end)
+    {
+        Registry &state = registry();
+        uint32_t threadId = currentThreadId();
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.trace.size() >= MAX_TRACE_EVENTS)
+        {
+            state.droppedTraceEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        state.trace.push_back(TraceEvent{metric.getName(), threadId,
+                                         duration_cast<microseconds>(start - state.epoch).count(),
+                                         duration_cast<microseconds>(end - start).count()});
+    }
+
+} // namespace utils
@@ -1,188 +1,426 @@
 #include "utils/MathUtils.h"
+#include "utils/ChunkedStatistics.h"
+#include "utils/ExactStatistics.h"
+#include "utils/Histogram.h"
+#include "utils/Instrumentation.h"
+#include "utils/QuantileSketch.h"
+#include "utils/RadixSort.h"
+#include "utils/SampleSource.h"
+#include "utils/StatisticsSummary.h"
 #include <algorithm>
 #include <cmath>
-#include <numeric>
 
 namespace utils
 {
 
-    // MathUtils implementation
-    double MathUtils::clamp(double value, double min, double max)
+    // Instrumentation probes
+    UTILS_DEFINE_COUNTER(sortRequests, "statistics_sort_requests_total", "Calls to StatisticsCalculator::sortDataIfNeeded");
+    UTILS_DEFINE_COUNTER(sortsPerformed, "statistics_sorts_total", "Sorts actually performed by StatisticsCalculator");
+    UTILS_DEFINE_TIMER(sortTimer, "statistics_sort_seconds", "Time spent sorting StatisticsCalculator samples");
+    UTILS_DEFINE_TIMER(calculateTimer, "statistics_calculate_seconds", "Time spent in StatisticsCalculator::calculate");
+    UTILS_DEFINE_TIMER(histogramTimer, "statistics_histogram_seconds", "Time spent in StatisticsCalculator::getHistogram");
+
+    namespace
     {
-        return std::max(min, std::min(value, max));
+        // Runs fn over the external source followed by the calculator's own samples
+        template <typename Function>
+        auto withAllSamples(const SampleSource &external, std::span<const double> owned, Function fn)
+        {
+            SpanSource ownedSource(owned);
+            ConcatenatedSource all({&external, &ownedSource});
+            return fn(static_cast<const SampleSource &>(all));
+        }
     }
 
-    double MathUtils::lerp(double a, double b, double t)
+    // Explicit template instantiations (members are defined inline in the header)
+    template class Vector2D<float>;
+    template class Vector2D<double>;
+    template class Vector2D<int>;
+
+    // StatisticsCalculator implementation
+    StatisticsCalculator::StatisticsCalculator() : is_sorted_(true)
     {
-        return a + t * (b - a);
     }
 
-    bool MathUtils::isNearZero(double value, double epsilon)
+    StatisticsCalculator::StatisticsCalculator(const StatisticsCalculator &other)
+        : data_(other.data_), is_sorted_(other.is_sorted_),
+          quantileBackend_(other.quantileBackend_ ? other.quantileBackend_->clone() : nullptr),
+          incrementalHistogram_(other.incrementalHistogram_
+                                    ? std::make_unique<Histogram>(*other.incrementalHistogram_)
+                                    : nullptr),
+          source_(other.source_)
     {
-        return std::abs(value) < epsilon;
     }
 
-    // Vector2D template implementations
-    template <typename T>
-    Vector2D<T> Vector2D<T>::operator+(const Vector2D &other) const
+    StatisticsCalculator::StatisticsCalculator(StatisticsCalculator &&other) noexcept = default;
+
+    StatisticsCalculator &StatisticsCalculator::operator=(const StatisticsCalculator &other)
     {
-        return Vector2D(x + other.x, y + other.y);
+        if (this != &other)
+        {
+            data_ = other.data_;
+            is_sorted_ = other.is_sorted_;
+            quantileBackend_ = other.quantileBackend_ ? other.quantileBackend_->clone() : nullptr;
+            incrementalHistogram_ = other.incrementalHistogram_
+                                        ? std::make_unique<Histogram>(*other.incrementalHistogram_)
+                                        : nullptr;
+            source_ = other.source_;
+        }
+        return *this;
     }
 
-    template <typename T>
-    Vector2D<T> Vector2D<T>::operator-(const Vector2D &other) const
+    StatisticsCalculator &StatisticsCalculator::operator=(StatisticsCalculator &&other) noexcept = default;
+
+    StatisticsCalculator::~StatisticsCalculator() = default;
+
+    void StatisticsCalculator::addValue(double value)
     {
-        return Vector2D(x - other.x, y - other.y);
+        data_.push_back(value);
+        is_sorted_ = false;
+
+        if (quantileBackend_)
+        {
+            quantileBackend_->add(value);
+        }
+        if (incrementalHistogram_)
+        {
+            incrementalHistogram_->add(value);
+        }
     }
 
-    template <typename T>
-    Vector2D<T> Vector2D<T>::operator*(T scalar) const
+    void StatisticsCalculator::addValues(const std::vector<double> &values)
     {
-        return Vector2D(x * scalar, y * scalar);
+        addValues(std::span<const double>(values));
     }
 
-    template <typename T>
-    Vector2D<T> &Vector2D<T>::operator+=(const Vector2D &other)
+    void StatisticsCalculator::addValues(std::vector<double> &&values)
     {
-        x += other.x;
-        y += other.y;
-        return *this;
+        if (!data_.empty())
+        {
+            addValues(std::span<const double>(values));
+            return;
+        }
+
+        // Adopt the caller's buffer instead of copying it
+        data_ = std::move(values);
+        valuesAppended(0);
     }
 
-    template <typename T>
-    Vector2D<T> &Vector2D<T>::operator-=(const Vector2D &other)
+    void StatisticsCalculator::addValues(std::span<const double> values)
     {
-        x -= other.x;
-        y -= other.y;
-        return *this;
+        size_t previous = data_.size();
+        data_.insert(data_.end(), values.begin(), values.end());
+        valuesAppended(previous);
     }
 
-    template <typename T>
-    Vector2D<T> &Vector2D<T>::operator*=(T scalar)
+    void StatisticsCalculator::addSortedValues(std::span<const double> sorted)
     {
-        x *= scalar;
-        y *= scalar;
-        return *this;
+        bool wasSorted = is_sorted_;
+        size_t previous = data_.size();
+        data_.insert(data_.end(), sorted.begin(), sorted.end());
+        valuesAppended(previous);
+
+        // Two sorted runs merge in linear time; otherwise sorting stays deferred
+        if (wasSorted)
+        {
+            std::inplace_merge(data_.begin(), data_.begin() + previous, data_.end());
+            is_sorted_ = true;
+        }
     }
 
-    template <typename T>
-    bool Vector2D<T>::operator==(const Vector2D &other) const
+    void StatisticsCalculator::clear()
     {
-        return std::abs(x - other.x) < EPSILON_VAL &&
-               std::abs(y - other.y) < EPSILON_VAL;
+        data_.clear();
+        is_sorted_ = true;
+        source_.reset();
+
+        if (quantileBackend_)
+        {
+            quantileBackend_->clear();
+        }
+        if (incrementalHistogram_)
+        {
+            incrementalHistogram_->clear();
+        }
     }
 
-    template <typename T>
-    bool Vector2D<T>::operator!=(const Vector2D &other) const
+    bool StatisticsCalculator::merge(const StatisticsCalculator &other)
     {
-        return !(*this == other);
+        if (this == &other)
+        {
+            StatisticsCalculator copy(other);
+            return merge(copy);
+        }
+
+        addValues(std::span<const double>(other.data_));
+        if (other.source_)
+        {
+            return other.source_->forEachChunk([this](std::span<const double> chunk)
+            {
+                addValues(chunk);
+            });
+        }
+        return true;
     }
 
-    template <typename T>
-    T Vector2D<T>::magnitude() const
+    bool StatisticsCalculator::summarize(StatisticsSummary &summary) const
     {
-        return std::sqrt(x * x + y * y);
+        if (summary.isEmpty() && !summary.getHistogram() && incrementalHistogram_)
+        {
+            summary.setHistogram(*incrementalHistogram_);
+        }
+
+        summary.addValues(data_);
+        if (source_)
+        {
+            return source_->forEachChunk([&summary](std::span<const double> chunk)
+            {
+                summary.addValues(chunk);
+            });
+        }
+        return true;
     }
 
-    template <typename T>
-    T Vector2D<T>::magnitudeSquared() const
+    void StatisticsCalculator::setQuantileBackend(std::unique_ptr<QuantileEstimator> backend)
     {
-        return x * x + y * y;
+        quantileBackend_ = std::move(backend);
+
+        // Bring the new backend up to date with samples already collected
+        if (quantileBackend_)
+        {
+            quantileBackend_->clear();
+            for (double value : data_)
+            {
+                quantileBackend_->add(value);
+            }
+            if (source_)
+            {
+                source_->forEachChunk([this](std::span<const double> chunk)
+                {
+                    for (double value : chunk)
+                    {
+                        quantileBackend_->add(value);
+                    }
+                });
+            }
+        }
     }
 
-    template <typename T>
-    Vector2D<T> Vector2D<T>::normalized() const
+    void StatisticsCalculator::setIncrementalHistogram(const Histogram &layout)
     {
-        T mag = magnitude();
-        if (mag < EPSILON_VAL)
+        incrementalHistogram_ = std::make_unique<Histogram>(layout);
+        incrementalHistogram_->clear();
+
+        // Bin the samples collected so far once; later inserts are O(1)
+        for (double value : data_)
+        {
+            incrementalHistogram_->add(value);
+        }
+        if (source_)
         {
-            return Vector2D(T{}, T{});
+            source_->forEachChunk([this](std::span<const double> chunk)
+            {
+                for (double value : chunk)
+                {
+                    incrementalHistogram_->add(value);
+                }
+            });
         }
-        return Vector2D(x / mag, y / mag);
     }
 
-    template <typename T>
-    T Vector2D<T>::dot(const Vector2D &other) const
+    void StatisticsCalculator::clearIncrementalHistogram()
     {
-        return x * other.x + y * other.y;
+        incrementalHistogram_.reset();
     }
 
-    // Explicit template instantiations
-    template class Vector2D<float>;
-    template class Vector2D<double>;
-    template class Vector2D<int>;
-
-    // StatisticsCalculator implementation
-    StatisticsCalculator::StatisticsCalculator() : is_sorted_(true)
+    void StatisticsCalculator::attachSource(std::shared_ptr<const SampleSource> source)
     {
+        source_ = std::move(source);
+
+        // Rebuild derived summaries so they cover exactly the current samples
+        if (quantileBackend_ || incrementalHistogram_)
+        {
+            if (quantileBackend_)
+                quantileBackend_->clear();
+            if (incrementalHistogram_)
+                incrementalHistogram_->clear();
+
+            feedDerived(SpanSource(data_));
+            if (source_)
+                feedDerived(*source_);
+        }
     }
 
-    StatisticsCalculator::~StatisticsCalculator() = default;
+    void StatisticsCalculator::attachView(std::span<const double> samples)
+    {
+        attachSource(std::make_shared<SpanSource>(samples));
+    }
 
-    void StatisticsCalculator::addValue(double value)
+    size_t StatisticsCalculator::getCount() const
     {
-        data_.push_back(value);
-        is_sorted_ = false;
+        return data_.size() + (source_ ? source_->getCount() : 0);
     }
 
-    void StatisticsCalculator::addValues(const std::vector<double> &values)
+    bool StatisticsCalculator::attachFile(const std::string &path)
     {
-        data_.insert(data_.end(), values.begin(), values.end());
-        is_sorted_ = false;
+        return attachFile(path, FileAccess::Mapped);
     }
 
-    void StatisticsCalculator::clear()
+    bool StatisticsCalculator::attachFile(const std::string &path, FileAccess access)
     {
-        data_.clear();
-        is_sorted_ = true;
+        if (access == FileAccess::Mapped)
+        {
+            auto mapped = std::make_shared<MappedFileSource>();
+            if (!mapped->open(path))
+                return false;
+            attachSource(std::move(mapped));
+        }
+        else
+        {
+            auto streamed = std::make_shared<FileStreamSource>();
+            if (!streamed->open(path))
+                return false;
+            attachSource(std::move(streamed));
+        }
+        return true;
     }
 
     Statistics StatisticsCalculator::calculate() const
     {
+        UTILS_SCOPED_TIMER(calculateTimer);
+
+        if (source_)
+        {
+            // Radix selection in place; an unreadable source yields empty statistics
+            Statistics stats;
+            bool ok = withAllSamples(*source_, data_, [&stats](const SampleSource &all)
+                                     { return ChunkedStatistics::summarize(all, stats); });
+            return ok ? stats : Statistics{};
+        }
+
         if (data_.empty())
         {
             return Statistics{};
         }
 
-        Statistics stats;
-        stats.count = data_.size();
-        stats.mean = calculateMean();
-        stats.median = calculateMedian();
-        stats.standardDeviation = calculateStandardDeviation(stats.mean);
+        if (!is_sorted_)
+        {
+            // One fused moments pass plus selection of the middle ranks
+            return ExactStatistics::summarize(data_);
+        }
 
-        auto minmax = std::minmax_element(data_.begin(), data_.end());
-        stats.minimum = *minmax.first;
-        stats.maximum = *minmax.second;
+        SampleMoments moments = ExactStatistics::computeMoments(data_);
+
+        Statistics stats;
+        stats.count = moments.count;
+        stats.mean = moments.mean;
+        stats.median = ExactStatistics::medianOfSorted(data_);
+        stats.standardDeviation = std::sqrt(moments.variance());
+        stats.minimum = moments.minimum;
+        stats.maximum = moments.maximum;
 
         return stats;
     }
 
+    Statistics StatisticsCalculator::calculate(const std::vector<double> &percentiles,
+                                               std::vector<double> &values) const
+    {
+        values.assign(percentiles.size(), 0.0);
+
+        if (isEmpty())
+        {
+            return Statistics{};
+        }
+
+        if (source_ && !quantileBackend_)
+        {
+            Statistics stats;
+            bool ok = withAllSamples(*source_, data_, [&](const SampleSource &all)
+                                     { return ChunkedStatistics::summarize(all, percentiles, values, stats); });
+            return ok ? stats : Statistics{};
+        }
+
+        if (is_sorted_ || quantileBackend_)
+        {
+            values = getPercentiles(percentiles);
+            return calculate();
+        }
+
+        return ExactStatistics::summarize(data_, percentiles, values);
+    }
+
     double StatisticsCalculator::getPercentile(double percentile) const
     {
-        if (data_.empty())
+        if (isEmpty())
         {
             return 0.0;
         }
 
+        if (quantileBackend_)
+        {
+            return quantileBackend_->quantile(percentile / 100.0);
+        }
+
+        if (source_)
+        {
+            return getPercentiles({percentile})[0];
+        }
+
         sortDataIfNeeded();
+        return ExactStatistics::percentileOfSorted(data_, percentile);
+    }
 
-        double index = percentile * (data_.size() - 1) / 100.0;
-        size_t lower = static_cast<size_t>(std::floor(index));
-        size_t upper = static_cast<size_t>(std::ceil(index));
+    std::vector<double> StatisticsCalculator::getPercentiles(const std::vector<double> &percentiles) const
+    {
+        std::vector<double> values(percentiles.size(), 0.0);
 
-        if (lower == upper)
+        if (isEmpty())
         {
-            return data_[lower];
+            return values;
         }
 
-        double weight = index - lower;
-        return data_[lower] * (1.0 - weight) + data_[upper] * weight;
+        if (quantileBackend_)
+        {
+            for (size_t i = 0; i < percentiles.size(); ++i)
+            {
+                values[i] = quantileBackend_->quantile(percentiles[i] / 100.0);
+            }
+        }
+        else if (source_)
+        {
+            bool ok = withAllSamples(*source_, data_, [&](const SampleSource &all)
+                                     { return ChunkedStatistics::selectPercentiles(all, percentiles, values); });
+            if (!ok)
+                values.assign(percentiles.size(), 0.0);
+        }
+        else if (is_sorted_)
+        {
+            for (size_t i = 0; i < percentiles.size(); ++i)
+            {
+                values[i] = ExactStatistics::percentileOfSorted(data_, percentiles[i]);
+            }
+        }
+        else
+        {
+            ExactStatistics::selectPercentiles(data_, percentiles, values);
+        }
+
+        return values;
     }
 
     std::vector<double> StatisticsCalculator::getHistogram(size_t bins) const
     {
+        UTILS_SCOPED_TIMER(histogramTimer);
+
         std::vector<double> histogram(bins, 0.0);
 
+        if (source_)
+        {
+            bool ok = withAllSamples(*source_, data_, [&](const SampleSource &all)
+                                     { return ChunkedStatistics::histogram(all, bins, histogram); });
+            return ok ? histogram : std::vector<double>(bins, 0.0);
+        }
+
         if (data_.empty() || bins == 0)
         {
             return histogram;
@@ -210,50 +448,246 @@ namespace utils
         return histogram;
     }
 
+    std::vector<double> StatisticsCalculator::getHistogram() const
+    {
+        if (!incrementalHistogram_)
+        {
+            return std::vector<double>();
+        }
+        return incrementalHistogram_->getCounts();
+    }
+
+    void StatisticsCalculator::valuesAppended(size_t first)
+    {
+        if (first == data_.size())
+        {
+            return;
+        }
+        is_sorted_ = false;
+
+        for (size_t i = first; i < data_.size(); ++i)
+        {
+            if (quantileBackend_)
+                quantileBackend_->add(data_[i]);
+            if (incrementalHistogram_)
+                incrementalHistogram_->add(data_[i]);
+        }
+    }
+
+    void StatisticsCalculator::feedDerived(const SampleSource &source)
+    {
+        source.forEachChunk([this](std::span<const double> chunk)
+        {
+            for (double value : chunk)
+            {
+                if (quantileBackend_)
+                    quantileBackend_->add(value);
+                if (incrementalHistogram_)
+                    incrementalHistogram_->add(value);
+            }
+        });
+    }
+
     void StatisticsCalculator::sortDataIfNeeded() const
     {
+        UTILS_COUNT(sortRequests, 1);
         if (!is_sorted_)
         {
-            std::sort(data_.begin(), data_.end());
+            UTILS_COUNT(sortsPerformed, 1);
+            UTILS_SCOPED_TIMER(sortTimer);
+            RadixSort::sort(data_);
             is_sorted_ = true;
         }
     }
 
-    double StatisticsCalculator::calculateMean() const
+    // BasicStatisticsCalculator implementation
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    void BasicStatisticsCalculator<T, Accum>::addValue(T value)
     {
-        return std::accumulate(data_.begin(), data_.end(), 0.0) / data_.size();
+        data_.push_back(value);
+        is_sorted_ = false;
+    }
+
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    void BasicStatisticsCalculator<T, Accum>::addValues(const std::vector<T> &values)
+    {
+        addValues(std::span<const T>(values));
+    }
+
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    void BasicStatisticsCalculator<T, Accum>::addValues(std::vector<T> &&values)
+    {
+        if (!data_.empty())
+        {
+            addValues(std::span<const T>(values));
+            return;
+        }
+
+        // Adopt the caller's buffer instead of copying it
+        data_ = std::move(values);
+        is_sorted_ = data_.empty();
+    }
+
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    void BasicStatisticsCalculator<T, Accum>::addValues(std::span<const T> values)
+    {
+        if (values.empty())
+        {
+            return;
+        }
+        data_.insert(data_.end(), values.begin(), values.end());
+        is_sorted_ = false;
+    }
+
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    void BasicStatisticsCalculator<T, Accum>::clear()
+    {
+        data_.clear();
+        is_sorted_ = true;
     }
 
-    double StatisticsCalculator::calculateMedian() const
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    Statistics BasicStatisticsCalculator<T, Accum>::calculate() const
     {
+        if (data_.empty())
+        {
+            return Statistics{};
+        }
+
+        if (!is_sorted_)
+        {
+            return ExactStatistics::summarize<T, Accum>(data_, std::span<const double>(), std::span<double>());
+        }
+
+        SampleMoments moments = ExactStatistics::computeMoments<T, Accum>(data_);
+
+        Statistics stats;
+        stats.count = moments.count;
+        stats.mean = moments.mean;
+        stats.median = ExactStatistics::medianOfSorted<T>(data_);
+        stats.standardDeviation = std::sqrt(moments.variance());
+        stats.minimum = moments.minimum;
+        stats.maximum = moments.maximum;
+        return stats;
+    }
+
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    Statistics BasicStatisticsCalculator<T, Accum>::calculate(const std::vector<double> &percentiles,
+                                                              std::vector<double> &values) const
+    {
+        values.assign(percentiles.size(), 0.0);
+
+        if (data_.empty())
+        {
+            return Statistics{};
+        }
+
+        if (is_sorted_)
+        {
+            values = getPercentiles(percentiles);
+            return calculate();
+        }
+
+        return ExactStatistics::summarize<T, Accum>(data_, percentiles, values);
+    }
+
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    double BasicStatisticsCalculator<T, Accum>::getPercentile(double percentile) const
+    {
+        if (data_.empty())
+        {
+            return 0.0;
+        }
+
         sortDataIfNeeded();
+        return ExactStatistics::percentileOfSorted<T>(data_, percentile);
+    }
+
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    std::vector<double>
+    BasicStatisticsCalculator<T, Accum>::getPercentiles(const std::vector<double> &percentiles) const
+    {
+        std::vector<double> values(percentiles.size(), 0.0);
+
+        if (data_.empty())
+        {
+            return values;
+        }
 
-        size_t size = data_.size();
-        if (size % 2 == 0)
+        if (is_sorted_)
         {
-            return (data_[size / 2 - 1] + data_[size / 2]) / 2.0;
+            for (size_t i = 0; i < percentiles.size(); ++i)
+            {
+                values[i] = ExactStatistics::percentileOfSorted<T>(data_, percentiles[i]);
+            }
         }
         else
         {
-            return data_[size / 2];
+            ExactStatistics::selectPercentiles<T>(data_, percentiles, values);
         }
+
+        return values;
     }
 
-    double StatisticsCalculator::calculateStandardDeviation(double mean) const
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    std::vector<double> BasicStatisticsCalculator<T, Accum>::getHistogram(size_t bins) const
     {
-        if (data_.size() <= 1)
+        std::vector<double> histogram(bins, 0.0);
+
+        if (data_.empty() || bins == 0)
         {
-            return 0.0;
+            return histogram;
         }
 
-        double sum_squared_diff = 0.0;
-        for (double value : data_)
+        auto minmax = std::minmax_element(data_.begin(), data_.end());
+        double min_val = static_cast<double>(*minmax.first);
+        double max_val = static_cast<double>(*minmax.second);
+        double range = max_val - min_val;
+
+        if (range == 0.0)
+        {
+            histogram[0] = static_cast<double>(data_.size());
+            return histogram;
+        }
+
+        for (T value : data_)
         {
-            double diff = value - mean;
-            sum_squared_diff += diff * diff;
+            size_t bin = static_cast<size_t>((static_cast<double>(value) - min_val) / range * bins);
+            if (bin >= bins)
+                bin = bins - 1;
+            histogram[bin] += 1.0;
         }
 
-        return std::sqrt(sum_squared_diff / (data_.size() - 1));
+        return histogram;
     }
 
+    template <typename T, typename Accum>
+        requires std::is_arithmetic_v<T> && std::is_floating_point_v<Accum>
+    void BasicStatisticsCalculator<T, Accum>::sortDataIfNeeded() const
+    {
+        if (!is_sorted_)
+        {
+            if constexpr (std::is_same_v<T, double>)
+                RadixSort::sort(data_);
+            else
+                std::sort(data_.begin(), data_.end());
+            is_sorted_ = true;
+        }
+    }
+
+    // Explicit template instantiations (members are defined above, out of the header)
+    template class BasicStatisticsCalculator<float>;
+    template class BasicStatisticsCalculator<double>;
+    template class BasicStatisticsCalculator<int>;
+
 } // namespace utils
@@ -0,0 +1,74 @@
+#include "geometry/PointIndex.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+
+namespace geometry
+{
+
+    PointIndex::PointIndex(std::unique_ptr<SpatialIndex> index) : index_(std::move(index))
+    {
+    }
+
+    size_t PointIndex::add(const utils::Vec2d &point)
+    {
+        size_t id = points_.size();
+        size_t indexId = index_->insert(BoundingBox(point.x, point.y, point.x, point.y));
+        if (indexId >= pointIds_.size())
+            pointIds_.resize(indexId + 1);
+        pointIds_[indexId] = id;
+        points_.push_back(point);
+        return id;
+    }
+
+    void PointIndex::add(std::span<const utils::Vec2d> points)
+    {
+        points_.reserve(points_.size() + points.size());
+        for (const utils::Vec2d &point : points)
+        {
+            add(point);
+        }
+    }
+
+    void PointIndex::clear()
+    {
+        index_->clear();
+        points_.clear();
+        pointIds_.clear();
+    }
+
+    void PointIndex::nearest(const utils::Vec2d &query, size_t k, std::vector<size_t> &out) const
+    {
+        size_t first = out.size();
+        index_->nearest(query.x, query.y, k, out);
+        for (size_t i = first; i < out.size(); ++i)
+        {
+            out[i] = pointIds_[out[i]];
+        }
+    }
+
+    void PointIndex::nearest(std::span<const utils::Vec2d> queries, size_t k, std::vector<size_t> &out) const
+    {
+        size_t width = std::min(k, points_.size());
+        out.assign(queries.size() * width, 0);
+        if (width == 0)
+        {
+            return;
+        }
+
+        // Each worker fills its own rows; the index is only read
+        utils::parallelFor(queries.size(), MIN_PARALLEL_QUERIES, [&](size_t begin, size_t end)
+                           {
+                               std::vector<size_t> ids;
+                               ids.reserve(width);
+                               for (size_t query = begin; query < end; ++query)
+                               {
+                                   ids.clear();
+                                   index_->nearest(queries[query].x, queries[query].y, width, ids);
+                                   for (size_t i = 0; i < width; ++i)
+                                   {
+                                       out[query * width + i] = pointIds_[ids[i]];
+                                   }
+                               } });
+    }
+
+} // namespace geometry
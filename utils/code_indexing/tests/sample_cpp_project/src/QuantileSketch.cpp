@@ -0,0 +1,226 @@
+#include "utils/QuantileSketch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+
+    KllSketch::KllSketch(size_t k)
+        : k_(std::max(k, MIN_LEVEL_CAPACITY)), count_(0), minimum_(0.0), maximum_(0.0),
+          randomState_(0x9E3779B97F4A7C15ULL), levels_(1), viewValid_(false)
+    {
+    }
+
+    void KllSketch::add(double value)
+    {
+        if (count_ == 0)
+        {
+            minimum_ = value;
+            maximum_ = value;
+        }
+        else
+        {
+            minimum_ = std::min(minimum_, value);
+            maximum_ = std::max(maximum_, value);
+        }
+
+        ++count_;
+        levels_[0].push_back(value);
+        viewValid_ = false;
+
+        if (levels_[0].size() >= levelCapacity(0))
+        {
+            compress();
+        }
+    }
+
+    void KllSketch::merge(const KllSketch &other)
+    {
+        std::vector<std::span<const double>> levels(other.levels_.begin(), other.levels_.end());
+        mergeRetained(other.k_, other.count_, other.minimum_, other.maximum_, levels);
+    }
+
+    void KllSketch::mergeRetained(size_t k, size_t count, double minimum, double maximum,
+                                  std::span<const std::span<const double>> levels)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (count_ == 0)
+        {
+            minimum_ = minimum;
+            maximum_ = maximum;
+        }
+        else
+        {
+            minimum_ = std::min(minimum_, minimum);
+            maximum_ = std::max(maximum_, maximum);
+        }
+
+        // Sketches of different accuracy combine at the coarser one
+        k_ = std::min(k_, std::max(k, MIN_LEVEL_CAPACITY));
+        count_ += count;
+
+        if (levels_.size() < levels.size())
+        {
+            levels_.resize(levels.size());
+        }
+        for (size_t level = 0; level < levels.size(); ++level)
+        {
+            levels_[level].insert(levels_[level].end(), levels[level].begin(), levels[level].end());
+        }
+
+        viewValid_ = false;
+        compress();
+    }
+
+    void KllSketch::clear()
+    {
+        count_ = 0;
+        minimum_ = 0.0;
+        maximum_ = 0.0;
+        levels_.assign(1, std::vector<double>());
+        sortedView_.clear();
+        viewValid_ = false;
+    }
+
+    double KllSketch::quantile(double quantile) const
+    {
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+        if (quantile <= 0.0)
+        {
+            return minimum_;
+        }
+        if (quantile >= 1.0)
+        {
+            return maximum_;
+        }
+
+        buildSortedView();
+
+        // First retained item whose cumulative weight covers the target rank
+        uint64_t total = sortedView_.back().second;
+        double target = quantile * static_cast<double>(total);
+        auto it = std::lower_bound(sortedView_.begin(), sortedView_.end(), target,
+                                   [](const std::pair<double, uint64_t> &item, double rank)
+                                   { return static_cast<double>(item.second) < rank; });
+        if (it == sortedView_.end())
+        {
+            return maximum_;
+        }
+        return std::max(minimum_, std::min(it->first, maximum_));
+    }
+
+    double KllSketch::rank(double value) const
+    {
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+
+        buildSortedView();
+
+        // Weight of retained items strictly below value
+        auto it = std::lower_bound(sortedView_.begin(), sortedView_.end(), value,
+                                   [](const std::pair<double, uint64_t> &item, double v)
+                                   { return item.first < v; });
+        uint64_t below = (it == sortedView_.begin()) ? 0 : std::prev(it)->second;
+        return static_cast<double>(below) / static_cast<double>(sortedView_.back().second);
+    }
+
+    size_t KllSketch::getRetainedCount() const
+    {
+        size_t retained = 0;
+        for (const auto &level : levels_)
+        {
+            retained += level.size();
+        }
+        return retained;
+    }
+
+    std::unique_ptr<QuantileEstimator> KllSketch::clone() const
+    {
+        return std::make_unique<KllSketch>(*this);
+    }
+
+    size_t KllSketch::levelCapacity(size_t level) const
+    {
+        // The top level holds k items; each level below holds 2/3 as many
+        size_t depth = levels_.size() - 1 - level;
+        double capacity = std::ceil(static_cast<double>(k_) * std::pow(2.0 / 3.0, static_cast<double>(depth)));
+        return std::max(MIN_LEVEL_CAPACITY, static_cast<size_t>(capacity));
+    }
+
+    void KllSketch::compress()
+    {
+        for (size_t level = 0; level < levels_.size(); ++level)
+        {
+            if (levels_[level].size() < levelCapacity(level))
+            {
+                continue;
+            }
+
+            if (level + 1 == levels_.size())
+            {
+                levels_.emplace_back();
+            }
+
+            // Promote every other sorted item; an odd item out stays behind
+            std::vector<double> &items = levels_[level];
+            std::sort(items.begin(), items.end());
+            size_t keep = items.size() % 2;
+            size_t offset = keep + (nextRandomBit() ? 1 : 0);
+
+            std::vector<double> &parent = levels_[level + 1];
+            for (size_t i = offset; i < items.size(); i += 2)
+            {
+                parent.push_back(items[i]);
+            }
+            items.resize(keep);
+        }
+    }
+
+    bool KllSketch::nextRandomBit()
+    {
+        // xorshift64
+        randomState_ ^= randomState_ << 13;
+        randomState_ ^= randomState_ >> 7;
+        randomState_ ^= randomState_ << 17;
+        return (randomState_ & 1) != 0;
+    }
+
+    void KllSketch::buildSortedView() const
+    {
+        if (viewValid_)
+        {
+            return;
+        }
+
+        sortedView_.clear();
+        sortedView_.reserve(getRetainedCount());
+        for (size_t level = 0; level < levels_.size(); ++level)
+        {
+            uint64_t weight = uint64_t{1} << level;
+            for (double value : levels_[level])
+            {
+                sortedView_.emplace_back(value, weight);
+            }
+        }
+
+        std::sort(sortedView_.begin(), sortedView_.end());
+
+        uint64_t cumulative = 0;
+        for (auto &item : sortedView_)
+        {
+            cumulative += item.second;
+            item.second = cumulative;
+        }
+        viewValid_ = true;
+    }
+
+} // namespace utils
@@ -0,0 +1,208 @@
+#include "utils/RadixSort.h"
+#include "utils/ChunkedStatistics.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <vector>
+
+namespace utils
+{
+    namespace
+    {
+        constexpr size_t MASK = RadixSort::BUCKETS - 1;
+
+        inline size_t digitOf(double value, unsigned pass)
+        {
+            return static_cast<size_t>(ChunkedStatistics::orderedKey(value) >> (pass * RadixSort::DIGIT_BITS)) & MASK;
+        }
+
+        // Counts every digit of every value in one read; counts holds PASSES x BUCKETS
+        void countAllDigits(const double *values, size_t n, size_t *counts)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                uint64_t key = ChunkedStatistics::orderedKey(values[i]);
+                for (unsigned pass = 0; pass < RadixSort::PASSES; ++pass)
+                {
+                    ++counts[pass * RadixSort::BUCKETS + ((key >> (pass * RadixSort::DIGIT_BITS)) & MASK)];
+                }
+            }
+        }
+
+        void countDigit(const double *values, size_t n, unsigned pass, size_t *counts)
+        {
+            std::fill(counts, counts + RadixSort::BUCKETS, size_t{0});
+            for (size_t i = 0; i < n; ++i)
+            {
+                ++counts[digitOf(values[i], pass)];
+            }
+        }
+
+        // A pass is a no-op when one bucket holds every value
+        bool isTrivialPass(const size_t *counts, size_t n)
+        {
+            return std::find(counts, counts + RadixSort::BUCKETS, n) != counts + RadixSort::BUCKETS;
+        }
+
+        void scatter(const double *source, size_t n, unsigned pass, size_t *offsets, double *destination)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                destination[offsets[digitOf(source[i], pass)]++] = source[i];
+            }
+        }
+    } // namespace
+
+    void RadixSort::sort(std::span<double> values)
+    {
+        if (values.size() < MIN_RADIX_SIZE)
+        {
+            std::sort(values.begin(), values.end());
+        }
+        else if (values.size() < MIN_PARALLEL_SIZE || hardwareThreads() <= 1)
+        {
+            serialSort(values);
+        }
+        else
+        {
+            parallelSort(values);
+        }
+    }
+
+    void RadixSort::serialSort(std::span<double> values)
+    {
+        size_t n = values.size();
+        if (n < 2)
+        {
+            return;
+        }
+
+        std::vector<size_t> counts(PASSES * BUCKETS, 0);
+        countAllDigits(values.data(), n, counts.data());
+
+        std::vector<double> scratch(n);
+        double *source = values.data();
+        double *destination = scratch.data();
+        for (unsigned pass = 0; pass < PASSES; ++pass)
+        {
+            size_t *offsets = counts.data() + pass * BUCKETS;
+            if (isTrivialPass(offsets, n))
+            {
+                continue;
+            }
+
+            // Exclusive prefix sums turn counts into write offsets
+            size_t running = 0;
+            for (size_t bucket = 0; bucket < BUCKETS; ++bucket)
+            {
+                size_t count = offsets[bucket];
+                offsets[bucket] = running;
+                running += count;
+            }
+
+            scatter(source, n, pass, offsets, destination);
+            std::swap(source, destination);
+        }
+
+        if (source != values.data())
+        {
+            std::copy(source, source + n, values.data());
+        }
+    }
+
+    void RadixSort::parallelSort(std::span<double> values)
+    {
+        size_t n = values.size();
+        size_t chunks = std::min(hardwareThreads(), n / MIN_PARALLEL_CHUNK);
+        if (chunks <= 1)
+        {
+            serialSort(values);
+            return;
+        }
+
+        std::vector<size_t> bounds;
+        for (size_t chunk = 0; chunk <= chunks; ++chunk)
+        {
+            bounds.push_back(n * chunk / chunks);
+        }
+
+        // Per-chunk counts of every digit; their sums mark the trivial passes
+        std::vector<size_t> chunkCounts(chunks * PASSES * BUCKETS, 0);
+        parallelFor(chunks, 1, [&](size_t begin, size_t end)
+                    {
+                        for (size_t chunk = begin; chunk < end; ++chunk)
+                        {
+                            countAllDigits(values.data() + bounds[chunk], bounds[chunk + 1] - bounds[chunk],
+                                           chunkCounts.data() + chunk * PASSES * BUCKETS);
+                        } });
+
+        std::vector<size_t> totals(PASSES * BUCKETS, 0);
+        for (size_t chunk = 0; chunk < chunks; ++chunk)
+        {
+            for (size_t i = 0; i < PASSES * BUCKETS; ++i)
+            {
+                totals[i] += chunkCounts[chunk * PASSES * BUCKETS + i];
+            }
+        }
+
+        std::vector<double> scratch(n);
+        std::vector<size_t> offsets(chunks * BUCKETS);
+        double *source = values.data();
+        double *destination = scratch.data();
+        bool countsCurrent = true; // chunkCounts describe source until the first scatter
+        for (unsigned pass = 0; pass < PASSES; ++pass)
+        {
+            if (isTrivialPass(totals.data() + pass * BUCKETS, n))
+            {
+                continue;
+            }
+
+            if (countsCurrent)
+            {
+                for (size_t chunk = 0; chunk < chunks; ++chunk)
+                {
+                    const size_t *counts = chunkCounts.data() + (chunk * PASSES + pass) * BUCKETS;
+                    std::copy(counts, counts + BUCKETS, offsets.data() + chunk * BUCKETS);
+                }
+            }
+            else
+            {
+                parallelFor(chunks, 1, [&](size_t begin, size_t end)
+                            {
+                                for (size_t chunk = begin; chunk < end; ++chunk)
+                                {
+                                    countDigit(source + bounds[chunk], bounds[chunk + 1] - bounds[chunk], pass,
+                                               offsets.data() + chunk * BUCKETS);
+                                } });
+            }
+
+            // Bucket-major, chunk-minor offsets keep the scatter stable
+            size_t running = 0;
+            for (size_t bucket = 0; bucket < BUCKETS; ++bucket)
+            {
+                for (size_t chunk = 0; chunk < chunks; ++chunk)
+                {
+                    size_t count = offsets[chunk * BUCKETS + bucket];
+                    offsets[chunk * BUCKETS + bucket] = running;
+                    running += count;
+                }
+            }
+
+            parallelFor(chunks, 1, [&](size_t begin, size_t end)
+                        {
+                            for (size_t chunk = begin; chunk < end; ++chunk)
+                            {
+                                scatter(source + bounds[chunk], bounds[chunk + 1] - bounds[chunk], pass,
+                                        offsets.data() + chunk * BUCKETS, destination);
+                            } });
+            std::swap(source, destination);
+            countsCurrent = false;
+        }
+
+        if (source != values.data())
+        {
+            parallelFor(n, MIN_PARALLEL_CHUNK, [&](size_t begin, size_t end)
+                        { std::copy(source + begin, source + end, values.data() + begin); });
+        }
+    }
+
+} // namespace utils
@@ -0,0 +1,195 @@
+#include "utils/SampleSource.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace utils
+{
+
+    // SpanSource implementation
+    bool SpanSource::forEachChunk(const ChunkVisitor &visitor) const
+    {
+        if (!samples_.empty())
+        {
+            visitor(samples_);
+        }
+        return true;
+    }
+
+    // ConcatenatedSource implementation
+    bool ConcatenatedSource::forEachChunk(const ChunkVisitor &visitor) const
+    {
+        for (const SampleSource *source : sources_)
+        {
+            if (!source->forEachChunk(visitor))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t ConcatenatedSource::getCount() const
+    {
+        size_t count = 0;
+        for (const SampleSource *source : sources_)
+        {
+            count += source->getCount();
+        }
+        return count;
+    }
+
+    // MappedFileSource implementation
+    MappedFileSource::~MappedFileSource()
+    {
+        close();
+    }
+
+    bool MappedFileSource::open(const std::string &path)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        size_t bytes = static_cast<size_t>(info.st_size);
+        if (bytes >= sizeof(double))
+        {
+            void *mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+            ::madvise(mapping, bytes, MADV_SEQUENTIAL);
+            mapping_ = mapping;
+            mappedBytes_ = bytes;
+            count_ = bytes / sizeof(double);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+        open_ = true;
+        return true;
+    }
+
+    void MappedFileSource::close()
+    {
+        if (mapping_)
+        {
+            ::munmap(mapping_, mappedBytes_);
+        }
+        mapping_ = nullptr;
+        mappedBytes_ = 0;
+        count_ = 0;
+        open_ = false;
+    }
+
+    bool MappedFileSource::forEachChunk(const ChunkVisitor &visitor) const
+    {
+        std::span<const double> samples = getSamples();
+        for (size_t start = 0; start < samples.size(); start += CHUNK_SAMPLES)
+        {
+            visitor(samples.subspan(start, std::min(CHUNK_SAMPLES, samples.size() - start)));
+        }
+        return open_;
+    }
+
+    std::span<const double> MappedFileSource::getSamples() const
+    {
+        return std::span<const double>(static_cast<const double *>(mapping_), count_);
+    }
+
+    // FileStreamSource implementation
+    FileStreamSource::FileStreamSource(size_t bufferSamples)
+        : bufferSamples_(std::max<size_t>(bufferSamples, 1))
+    {
+    }
+
+    FileStreamSource::~FileStreamSource()
+    {
+        close();
+    }
+
+    bool FileStreamSource::open(const std::string &path)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        fileDescriptor_ = fd;
+        count_ = static_cast<size_t>(info.st_size) / sizeof(double);
+        return true;
+    }
+
+    void FileStreamSource::close()
+    {
+        if (fileDescriptor_ >= 0)
+        {
+            ::close(fileDescriptor_);
+        }
+        fileDescriptor_ = -1;
+        count_ = 0;
+    }
+
+    bool FileStreamSource::forEachChunk(const ChunkVisitor &visitor) const
+    {
+        if (fileDescriptor_ < 0)
+        {
+            return false;
+        }
+
+        std::vector<double> buffer(std::min(bufferSamples_, count_));
+        size_t remaining = count_;
+        off_t offset = 0;
+        while (remaining > 0)
+        {
+            size_t wanted = std::min(buffer.size(), remaining) * sizeof(double);
+            char *target = reinterpret_cast<char *>(buffer.data());
+
+            // pread may return short counts; keep reading until the chunk is full
+            size_t filled = 0;
+            while (filled < wanted)
+            {
+                ssize_t got = ::pread(fileDescriptor_, target + filled, wanted - filled, offset + filled);
+                if (got < 0 && errno == EINTR)
+                    continue;
+                if (got <= 0)
+                    return false;
+                filled += static_cast<size_t>(got);
+            }
+
+            size_t samples = wanted / sizeof(double);
+            visitor(std::span<const double>(buffer.data(), samples));
+            remaining -= samples;
+            offset += static_cast<off_t>(wanted);
+        }
+        return true;
+    }
+
+} // namespace utils
@@ -0,0 +1,676 @@
+#include "geometry/SceneFile.h"
+#include "geometry/Intersection.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace geometry
+{
+
+    namespace
+    {
+        // Header fields shared by scene files and logs
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t flags;
+            uint64_t generation;
+            uint64_t rectangles;
+            uint64_t circles;
+        };
+        static_assert(sizeof(Header) == SceneFile::HEADER_BYTES && sizeof(Header) == SceneLog::HEADER_BYTES);
+
+        struct LogRecord
+        {
+            uint32_t operation;
+            uint32_t checksum;
+            uint64_t index;
+            double values[4];
+        };
+        static_assert(sizeof(LogRecord) == SceneLog::RECORD_BYTES);
+
+        // Writes every byte, retrying short writes and interrupted calls
+        bool writeAll(int fd, const void *data, size_t bytes)
+        {
+            const char *cursor = static_cast<const char *>(data);
+            while (bytes > 0)
+            {
+                ssize_t written = ::write(fd, cursor, bytes);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return false;
+                cursor += written;
+                bytes -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        bool writeColumn(int fd, std::span<const double> column)
+        {
+            return column.empty() || writeAll(fd, column.data(), column.size_bytes());
+        }
+
+        // Makes a rename in path's directory durable
+        bool syncParentDirectory(const std::string &path)
+        {
+            size_t slash = path.find_last_of('/');
+            std::string directory = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+            int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            bool ok = ::fsync(fd) == 0;
+            return (::close(fd) == 0) && ok;
+        }
+
+        // Random, so ids from independent writes of the same path never collide in practice
+        uint64_t newGeneration()
+        {
+            std::random_device device;
+            uint64_t generation = (static_cast<uint64_t>(device()) << 32) ^ device();
+            return generation != 0 ? generation : 1;
+        }
+
+        // Maps a whole file read-only; an empty file maps to nullptr with zero bytes
+        bool mapFile(const std::string &path, void *&mapping, size_t &bytes)
+        {
+            mapping = nullptr;
+            bytes = 0;
+
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+            {
+                ::close(fd);
+                return false;
+            }
+
+            size_t size = static_cast<size_t>(info.st_size);
+            if (size > 0)
+            {
+                void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED)
+                {
+                    ::close(fd);
+                    return false;
+                }
+                mapping = mapped;
+                bytes = size;
+            }
+
+            // The mapping stays valid after the descriptor is closed
+            ::close(fd);
+            return true;
+        }
+
+        // FNV-1a over every record byte except the checksum itself
+        uint32_t recordChecksum(const LogRecord &record)
+        {
+            const auto *bytes = reinterpret_cast<const uint8_t *>(&record);
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < sizeof(LogRecord); ++i)
+            {
+                if (i >= offsetof(LogRecord, checksum) && i < offsetof(LogRecord, index))
+                    continue;
+                hash = (hash ^ bytes[i]) * 16777619u;
+            }
+            return hash;
+        }
+
+        // Version 1 headers had no generation field, so only the current layout is accepted
+        bool isValidHeader(const Header &header, uint32_t magic, uint16_t formatVersion)
+        {
+            return header.magic == magic && header.version == formatVersion && header.flags == 0;
+        }
+
+        // Number of leading log records with a valid checksum
+        size_t validRecordCount(const uint8_t *records, size_t bytes)
+        {
+            size_t count = bytes / sizeof(LogRecord);
+            for (size_t i = 0; i < count; ++i)
+            {
+                LogRecord record;
+                std::memcpy(&record, records + i * sizeof(LogRecord), sizeof(LogRecord));
+                if (record.checksum != recordChecksum(record))
+                    return i;
+            }
+            return count;
+        }
+    }
+
+    // SceneFile implementation
+    size_t SceneFile::getSerializedSize(const ShapeStore &store)
+    {
+        return HEADER_BYTES + sizeof(double) * (4 * store.getRectangleCount() + 3 * store.getCircleCount());
+    }
+
+    std::vector<uint8_t> SceneFile::serialize(const ShapeStore &store)
+    {
+        std::vector<uint8_t> bytes(getSerializedSize(store));
+        serialize(store, bytes);
+        return bytes;
+    }
+
+    bool SceneFile::serialize(const ShapeStore &store, std::span<uint8_t> out)
+    {
+        if (out.size() < getSerializedSize(store))
+        {
+            return false;
+        }
+
+        Header header = {MAGIC, FORMAT_VERSION, 0, newGeneration(), store.getRectangleCount(), store.getCircleCount()};
+        std::memcpy(out.data(), &header, sizeof(header));
+        uint8_t *cursor = out.data() + sizeof(header);
+        for (std::span<const double> column :
+             {store.getRectangleXColumn(), store.getRectangleYColumn(), store.getRectangleWidthColumn(),
+              store.getRectangleHeightColumn(), store.getCircleXColumn(), store.getCircleYColumn(),
+              store.getCircleRadiusColumn()})
+        {
+            if (!column.empty())
+                std::memcpy(cursor, column.data(), column.size_bytes());
+            cursor += column.size_bytes();
+        }
+        return true;
+    }
+
+    bool SceneFile::write(const ShapeStore &store, const std::string &path, uint64_t *generation)
+    {
+        std::string temporary = path + ".tmp";
+        int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        // Columns go straight from the store to the file, without a staging copy
+        Header header = {MAGIC, FORMAT_VERSION, 0, newGeneration(), store.getRectangleCount(), store.getCircleCount()};
+        bool ok = writeAll(fd, &header, sizeof(header)) && writeColumn(fd, store.getRectangleXColumn()) &&
+                  writeColumn(fd, store.getRectangleYColumn()) && writeColumn(fd, store.getRectangleWidthColumn()) &&
+                  writeColumn(fd, store.getRectangleHeightColumn()) && writeColumn(fd, store.getCircleXColumn()) &&
+                  writeColumn(fd, store.getCircleYColumn()) && writeColumn(fd, store.getCircleRadiusColumn()) &&
+                  ::fsync(fd) == 0;
+        ok = (::close(fd) == 0) && ok;
+        if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0)
+        {
+            ::unlink(temporary.c_str());
+            return false;
+        }
+        if (!syncParentDirectory(path))
+        {
+            return false;
+        }
+        if (generation)
+        {
+            *generation = header.generation;
+        }
+        return true;
+    }
+
+    bool SceneFile::load(const std::string &path, ShapeStore &store, uint64_t *generation)
+    {
+        MappedScene scene;
+        if (!scene.open(path))
+        {
+            return false;
+        }
+        scene.getView().copyTo(store);
+        if (generation)
+        {
+            *generation = scene.getView().getGeneration();
+        }
+        return true;
+    }
+
+    // SceneView implementation
+    bool SceneView::parse(std::span<const uint8_t> bytes)
+    {
+        *this = SceneView();
+
+        // Spans point straight into the buffer, so byte order and alignment must match
+        if constexpr (std::endian::native != std::endian::little)
+        {
+            return false;
+        }
+        if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(double) != 0 || bytes.size() < sizeof(Header))
+        {
+            return false;
+        }
+
+        Header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (!isValidHeader(header, SceneFile::MAGIC, SceneFile::FORMAT_VERSION))
+        {
+            return false;
+        }
+
+        // Exact length, checked without overflow for hostile counts
+        size_t payload = bytes.size() - sizeof(Header);
+        if (header.rectangles > payload / (4 * sizeof(double)))
+        {
+            return false;
+        }
+        size_t circleBytes = payload - header.rectangles * 4 * sizeof(double);
+        if (header.circles > circleBytes / (3 * sizeof(double)) || circleBytes != header.circles * 3 * sizeof(double))
+        {
+            return false;
+        }
+
+        const double *column = reinterpret_cast<const double *>(bytes.data() + sizeof(Header));
+        size_t rectangles = static_cast<size_t>(header.rectangles);
+        size_t circles = static_cast<size_t>(header.circles);
+        rectX_ = std::span<const double>(column, rectangles);
+        rectY_ = std::span<const double>(column + rectangles, rectangles);
+        rectWidth_ = std::span<const double>(column + 2 * rectangles, rectangles);
+        rectHeight_ = std::span<const double>(column + 3 * rectangles, rectangles);
+        column += 4 * rectangles;
+        circleX_ = std::span<const double>(column, circles);
+        circleY_ = std::span<const double>(column + circles, circles);
+        circleRadius_ = std::span<const double>(column + 2 * circles, circles);
+        version_ = header.version;
+        generation_ = header.generation;
+        return true;
+    }
+
+    double SceneView::totalArea() const
+    {
+        double rectangles = 0.0;
+        for (size_t i = 0; i < rectWidth_.size(); ++i)
+        {
+            rectangles += rectWidth_[i] * rectHeight_[i];
+        }
+
+        double radiusSquared = 0.0;
+        for (double radius : circleRadius_)
+        {
+            radiusSquared += radius * radius;
+        }
+
+        return rectangles + Circle::PI * radiusSquared;
+    }
+
+    double SceneView::totalPerimeter() const
+    {
+        double sides = 0.0;
+        for (size_t i = 0; i < rectWidth_.size(); ++i)
+        {
+            sides += rectWidth_[i] + rectHeight_[i];
+        }
+
+        double radii = 0.0;
+        for (double radius : circleRadius_)
+        {
+            radii += radius;
+        }
+
+        return 2.0 * sides + 2.0 * Circle::PI * radii;
+    }
+
+    BoundingBox SceneView::getBounds() const
+    {
+        if (isEmpty())
+        {
+            return BoundingBox();
+        }
+
+        double minX = std::numeric_limits<double>::infinity();
+        double minY = minX;
+        double maxX = -minX;
+        double maxY = -minX;
+        for (size_t i = 0; i < rectX_.size(); ++i)
+        {
+            minX = std::min(minX, rectX_[i]);
+            minY = std::min(minY, rectY_[i]);
+            maxX = std::max(maxX, rectX_[i] + rectWidth_[i]);
+            maxY = std::max(maxY, rectY_[i] + rectHeight_[i]);
+        }
+        for (size_t i = 0; i < circleX_.size(); ++i)
+        {
+            minX = std::min(minX, circleX_[i] - circleRadius_[i]);
+            minY = std::min(minY, circleY_[i] - circleRadius_[i]);
+            maxX = std::max(maxX, circleX_[i] + circleRadius_[i]);
+            maxY = std::max(maxY, circleY_[i] + circleRadius_[i]);
+        }
+        return BoundingBox(minX, minY, maxX, maxY);
+    }
+
+    void SceneView::query(const BoundingBox &region, std::vector<size_t> &out) const
+    {
+        for (size_t i = 0; i < rectX_.size(); ++i)
+        {
+            BoundingBox box(rectX_[i], rectY_[i], rectX_[i] + rectWidth_[i], rectY_[i] + rectHeight_[i]);
+            if (Intersection::boxBox(box, region))
+                out.push_back(i);
+        }
+        for (size_t i = 0; i < circleX_.size(); ++i)
+        {
+            if (Intersection::circleBox(circleX_[i], circleY_[i], circleRadius_[i], region))
+                out.push_back(rectX_.size() + i);
+        }
+    }
+
+    void SceneView::queryPoint(double x, double y, std::vector<size_t> &out) const
+    {
+        query(BoundingBox(x, y, x, y), out);
+    }
+
+    Rectangle SceneView::rectangleAt(size_t index) const
+    {
+        return Rectangle(rectX_[index], rectY_[index], rectWidth_[index], rectHeight_[index]);
+    }
+
+    Circle SceneView::circleAt(size_t index) const
+    {
+        return Circle(circleX_[index], circleY_[index], circleRadius_[index]);
+    }
+
+    void SceneView::copyTo(ShapeStore &store) const
+    {
+        store.addRectangles(rectX_, rectY_, rectWidth_, rectHeight_);
+        store.addCircles(circleX_, circleY_, circleRadius_);
+    }
+
+    // MappedScene implementation
+    MappedScene::~MappedScene()
+    {
+        close();
+    }
+
+    bool MappedScene::open(const std::string &path)
+    {
+        close();
+
+        void *mapping = nullptr;
+        size_t bytes = 0;
+        if (!mapFile(path, mapping, bytes))
+        {
+            return false;
+        }
+        if (!view_.parse(std::span<const uint8_t>(static_cast<const uint8_t *>(mapping), bytes)))
+        {
+            if (mapping)
+                ::munmap(mapping, bytes);
+            return false;
+        }
+        mapping_ = mapping;
+        mappedBytes_ = bytes;
+        return true;
+    }
+
+    void MappedScene::close()
+    {
+        if (mapping_)
+        {
+            ::munmap(mapping_, mappedBytes_);
+        }
+        mapping_ = nullptr;
+        mappedBytes_ = 0;
+        view_ = SceneView();
+    }
+
+    // SceneLog implementation
+    SceneLog::~SceneLog()
+    {
+        close();
+    }
+
+    bool SceneLog::open(const std::string &path, uint64_t baseGeneration, size_t baseRectangles, size_t baseCircles)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        fileDescriptor_ = fd;
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            close();
+            return false;
+        }
+        if (info.st_size == 0)
+        {
+            if (!writeHeader(baseGeneration, baseRectangles, baseCircles))
+            {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        void *mapping = nullptr;
+        size_t bytes = 0;
+        if (!mapFile(path, mapping, bytes))
+        {
+            close();
+            return false;
+        }
+
+        // Drop a torn tail left by a crash, so new records follow the last good one
+        const auto *data = static_cast<const uint8_t *>(mapping);
+        Header header{};
+        bool ok = bytes >= sizeof(Header);
+        bool stale = false;
+        size_t keep = 0;
+        if (ok)
+        {
+            std::memcpy(&header, data, sizeof(header));
+            ok = isValidHeader(header, MAGIC, FORMAT_VERSION);
+            stale = header.generation != baseGeneration;
+            ok = ok && (stale || (header.rectangles == baseRectangles && header.circles == baseCircles));
+            keep = sizeof(Header) + validRecordCount(data + sizeof(Header), bytes - sizeof(Header)) * RECORD_BYTES;
+        }
+        ::munmap(mapping, bytes);
+        if (ok && stale)
+        {
+            // Left behind by an interrupted compaction; its edits are already in the base
+            ok = reset(baseGeneration, baseRectangles, baseCircles);
+            keep = bytes;
+        }
+        if (!ok || (keep < bytes && ::ftruncate(fd, static_cast<off_t>(keep)) != 0))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void SceneLog::close()
+    {
+        if (fileDescriptor_ >= 0)
+        {
+            flush();
+            ::close(fileDescriptor_);
+        }
+        fileDescriptor_ = -1;
+        pending_.clear();
+    }
+
+    void SceneLog::addRectangle(double x, double y, double width, double height)
+    {
+        append(Operation::AddRectangle, 0, x, y, width, height);
+    }
+
+    void SceneLog::addCircle(double x, double y, double radius)
+    {
+        append(Operation::AddCircle, 0, x, y, radius);
+    }
+
+    void SceneLog::setRectangle(size_t index, double x, double y, double width, double height)
+    {
+        append(Operation::SetRectangle, index, x, y, width, height);
+    }
+
+    void SceneLog::setCircle(size_t index, double x, double y, double radius)
+    {
+        append(Operation::SetCircle, index, x, y, radius);
+    }
+
+    void SceneLog::moveRectangle(size_t index, double dx, double dy)
+    {
+        append(Operation::MoveRectangle, index, dx, dy);
+    }
+
+    void SceneLog::moveCircle(size_t index, double dx, double dy)
+    {
+        append(Operation::MoveCircle, index, dx, dy);
+    }
+
+    bool SceneLog::flush()
+    {
+        if (fileDescriptor_ < 0)
+        {
+            return false;
+        }
+        if (pending_.empty())
+        {
+            return true;
+        }
+
+        // A failed write is rolled back, so the log never keeps half a batch
+        off_t end = ::lseek(fileDescriptor_, 0, SEEK_END);
+        if (end < 0)
+        {
+            return false;
+        }
+        if (!writeAll(fileDescriptor_, pending_.data(), pending_.size()))
+        {
+            ::ftruncate(fileDescriptor_, end);
+            return false;
+        }
+        pending_.clear();
+        return true;
+    }
+
+    bool SceneLog::sync()
+    {
+        return flush() && ::fdatasync(fileDescriptor_) == 0;
+    }
+
+    bool SceneLog::reset(uint64_t baseGeneration, size_t baseRectangles, size_t baseCircles)
+    {
+        if (fileDescriptor_ < 0)
+        {
+            return false;
+        }
+        pending_.clear();
+        return ::ftruncate(fileDescriptor_, 0) == 0 && writeHeader(baseGeneration, baseRectangles, baseCircles) &&
+               ::fdatasync(fileDescriptor_) == 0;
+    }
+
+    bool SceneLog::replay(const std::string &path, uint64_t baseGeneration, ShapeStore &store, size_t *applied)
+    {
+        if (applied)
+        {
+            *applied = 0;
+        }
+        if constexpr (std::endian::native != std::endian::little)
+        {
+            return false;
+        }
+
+        // A log that was never created holds no edits
+        void *mapping = nullptr;
+        size_t bytes = 0;
+        if (!mapFile(path, mapping, bytes))
+        {
+            return errno == ENOENT;
+        }
+
+        const auto *data = static_cast<const uint8_t *>(mapping);
+        Header header{};
+        bool ok = bytes >= sizeof(Header);
+        bool stale = false;
+        if (ok)
+        {
+            std::memcpy(&header, data, sizeof(header));
+            ok = isValidHeader(header, MAGIC, FORMAT_VERSION);
+            stale = header.generation != baseGeneration;
+            ok = ok && (stale || (header.rectangles == store.getRectangleCount() &&
+                                  header.circles == store.getCircleCount()));
+        }
+
+        // A stale log's edits were written for another generation of the scene
+        size_t count = (ok && !stale) ? validRecordCount(data + sizeof(Header), bytes - sizeof(Header)) : 0;
+        for (size_t i = 0; i < count && ok; ++i)
+        {
+            LogRecord record;
+            std::memcpy(&record, data + sizeof(Header) + i * RECORD_BYTES, sizeof(record));
+            const double *v = record.values;
+            bool rectangle = record.index < store.getRectangleCount();
+            bool circle = record.index < store.getCircleCount();
+            switch (static_cast<Operation>(record.operation))
+            {
+            case Operation::AddRectangle:
+                store.addRectangle(v[0], v[1], v[2], v[3]);
+                break;
+            case Operation::AddCircle:
+                store.addCircle(v[0], v[1], v[2]);
+                break;
+            case Operation::SetRectangle:
+                if ((ok = rectangle))
+                    store.setRectangle(record.index, v[0], v[1], v[2], v[3]);
+                break;
+            case Operation::SetCircle:
+                if ((ok = circle))
+                    store.setCircle(record.index, v[0], v[1], v[2]);
+                break;
+            case Operation::MoveRectangle:
+                if ((ok = rectangle))
+                    store.moveRectangle(record.index, v[0], v[1]);
+                break;
+            case Operation::MoveCircle:
+                if ((ok = circle))
+                    store.moveCircle(record.index, v[0], v[1]);
+                break;
+            default:
+                ok = false;
+                break;
+            }
+            if (ok && applied)
+            {
+                ++*applied;
+            }
+        }
+
+        if (mapping)
+        {
+            ::munmap(mapping, bytes);
+        }
+        return ok;
+    }
+
+    void SceneLog::append(Operation operation, uint64_t index, double a, double b, double c, double d)
+    {
+        LogRecord record = {static_cast<uint32_t>(operation), 0, index, {a, b, c, d}};
+        record.checksum = recordChecksum(record);
+        const auto *bytes = reinterpret_cast<const uint8_t *>(&record);
+        pending_.insert(pending_.end(), bytes, bytes + sizeof(record));
+    }
+
+    bool SceneLog::writeHeader(uint64_t baseGeneration, size_t baseRectangles, size_t baseCircles)
+    {
+        Header header = {MAGIC, FORMAT_VERSION, 0, baseGeneration, baseRectangles, baseCircles};
+        return writeAll(fileDescriptor_, &header, sizeof(header));
+    }
+
+} // namespace geometry
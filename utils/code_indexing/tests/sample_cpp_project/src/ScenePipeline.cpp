@@ -0,0 +1,177 @@
+#include "geometry/ScenePipeline.h"
+#include "geometry/DrawSink.h"
+#include "geometry/ShapeManager.h"
+#include "utils/BoundedQueue.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <semaphore>
+#include <thread>
+#include <utility>
+
+namespace geometry
+{
+
+    namespace
+    {
+
+        // A batch tagged with its load order, so the draw stage can restore it
+        struct Ticket
+        {
+            size_t sequence = 0;
+            ScenePipeline::Batch shapes;
+        };
+
+        using TicketQueue = utils::BoundedQueue<Ticket>;
+
+        // Pops from input, applies fn to each ticket and forwards it; the last
+        // worker of the stage to finish closes the output queue
+        template <typename Fn>
+        void runStage(TicketQueue &input, TicketQueue &output, std::atomic<size_t> &activeWorkers, Fn &&fn)
+        {
+            Ticket ticket;
+            while (input.pop(ticket))
+            {
+                fn(ticket.shapes);
+                output.push(std::move(ticket));
+            }
+            if (activeWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                output.close();
+            }
+        }
+
+        // Leaves a core each for the loader, the aggregate workers and the draw stage
+        size_t defaultUpdateWorkers(size_t aggregateWorkers)
+        {
+            size_t reserved = 2 + aggregateWorkers;
+            size_t threads = utils::hardwareThreads();
+            return threads > reserved ? threads - reserved : 1;
+        }
+
+    } // namespace
+
+    ScenePipeline::ScenePipeline() : ScenePipeline(Config())
+    {
+    }
+
+    ScenePipeline::ScenePipeline(const Config &config) : config_(config), batchCount_(0)
+    {
+    }
+
+    void ScenePipeline::run(const Loader &loader, const Updater &update, DrawSink &sink, ShapeManager &scene)
+    {
+        areaStatistics_.clear();
+        batchCount_ = 0;
+
+        size_t aggregateWorkers = std::max<size_t>(config_.aggregateWorkers, 1);
+        size_t updateWorkers = config_.updateWorkers ? config_.updateWorkers : defaultUpdateWorkers(aggregateWorkers);
+        size_t maxInFlight =
+            config_.maxInFlight ? config_.maxInFlight : 4 * std::max<size_t>(config_.queueCapacity, 1);
+
+        TicketQueue loaded(config_.queueCapacity);
+        TicketQueue updated(config_.queueCapacity);
+        TicketQueue aggregated(config_.queueCapacity);
+        std::atomic<size_t> activeUpdaters(updateWorkers);
+        std::atomic<size_t> activeAggregators(aggregateWorkers);
+        std::vector<utils::StatisticsCalculator> areas(aggregateWorkers);
+
+        // One credit per batch between loading and drawing; the draw stage can
+        // only hold back batches that also hold a credit
+        std::counting_semaphore<> credits(static_cast<std::ptrdiff_t>(maxInFlight));
+
+        std::vector<std::thread> workers;
+        workers.reserve(1 + updateWorkers + aggregateWorkers);
+
+        // Load stage: the loader runs on one thread, so it need not be thread-safe
+        workers.emplace_back([&]()
+                             {
+                                 for (size_t sequence = 0;; ++sequence)
+                                 {
+                                     Ticket ticket;
+                                     ticket.sequence = sequence;
+                                     credits.acquire();
+                                     if (!loader(ticket.shapes))
+                                         break;
+                                     loaded.push(std::move(ticket));
+                                 }
+                                 loaded.close(); });
+
+        // Update stage
+        for (size_t worker = 0; worker < updateWorkers; ++worker)
+        {
+            workers.emplace_back([&]()
+                                 { runStage(loaded, updated, activeUpdaters, [&update](Batch &shapes)
+                                            {
+                                                if (!update)
+                                                    return;
+                                                for (auto &shape : shapes)
+                                                {
+                                                    update(*shape);
+                                                }
+                                            }); });
+        }
+
+        // Aggregate stage: one calculator per worker, merged after the run
+        for (size_t worker = 0; worker < aggregateWorkers; ++worker)
+        {
+            workers.emplace_back([&, worker]()
+                                 { runStage(updated, aggregated, activeAggregators, [&areas, worker](Batch &shapes)
+                                            {
+                                                for (const auto &shape : shapes)
+                                                {
+                                                    areas[worker].addValue(shape->area());
+                                                }
+                                            }); });
+        }
+
+        // Draw stage: sinks are not thread-safe, so it stays on the calling thread
+        // and reorders batches that overtook each other in the worker pools
+        std::map<size_t, Batch> pending;
+        size_t nextSequence = 0;
+        auto drawBatch = [&](Batch &shapes)
+        {
+            for (const auto &shape : shapes)
+            {
+                shape->draw(sink);
+            }
+            sink.flush();
+            for (auto &shape : shapes)
+            {
+                scene.addShape(std::move(shape));
+            }
+            ++batchCount_;
+            ++nextSequence;
+            credits.release();
+        };
+
+        Ticket ticket;
+        while (aggregated.pop(ticket))
+        {
+            if (ticket.sequence != nextSequence)
+            {
+                pending.emplace(ticket.sequence, std::move(ticket.shapes));
+                continue;
+            }
+            drawBatch(ticket.shapes);
+            for (auto next = pending.begin(); next != pending.end() && next->first == nextSequence;)
+            {
+                drawBatch(next->second);
+                next = pending.erase(next);
+            }
+        }
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        areaStatistics_ = std::move(areas.front());
+        for (size_t worker = 1; worker < aggregateWorkers; ++worker)
+        {
+            areaStatistics_.merge(areas[worker]);
+        }
+    }
+
+} // namespace geometry
@@ -1,4 +1,7 @@
 #include "geometry/Shape.h"
+#include "geometry/DrawSink.h"
+#include "geometry/Intersection.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -10,16 +13,106 @@ namespace geometry
     {
     }
 
+    Shape::~Shape()
+    {
+        // Observers may unsubscribe while being told, so notify from a detached list
+        std::vector<ShapeObserver *> observers = std::move(observers_);
+        for (ShapeObserver *observer : observers)
+        {
+            observer->shapeDestroyed(*this);
+        }
+    }
+
+    Shape::Shape(const Shape &other) : x_(other.x_), y_(other.y_)
+    {
+    }
+
+    Shape &Shape::operator=(const Shape &other)
+    {
+        x_ = other.x_;
+        y_ = other.y_;
+        notifyChanged();
+        return *this;
+    }
+
+    void Shape::draw(DrawSink &) const
+    {
+        draw();
+    }
+
+    BoundingBox Shape::bounds() const
+    {
+        return BoundingBox(x_, y_, x_, y_);
+    }
+
+    bool Shape::contains(double x, double y) const
+    {
+        return bounds().contains(x, y);
+    }
+
+    double Shape::distanceTo(double x, double y) const
+    {
+        return bounds().distanceTo(x, y);
+    }
+
+    bool Shape::intersects(const Shape &other) const
+    {
+        return bounds().intersects(other.bounds());
+    }
+
+    bool Shape::intersects(const Rectangle &rectangle) const
+    {
+        return bounds().intersects(rectangle.bounds());
+    }
+
+    bool Shape::intersects(const Circle &circle) const
+    {
+        return Intersection::circleBox(circle.getX(), circle.getY(), circle.getRadius(), bounds());
+    }
+
+    bool Shape::intersects(const BoundingBox &box) const
+    {
+        return Intersection::boxBox(bounds(), box);
+    }
+
     void Shape::move(double dx, double dy)
     {
         x_ += dx;
         y_ += dy;
+        notifyChanged();
     }
 
     void Shape::setPosition(double x, double y)
     {
         x_ = x;
         y_ = y;
+        notifyChanged();
+    }
+
+    void Shape::addObserver(ShapeObserver *observer)
+    {
+        if (observer && !hasObserver(observer))
+            observers_.push_back(observer);
+    }
+
+    void Shape::removeObserver(ShapeObserver *observer)
+    {
+        auto found = std::find(observers_.begin(), observers_.end(), observer);
+        if (found != observers_.end())
+            observers_.erase(found);
+    }
+
+    bool Shape::hasObserver(const ShapeObserver *observer) const
+    {
+        return std::find(observers_.begin(), observers_.end(), observer) != observers_.end();
+    }
+
+    void Shape::notifyChanged()
+    {
+        for (size_t i = 0; i < observers_.size(); ++i)
+        {
+            observers_[i]->shapeChanged(*this);
+        }
     }
 
     // Rectangle implementation
@@ -32,26 +125,58 @@ namespace geometry
             height_ = MIN_SIZE;
     }
 
-    double Rectangle::area() const
+    Rectangle &Rectangle::operator=(const Rectangle &other)
     {
-        return width_ * height_;
+        // Copy the extent first so the base assignment notifies with the final geometry
+        width_ = other.width_;
+        height_ = other.height_;
+        Shape::operator=(other);
+        return *this;
     }
 
-    double Rectangle::perimeter() const
+    void Rectangle::draw() const
     {
-        return 2.0 * (width_ + height_);
+        TextDrawSink sink(std::cout);
+        draw(sink);
+        sink.flush();
     }
 
-    void Rectangle::draw() const
+    void Rectangle::draw(DrawSink &sink) const
     {
-        std::cout << "Drawing rectangle at (" << getX() << ", " << getY()
-                  << ") with width " << width_ << " and height " << height_ << std::endl;
+        sink.drawRectangle(getX(), getY(), width_, height_);
+    }
+
+    BoundingBox Rectangle::bounds() const
+    {
+        return BoundingBox(getX(), getY(), getX() + width_, getY() + height_);
+    }
+
+    bool Rectangle::intersects(const Shape &other) const
+    {
+        // Let the other shape's type pick the exact test against a rectangle
+        return other.intersects(*this);
+    }
+
+    bool Rectangle::intersects(const Rectangle &rectangle) const
+    {
+        return Intersection::boxBox(bounds(), rectangle.bounds());
+    }
+
+    bool Rectangle::intersects(const Circle &circle) const
+    {
+        return Intersection::circleBox(circle.getX(), circle.getY(), circle.getRadius(), bounds());
+    }
+
+    bool Rectangle::intersects(const BoundingBox &box) const
+    {
+        return Intersection::boxBox(bounds(), box);
     }
 
     void Rectangle::resize(double newWidth, double newHeight)
     {
         width_ = (newWidth > MIN_SIZE) ? newWidth : MIN_SIZE;
         height_ = (newHeight > MIN_SIZE) ? newHeight : MIN_SIZE;
+        notifyChanged();
     }
 
     bool Rectangle::isSquare() const
@@ -67,25 +192,67 @@ namespace geometry
             radius_ = 0.0;
     }
 
-    double Circle::area() const
+    Circle &Circle::operator=(const Circle &other)
     {
-        return PI * radius_ * radius_;
+        radius_ = other.radius_;
+        Shape::operator=(other);
+        return *this;
     }
 
-    double Circle::perimeter() const
+    void Circle::draw() const
     {
-        return 2.0 * PI * radius_;
+        TextDrawSink sink(std::cout);
+        draw(sink);
+        sink.flush();
     }
 
-    void Circle::draw() const
+    void Circle::draw(DrawSink &sink) const
+    {
+        sink.drawCircle(getX(), getY(), radius_);
+    }
+
+    BoundingBox Circle::bounds() const
+    {
+        return BoundingBox(getX() - radius_, getY() - radius_, getX() + radius_, getY() + radius_);
+    }
+
+    bool Circle::contains(double x, double y) const
+    {
+        double dx = x - getX();
+        double dy = y - getY();
+        return dx * dx + dy * dy <= radius_ * radius_;
+    }
+
+    double Circle::distanceTo(double x, double y) const
+    {
+        double distance = std::hypot(x - getX(), y - getY()) - radius_;
+        return (distance > 0.0) ? distance : 0.0;
+    }
+
+    bool Circle::intersects(const Shape &other) const
+    {
+        return other.intersects(*this);
+    }
+
+    bool Circle::intersects(const Rectangle &rectangle) const
+    {
+        return Intersection::circleBox(getX(), getY(), radius_, rectangle.bounds());
+    }
+
+    bool Circle::intersects(const Circle &circle) const
+    {
+        return Intersection::circleCircle(getX(), getY(), radius_, circle.getX(), circle.getY(), circle.getRadius());
+    }
+
+    bool Circle::intersects(const BoundingBox &box) const
     {
-        std::cout << "Drawing circle at (" << getX() << ", " << getY()
-                  << ") with radius " << radius_ << std::endl;
+        return Intersection::circleBox(getX(), getY(), radius_, box);
     }
 
     void Circle::setRadius(double newRadius)
     {
         radius_ = (newRadius >= 0.0) ? newRadius : 0.0;
+        notifyChanged();
     }
 
 } // namespace geometry
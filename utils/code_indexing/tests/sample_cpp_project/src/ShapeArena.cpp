@@ -0,0 +1,29 @@
+#include "geometry/ShapeArena.h"
+
+namespace geometry
+{
+
+    ShapeArena::ShapeArena(size_t initialBytes, std::pmr::memory_resource *upstream)
+        : buffer_(std::make_unique<std::byte[]>(initialBytes > 0 ? initialBytes : 1)),
+          resource_(buffer_.get(), initialBytes > 0 ? initialBytes : 1, upstream)
+    {
+    }
+
+    ShapeArena::~ShapeArena()
+    {
+        reset();
+    }
+
+    void ShapeArena::reset()
+    {
+        for (Shape *shape : shapes_)
+        {
+            shape->~Shape();
+        }
+
+        // Keeps the shape list's capacity and the initial buffer for the next scene
+        shapes_.clear();
+        resource_.release();
+    }
+
+} // namespace geometry
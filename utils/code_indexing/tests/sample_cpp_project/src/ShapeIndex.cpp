@@ -0,0 +1,112 @@
+#include "geometry/ShapeIndex.h"
+#include <algorithm>
+
+namespace geometry
+{
+
+    ShapeIndex::ShapeIndex(std::unique_ptr<SpatialIndex> index) : index_(std::move(index))
+    {
+    }
+
+    ShapeIndex::~ShapeIndex()
+    {
+        clear();
+    }
+
+    void ShapeIndex::add(Shape &shape)
+    {
+        if (contains(shape))
+            return;
+
+        size_t id = index_->insert(shape.bounds());
+        if (id >= shapes_.size())
+            shapes_.resize(id + 1, nullptr);
+        shapes_[id] = &shape;
+        ids_.emplace(&shape, id);
+        shape.addObserver(this);
+    }
+
+    void ShapeIndex::remove(Shape &shape)
+    {
+        auto entry = ids_.find(&shape);
+        if (entry == ids_.end())
+            return;
+
+        index_->remove(entry->second);
+        shapes_[entry->second] = nullptr;
+        ids_.erase(entry);
+        shape.removeObserver(this);
+    }
+
+    void ShapeIndex::clear()
+    {
+        for (const auto &[shape, id] : ids_)
+        {
+            shapes_[id]->removeObserver(this);
+        }
+        ids_.clear();
+        shapes_.clear();
+        index_->clear();
+    }
+
+    std::vector<Shape *> ShapeIndex::query(const BoundingBox &region) const
+    {
+        std::vector<size_t> ids;
+        index_->query(region, ids);
+
+        std::vector<Shape *> hits = resolve(ids);
+        hits.erase(std::remove_if(hits.begin(), hits.end(),
+                                  [&region](const Shape *shape) { return !shape->intersects(region); }),
+                   hits.end());
+        return hits;
+    }
+
+    std::vector<Shape *> ShapeIndex::queryPoint(double x, double y) const
+    {
+        std::vector<size_t> ids;
+        index_->queryPoint(x, y, ids);
+
+        std::vector<Shape *> hits = resolve(ids);
+        hits.erase(std::remove_if(hits.begin(), hits.end(),
+                                  [x, y](const Shape *shape) { return !shape->contains(x, y); }),
+                   hits.end());
+        return hits;
+    }
+
+    std::vector<Shape *> ShapeIndex::nearest(double x, double y, size_t k) const
+    {
+        std::vector<size_t> ids;
+        index_->nearest(x, y, k, ids, [this, x, y](size_t id) { return shapes_[id]->distanceTo(x, y); });
+        return resolve(ids);
+    }
+
+    void ShapeIndex::shapeChanged(const Shape &shape)
+    {
+        auto entry = ids_.find(&shape);
+        if (entry != ids_.end())
+            index_->update(entry->second, shape.bounds());
+    }
+
+    void ShapeIndex::shapeDestroyed(const Shape &shape)
+    {
+        auto entry = ids_.find(&shape);
+        if (entry == ids_.end())
+            return;
+
+        index_->remove(entry->second);
+        shapes_[entry->second] = nullptr;
+        ids_.erase(entry);
+    }
+
+    std::vector<Shape *> ShapeIndex::resolve(const std::vector<size_t> &ids) const
+    {
+        std::vector<Shape *> result;
+        result.reserve(ids.size());
+        for (size_t id : ids)
+        {
+            result.push_back(shapes_[id]);
+        }
+        return result;
+    }
+
+} // namespace geometry
@@ -0,0 +1,220 @@
+#include "geometry/ShapeManager.h"
+#include "geometry/DrawSink.h"
+#include "utils/Instrumentation.h"
+#include <cmath>
+#include <iostream>
+
+namespace geometry
+{
+
+    // Instrumentation probes
+    UTILS_DEFINE_COUNTER(shapesDrawn, "shapes_drawn_total", "Shapes drawn by ShapeManager::drawAll");
+    UTILS_DEFINE_COUNTER(areaCalls, "shape_area_calls_total", "Virtual area() calls made by ShapeManager");
+    UTILS_DEFINE_COUNTER(boundsRebuilds, "shape_bounds_rebuilds_total", "Full rebuilds of the cached ShapeManager bounds");
+    UTILS_DEFINE_TIMER(drawAllTimer, "shape_draw_all_seconds", "Time spent in ShapeManager::drawAll, including the flush");
+
+    namespace
+    {
+        bool touchesEdge(const BoundingBox &box, const BoundingBox &outer)
+        {
+            return box.minX <= outer.minX || box.minY <= outer.minY ||
+                   box.maxX >= outer.maxX || box.maxY >= outer.maxY;
+        }
+
+        // True if a box that defined an edge of outer no longer reaches it
+        bool leavesEdge(const BoundingBox &old, const BoundingBox &current, const BoundingBox &outer)
+        {
+            return (old.minX <= outer.minX && current.minX > old.minX) ||
+                   (old.minY <= outer.minY && current.minY > old.minY) ||
+                   (old.maxX >= outer.maxX && current.maxX < old.maxX) ||
+                   (old.maxY >= outer.maxY && current.maxY < old.maxY);
+        }
+    }
+
+    void ShapeManager::RunningSum::add(double value)
+    {
+        double sum = sum_ + value;
+        if (std::fabs(sum_) >= std::fabs(value))
+            compensation_ += (sum_ - sum) + value;
+        else
+            compensation_ += (value - sum) + sum_;
+        sum_ = sum;
+    }
+
+    ShapeManager::~ShapeManager()
+    {
+        clear();
+    }
+
+    void ShapeManager::addShape(std::unique_ptr<Shape> shape)
+    {
+        if (!shape)
+        {
+            return;
+        }
+
+        UTILS_COUNT(areaCalls, 1);
+        Entry entry{std::move(shape), 0.0, 0.0, BoundingBox()};
+        entry.area = entry.shape->area();
+        entry.perimeter = entry.shape->perimeter();
+        entry.bounds = entry.shape->bounds();
+
+        totalArea_.add(entry.area);
+        totalPerimeter_.add(entry.perimeter);
+        extendBounds(entry.bounds);
+
+        entry.shape->addObserver(this);
+        positions_.emplace(entry.shape.get(), shapes_.size());
+        shapes_.push_back(std::move(entry));
+    }
+
+    std::unique_ptr<Shape> ShapeManager::removeShape(const Shape &shape)
+    {
+        auto position = positions_.find(&shape);
+        if (position == positions_.end())
+        {
+            return nullptr;
+        }
+
+        std::unique_ptr<Shape> removed = detach(position->second);
+        removed->removeObserver(this);
+        return removed;
+    }
+
+    void ShapeManager::clear()
+    {
+        // Unsubscribe before destroying so only the shapes' other observers
+        // (e.g. a ShapeIndex) hear about it
+        for (Entry &entry : shapes_)
+        {
+            entry.shape->removeObserver(this);
+        }
+        shapes_.clear();
+        positions_.clear();
+        totalArea_.reset();
+        totalPerimeter_.reset();
+        bounds_ = BoundingBox();
+        boundsDirty_ = false;
+    }
+
+    void ShapeManager::drawAll() const
+    {
+        TextDrawSink sink(std::cout);
+        drawAll(sink);
+    }
+
+    void ShapeManager::drawAll(DrawSink &sink) const
+    {
+        UTILS_SCOPED_TIMER(drawAllTimer);
+        UTILS_COUNT(shapesDrawn, shapes_.size());
+
+        for (const Entry &entry : shapes_)
+        {
+            entry.shape->draw(sink);
+        }
+        sink.flush();
+    }
+
+    BoundingBox ShapeManager::getBounds() const
+    {
+        if (boundsDirty_)
+        {
+            UTILS_COUNT(boundsRebuilds, 1);
+            bounds_ = shapes_.front().bounds;
+            for (const Entry &entry : shapes_)
+            {
+                bounds_ = bounds_.merged(entry.bounds);
+            }
+            boundsDirty_ = false;
+        }
+        return bounds_;
+    }
+
+    void ShapeManager::shapeChanged(const Shape &shape)
+    {
+        auto position = positions_.find(&shape);
+        if (position == positions_.end())
+        {
+            return;
+        }
+
+        UTILS_COUNT(areaCalls, 1);
+        Entry &entry = shapes_[position->second];
+        double area = shape.area();
+        double perimeter = shape.perimeter();
+        BoundingBox bounds = shape.bounds();
+
+        totalArea_.add(area - entry.area);
+        totalPerimeter_.add(perimeter - entry.perimeter);
+        updateBounds(entry.bounds, bounds);
+
+        entry.area = area;
+        entry.perimeter = perimeter;
+        entry.bounds = bounds;
+    }
+
+    void ShapeManager::shapeDestroyed(const Shape &shape)
+    {
+        // Only reachable if an owned shape was deleted behind the manager's back
+        auto position = positions_.find(&shape);
+        if (position != positions_.end())
+        {
+            detach(position->second).release();
+        }
+    }
+
+    void ShapeManager::retractBounds(const BoundingBox &old)
+    {
+        // Bounds can only be shrunk by a rebuild
+        if (!boundsDirty_ && touchesEdge(old, bounds_))
+        {
+            boundsDirty_ = true;
+        }
+    }
+
+    void ShapeManager::updateBounds(const BoundingBox &old, const BoundingBox &current)
+    {
+        // Growing in place only extends; a rebuild is needed once an edge moves inward
+        if (!boundsDirty_ && leavesEdge(old, current, bounds_))
+        {
+            boundsDirty_ = true;
+        }
+        extendBounds(current);
+    }
+
+    void ShapeManager::extendBounds(const BoundingBox &added)
+    {
+        if (boundsDirty_)
+        {
+            return;
+        }
+        bounds_ = shapes_.empty() ? added : bounds_.merged(added);
+    }
+
+    std::unique_ptr<Shape> ShapeManager::detach(size_t position)
+    {
+        Entry &entry = shapes_[position];
+        totalArea_.add(-entry.area);
+        totalPerimeter_.add(-entry.perimeter);
+        retractBounds(entry.bounds);
+
+        // Erase in place so the remaining shapes keep their draw order
+        std::unique_ptr<Shape> removed = std::move(entry.shape);
+        positions_.erase(removed.get());
+        shapes_.erase(shapes_.begin() + static_cast<std::ptrdiff_t>(position));
+        for (size_t i = position; i < shapes_.size(); ++i)
+        {
+            positions_[shapes_[i].shape.get()] = i;
+        }
+
+        if (shapes_.empty())
+        {
+            bounds_ = BoundingBox();
+            boundsDirty_ = false;
+            totalArea_.reset();
+            totalPerimeter_.reset();
+        }
+        return removed;
+    }
+
+} // namespace geometry
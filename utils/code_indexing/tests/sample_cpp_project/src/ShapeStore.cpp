@@ -0,0 +1,254 @@
+#include "geometry/ShapeStore.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+
+namespace geometry
+{
+
+    namespace
+    {
+        // Splits store-order ranges of [0, count) into the rectangle and circle
+        // index ranges they cover: kernel(rectBegin, rectEnd, circleBegin, circleEnd)
+        template <typename Kernel>
+        void forStoreRanges(size_t count, size_t rectangleCount, Kernel &&kernel)
+        {
+            utils::parallelFor(count, ShapeStore::PARALLEL_CHUNK, [&](size_t begin, size_t end)
+            {
+                kernel(std::min(begin, rectangleCount), std::min(end, rectangleCount),
+                       std::max(begin, rectangleCount) - rectangleCount,
+                       std::max(end, rectangleCount) - rectangleCount);
+            });
+        }
+    }
+
+    size_t ShapeStore::addRectangle(double x, double y, double width, double height)
+    {
+        rectX_.push_back(x);
+        rectY_.push_back(y);
+        rectWidth_.push_back((width < Rectangle::MIN_SIZE) ? Rectangle::MIN_SIZE : width);
+        rectHeight_.push_back((height < Rectangle::MIN_SIZE) ? Rectangle::MIN_SIZE : height);
+        return rectX_.size() - 1;
+    }
+
+    size_t ShapeStore::addCircle(double x, double y, double radius)
+    {
+        circleX_.push_back(x);
+        circleY_.push_back(y);
+        circleRadius_.push_back((radius < 0.0) ? 0.0 : radius);
+        return circleX_.size() - 1;
+    }
+
+    size_t ShapeStore::add(const Rectangle &rectangle)
+    {
+        return addRectangle(rectangle.getX(), rectangle.getY(),
+                            rectangle.getWidth(), rectangle.getHeight());
+    }
+
+    size_t ShapeStore::add(const Circle &circle)
+    {
+        return addCircle(circle.getX(), circle.getY(), circle.getRadius());
+    }
+
+    void ShapeStore::reserve(size_t rectangles, size_t circles)
+    {
+        rectX_.reserve(rectangles);
+        rectY_.reserve(rectangles);
+        rectWidth_.reserve(rectangles);
+        rectHeight_.reserve(rectangles);
+
+        circleX_.reserve(circles);
+        circleY_.reserve(circles);
+        circleRadius_.reserve(circles);
+    }
+
+    void ShapeStore::clear()
+    {
+        rectX_.clear();
+        rectY_.clear();
+        rectWidth_.clear();
+        rectHeight_.clear();
+
+        circleX_.clear();
+        circleY_.clear();
+        circleRadius_.clear();
+    }
+
+    void ShapeStore::addRectangles(std::span<const double> x, std::span<const double> y,
+                                   std::span<const double> width, std::span<const double> height)
+    {
+        size_t count = std::min({x.size(), y.size(), width.size(), height.size()});
+        size_t first = rectX_.size();
+        rectX_.insert(rectX_.end(), x.begin(), x.begin() + count);
+        rectY_.insert(rectY_.end(), y.begin(), y.begin() + count);
+        rectWidth_.insert(rectWidth_.end(), width.begin(), width.begin() + count);
+        rectHeight_.insert(rectHeight_.end(), height.begin(), height.begin() + count);
+        for (size_t i = first; i < rectX_.size(); ++i)
+        {
+            rectWidth_[i] = (rectWidth_[i] < Rectangle::MIN_SIZE) ? Rectangle::MIN_SIZE : rectWidth_[i];
+            rectHeight_[i] = (rectHeight_[i] < Rectangle::MIN_SIZE) ? Rectangle::MIN_SIZE : rectHeight_[i];
+        }
+    }
+
+    void ShapeStore::addCircles(std::span<const double> x, std::span<const double> y, std::span<const double> radius)
+    {
+        size_t count = std::min({x.size(), y.size(), radius.size()});
+        size_t first = circleX_.size();
+        circleX_.insert(circleX_.end(), x.begin(), x.begin() + count);
+        circleY_.insert(circleY_.end(), y.begin(), y.begin() + count);
+        circleRadius_.insert(circleRadius_.end(), radius.begin(), radius.begin() + count);
+        for (size_t i = first; i < circleX_.size(); ++i)
+        {
+            circleRadius_[i] = (circleRadius_[i] < 0.0) ? 0.0 : circleRadius_[i];
+        }
+    }
+
+    void ShapeStore::setRectangle(size_t index, double x, double y, double width, double height)
+    {
+        rectX_[index] = x;
+        rectY_[index] = y;
+        rectWidth_[index] = (width < Rectangle::MIN_SIZE) ? Rectangle::MIN_SIZE : width;
+        rectHeight_[index] = (height < Rectangle::MIN_SIZE) ? Rectangle::MIN_SIZE : height;
+    }
+
+    void ShapeStore::setCircle(size_t index, double x, double y, double radius)
+    {
+        circleX_[index] = x;
+        circleY_[index] = y;
+        circleRadius_[index] = (radius < 0.0) ? 0.0 : radius;
+    }
+
+    void ShapeStore::moveRectangle(size_t index, double dx, double dy)
+    {
+        rectX_[index] += dx;
+        rectY_[index] += dy;
+    }
+
+    void ShapeStore::moveCircle(size_t index, double dx, double dy)
+    {
+        circleX_[index] += dx;
+        circleY_[index] += dy;
+    }
+
+    double ShapeStore::totalArea() const
+    {
+        double rectangles = 0.0;
+        const size_t rectangleCount = rectWidth_.size();
+        for (size_t i = 0; i < rectangleCount; ++i)
+        {
+            rectangles += rectWidth_[i] * rectHeight_[i];
+        }
+
+        double radiusSquared = 0.0;
+        for (double radius : circleRadius_)
+        {
+            radiusSquared += radius * radius;
+        }
+
+        return rectangles + Circle::PI * radiusSquared;
+    }
+
+    double ShapeStore::totalPerimeter() const
+    {
+        double sides = 0.0;
+        const size_t rectangleCount = rectWidth_.size();
+        for (size_t i = 0; i < rectangleCount; ++i)
+        {
+            sides += rectWidth_[i] + rectHeight_[i];
+        }
+
+        double radii = 0.0;
+        for (double radius : circleRadius_)
+        {
+            radii += radius;
+        }
+
+        return 2.0 * sides + 2.0 * Circle::PI * radii;
+    }
+
+    void ShapeStore::moveAll(double dx, double dy)
+    {
+        const size_t rectangleCount = rectX_.size();
+        forStoreRanges(getShapeCount(), rectangleCount,
+                       [&](size_t rectBegin, size_t rectEnd, size_t circleBegin, size_t circleEnd)
+        {
+            for (size_t i = rectBegin; i < rectEnd; ++i)
+            {
+                rectX_[i] += dx;
+                rectY_[i] += dy;
+            }
+            for (size_t i = circleBegin; i < circleEnd; ++i)
+            {
+                circleX_[i] += dx;
+                circleY_[i] += dy;
+            }
+        });
+    }
+
+    void ShapeStore::moveAll(std::span<const utils::Vec2d> deltas)
+    {
+        const size_t rectangleCount = rectX_.size();
+        const utils::Vec2d *delta = deltas.data();
+        forStoreRanges(std::min(getShapeCount(), deltas.size()), rectangleCount,
+                       [&](size_t rectBegin, size_t rectEnd, size_t circleBegin, size_t circleEnd)
+        {
+            for (size_t i = rectBegin; i < rectEnd; ++i)
+            {
+                rectX_[i] += delta[i].x;
+                rectY_[i] += delta[i].y;
+            }
+            // Indexed from the span start: delta + rectangleCount may lie past a short span
+            for (size_t i = circleBegin; i < circleEnd; ++i)
+            {
+                circleX_[i] += delta[rectangleCount + i].x;
+                circleY_[i] += delta[rectangleCount + i].y;
+            }
+        });
+    }
+
+    void ShapeStore::areas(std::span<double> out) const
+    {
+        const size_t rectangleCount = rectX_.size();
+        double *result = out.data();
+        forStoreRanges(std::min(getShapeCount(), out.size()), rectangleCount,
+                       [&](size_t rectBegin, size_t rectEnd, size_t circleBegin, size_t circleEnd)
+        {
+            for (size_t i = rectBegin; i < rectEnd; ++i)
+            {
+                result[i] = rectWidth_[i] * rectHeight_[i];
+            }
+            for (size_t i = circleBegin; i < circleEnd; ++i)
+            {
+                result[rectangleCount + i] = Circle::PI * circleRadius_[i] * circleRadius_[i];
+            }
+        });
+    }
+
+    void ShapeStore::perimeters(std::span<double> out) const
+    {
+        const size_t rectangleCount = rectX_.size();
+        double *result = out.data();
+        forStoreRanges(std::min(getShapeCount(), out.size()), rectangleCount,
+                       [&](size_t rectBegin, size_t rectEnd, size_t circleBegin, size_t circleEnd)
+        {
+            for (size_t i = rectBegin; i < rectEnd; ++i)
+            {
+                result[i] = 2.0 * (rectWidth_[i] + rectHeight_[i]);
+            }
+            for (size_t i = circleBegin; i < circleEnd; ++i)
+            {
+                result[rectangleCount + i] = 2.0 * Circle::PI * circleRadius_[i];
+            }
+        });
+    }
+
+    Rectangle ShapeStore::rectangleAt(size_t index) const
+    {
+        return Rectangle(rectX_[index], rectY_[index], rectWidth_[index], rectHeight_[index]);
+    }
+
+    Circle ShapeStore::circleAt(size_t index) const
+    {
+        return Circle(circleX_[index], circleY_[index], circleRadius_[index]);
+    }
+
+} // namespace geometry
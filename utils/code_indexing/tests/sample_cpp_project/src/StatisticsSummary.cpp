@@ -0,0 +1,431 @@
+#include "utils/StatisticsSummary.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace utils
+{
+
+    namespace
+    {
+        constexpr size_t HEADER_BYTES = 8;
+        constexpr size_t MOMENTS_BYTES = 5 * 8;
+        constexpr size_t HISTOGRAM_HEADER_BYTES = 8 + 5 * 8;
+
+        // Appends fixed-size fields to a buffer already sized by getSerializedSize()
+        class ByteWriter
+        {
+        public:
+            explicit ByteWriter(uint8_t *out) : out_(out) {}
+
+            template <typename T>
+            void write(T value)
+            {
+                std::memcpy(out_, &value, sizeof(T));
+                out_ += sizeof(T);
+            }
+
+            void write(std::span<const double> values)
+            {
+                if (!values.empty())
+                    std::memcpy(out_, values.data(), values.size_bytes());
+                out_ += values.size_bytes();
+            }
+
+        private:
+            uint8_t *out_;
+        };
+
+        // Bounds-checked reads; once a read fails every later read fails too
+        class ByteReader
+        {
+        public:
+            explicit ByteReader(std::span<const uint8_t> bytes) : bytes_(bytes), offset_(0), ok_(true) {}
+
+            template <typename T>
+            T read()
+            {
+                T value{};
+                if (ok_ && bytes_.size() - offset_ >= sizeof(T))
+                    std::memcpy(&value, bytes_.data() + offset_, sizeof(T));
+                else
+                    ok_ = false;
+                offset_ += ok_ ? sizeof(T) : 0;
+                return value;
+            }
+
+            // Span over count doubles in place (the buffer start is 8-byte aligned)
+            std::span<const double> readDoubles(uint64_t count)
+            {
+                if (!ok_ || count > (bytes_.size() - offset_) / sizeof(double))
+                {
+                    ok_ = false;
+                    return {};
+                }
+                const double *values = reinterpret_cast<const double *>(bytes_.data() + offset_);
+                offset_ += count * sizeof(double);
+                return std::span<const double>(values, count);
+            }
+
+            bool isOk() const { return ok_; }
+            bool isAtEnd() const { return offset_ == bytes_.size(); }
+
+        private:
+            std::span<const uint8_t> bytes_;
+            size_t offset_;
+            bool ok_;
+        };
+
+        bool makeHistogram(Histogram::Scale scale, double minimum, double maximum, size_t bins,
+                           unsigned subBucketBits, std::optional<Histogram> &out)
+        {
+            switch (scale)
+            {
+            case Histogram::Scale::Linear:
+                out = Histogram::linear(minimum, maximum, bins);
+                break;
+            case Histogram::Scale::Logarithmic:
+                out = Histogram::logarithmic(minimum, maximum, bins);
+                break;
+            case Histogram::Scale::LogLinear:
+                out = Histogram::logLinear(minimum, maximum, subBucketBits);
+                break;
+            }
+
+            // The factories normalize degenerate ranges; a round trip must reproduce the layout exactly
+            return out->getMinimum() == minimum && out->getMaximum() == maximum &&
+                   out->getBinCount() == bins && out->getSubBucketBits() == subBucketBits;
+        }
+
+        // Moments and sketch must describe the same samples: finite extremes in
+        // order, level weights (size << level) adding up to the count, and every
+        // retained item within the extremes (which also rules out NaN)
+        bool isConsistent(const SampleMoments &moments, std::span<const std::span<const double>> levels)
+        {
+            if (!std::isfinite(moments.mean) || !std::isfinite(moments.sumSquaredDiff) ||
+                !std::isfinite(moments.minimum) || !std::isfinite(moments.maximum) ||
+                moments.minimum > moments.maximum)
+            {
+                return false;
+            }
+
+            uint64_t weight = 0;
+            for (size_t level = 0; level < levels.size(); ++level)
+            {
+                uint64_t size = levels[level].size();
+                if (size > (UINT64_MAX - weight) >> level)
+                {
+                    return false;
+                }
+                weight += size << level;
+
+                for (double item : levels[level])
+                {
+                    if (!(item >= moments.minimum && item <= moments.maximum))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return weight == moments.count;
+        }
+    }
+
+    // StatisticsSummary implementation
+    StatisticsSummary::StatisticsSummary(size_t sketchK) : sketch_(sketchK)
+    {
+    }
+
+    void StatisticsSummary::addValue(double value)
+    {
+        SampleMoments single;
+        single.count = 1;
+        single.mean = value;
+        single.minimum = value;
+        single.maximum = value;
+        moments_.merge(single);
+
+        sketch_.add(value);
+        if (histogram_)
+            histogram_->add(value);
+    }
+
+    void StatisticsSummary::addValues(std::span<const double> values)
+    {
+        moments_.merge(ExactStatistics::computeMoments(values));
+        for (double value : values)
+        {
+            sketch_.add(value);
+        }
+        if (histogram_)
+        {
+            for (double value : values)
+            {
+                histogram_->add(value);
+            }
+        }
+    }
+
+    void StatisticsSummary::setHistogram(const Histogram &layout)
+    {
+        histogram_ = layout;
+        histogram_->clear();
+    }
+
+    void StatisticsSummary::clear()
+    {
+        moments_ = SampleMoments();
+        sketch_.clear();
+        if (histogram_)
+            histogram_->clear();
+    }
+
+    bool StatisticsSummary::merge(const StatisticsSummary &other)
+    {
+        if (histogram_.has_value() != other.histogram_.has_value() ||
+            (histogram_ && !histogram_->hasSameLayout(*other.histogram_)))
+        {
+            return false;
+        }
+
+        moments_.merge(other.moments_);
+        sketch_.merge(other.sketch_);
+        if (histogram_)
+            histogram_->merge(*other.histogram_);
+        return true;
+    }
+
+    bool StatisticsSummary::merge(const StatisticsSummaryView &view)
+    {
+        if (histogram_.has_value() != view.hasHistogram() ||
+            (histogram_ && !view.hasHistogramLayout(*histogram_)))
+        {
+            return false;
+        }
+
+        const SampleMoments &moments = view.getMoments();
+        moments_.merge(moments);
+        sketch_.mergeRetained(view.getSketchK(), moments.count, moments.minimum, moments.maximum,
+                              view.getSketchLevels());
+        if (histogram_)
+        {
+            histogram_->mergeCounts(view.getHistogramCounts(), view.getHistogramUnderflow(),
+                                    view.getHistogramOverflow());
+        }
+        return true;
+    }
+
+    Statistics StatisticsSummary::calculate() const
+    {
+        Statistics stats;
+        if (moments_.count == 0)
+        {
+            return stats;
+        }
+        stats.count = moments_.count;
+        stats.mean = moments_.mean;
+        stats.median = sketch_.quantile(0.5);
+        stats.standardDeviation = std::sqrt(moments_.variance());
+        stats.minimum = moments_.minimum;
+        stats.maximum = moments_.maximum;
+        return stats;
+    }
+
+    double StatisticsSummary::getPercentile(double percentile) const
+    {
+        return sketch_.quantile(percentile / 100.0);
+    }
+
+    size_t StatisticsSummary::getSerializedSize() const
+    {
+        size_t size = HEADER_BYTES + MOMENTS_BYTES + 2 * 8;
+        for (const auto &level : sketch_.getLevels())
+        {
+            size += 8 + level.size() * sizeof(double);
+        }
+        if (histogram_)
+        {
+            size += HISTOGRAM_HEADER_BYTES + histogram_->getBinCount() * sizeof(double);
+        }
+        return size;
+    }
+
+    std::vector<uint8_t> StatisticsSummary::serialize() const
+    {
+        std::vector<uint8_t> bytes(getSerializedSize());
+        serialize(bytes);
+        return bytes;
+    }
+
+    bool StatisticsSummary::serialize(std::span<uint8_t> out) const
+    {
+        if (out.size() < getSerializedSize())
+        {
+            return false;
+        }
+
+        ByteWriter writer(out.data());
+        writer.write<uint32_t>(MAGIC);
+        writer.write<uint16_t>(FORMAT_VERSION);
+        writer.write<uint16_t>(histogram_ ? FLAG_HISTOGRAM : 0);
+
+        writer.write<uint64_t>(moments_.count);
+        writer.write<double>(moments_.mean);
+        writer.write<double>(moments_.sumSquaredDiff);
+        writer.write<double>(moments_.minimum);
+        writer.write<double>(moments_.maximum);
+
+        const auto &levels = sketch_.getLevels();
+        writer.write<uint64_t>(sketch_.getK());
+        writer.write<uint64_t>(levels.size());
+        for (const auto &level : levels)
+        {
+            writer.write<uint64_t>(level.size());
+        }
+        for (const auto &level : levels)
+        {
+            writer.write(std::span<const double>(level));
+        }
+
+        if (histogram_)
+        {
+            writer.write<uint32_t>(static_cast<uint32_t>(histogram_->getScale()));
+            writer.write<uint32_t>(histogram_->getSubBucketBits());
+            writer.write<double>(histogram_->getMinimum());
+            writer.write<double>(histogram_->getMaximum());
+            writer.write<uint64_t>(histogram_->getBinCount());
+            writer.write<double>(histogram_->getUnderflow());
+            writer.write<double>(histogram_->getOverflow());
+            writer.write(std::span<const double>(histogram_->getCounts()));
+        }
+        return true;
+    }
+
+    bool StatisticsSummary::deserialize(std::span<const uint8_t> bytes, StatisticsSummary &summary)
+    {
+        StatisticsSummaryView view;
+        if (!view.parse(bytes))
+        {
+            return false;
+        }
+
+        StatisticsSummary result(view.getSketchK());
+        if (view.hasHistogram())
+        {
+            std::optional<Histogram> layout;
+            if (!makeHistogram(view.getHistogramScale(), view.getHistogramMinimum(), view.getHistogramMaximum(),
+                               view.getHistogramCounts().size(), view.getHistogramSubBucketBits(), layout))
+            {
+                return false;
+            }
+            result.setHistogram(*layout);
+        }
+
+        result.merge(view);
+        summary = std::move(result);
+        return true;
+    }
+
+    // StatisticsSummaryView implementation
+    bool StatisticsSummaryView::parse(std::span<const uint8_t> bytes)
+    {
+        *this = StatisticsSummaryView();
+
+        // Spans point straight into the buffer, so byte order and alignment must match
+        if constexpr (std::endian::native != std::endian::little)
+        {
+            return false;
+        }
+        if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(double) != 0)
+        {
+            return false;
+        }
+
+        ByteReader reader(bytes);
+        uint32_t magic = reader.read<uint32_t>();
+        uint16_t version = reader.read<uint16_t>();
+        uint16_t flags = reader.read<uint16_t>();
+        if (!reader.isOk() || magic != StatisticsSummary::MAGIC || version == 0 ||
+            version > StatisticsSummary::FORMAT_VERSION || (flags & ~StatisticsSummary::FLAG_HISTOGRAM) != 0)
+        {
+            return false;
+        }
+
+        SampleMoments moments;
+        moments.count = static_cast<size_t>(reader.read<uint64_t>());
+        moments.mean = reader.read<double>();
+        moments.sumSquaredDiff = reader.read<double>();
+        moments.minimum = reader.read<double>();
+        moments.maximum = reader.read<double>();
+
+        uint64_t sketchK = reader.read<uint64_t>();
+        uint64_t levelCount = reader.read<uint64_t>();
+        if (!reader.isOk() || levelCount > MAX_SKETCH_LEVELS)
+        {
+            return false;
+        }
+
+        uint64_t levelSizes[MAX_SKETCH_LEVELS];
+        for (uint64_t level = 0; level < levelCount; ++level)
+        {
+            levelSizes[level] = reader.read<uint64_t>();
+        }
+        std::vector<std::span<const double>> levels;
+        levels.reserve(levelCount);
+        for (uint64_t level = 0; level < levelCount; ++level)
+        {
+            levels.push_back(reader.readDoubles(levelSizes[level]));
+        }
+
+        bool hasHistogram = (flags & StatisticsSummary::FLAG_HISTOGRAM) != 0;
+        uint32_t scale = 0;
+        uint32_t subBucketBits = 0;
+        double histogramMinimum = 0.0;
+        double histogramMaximum = 0.0;
+        double underflow = 0.0;
+        double overflow = 0.0;
+        std::span<const double> counts;
+        if (hasHistogram)
+        {
+            scale = reader.read<uint32_t>();
+            subBucketBits = reader.read<uint32_t>();
+            histogramMinimum = reader.read<double>();
+            histogramMaximum = reader.read<double>();
+            uint64_t bins = reader.read<uint64_t>();
+            underflow = reader.read<double>();
+            overflow = reader.read<double>();
+            counts = reader.readDoubles(bins);
+            if (scale > static_cast<uint32_t>(Histogram::Scale::LogLinear))
+            {
+                return false;
+            }
+        }
+
+        if (!reader.isOk() || !reader.isAtEnd() || !isConsistent(moments, levels))
+        {
+            return false;
+        }
+
+        version_ = version;
+        moments_ = moments;
+        sketchK_ = static_cast<size_t>(sketchK);
+        levels_ = std::move(levels);
+        hasHistogram_ = hasHistogram;
+        histogramScale_ = static_cast<Histogram::Scale>(scale);
+        histogramSubBucketBits_ = subBucketBits;
+        histogramMinimum_ = histogramMinimum;
+        histogramMaximum_ = histogramMaximum;
+        histogramCounts_ = counts;
+        histogramUnderflow_ = underflow;
+        histogramOverflow_ = overflow;
+        return true;
+    }
+
+    bool StatisticsSummaryView::hasHistogramLayout(const Histogram &layout) const
+    {
+        return hasHistogram_ && layout.getScale() == histogramScale_ &&
+               layout.getSubBucketBits() == histogramSubBucketBits_ && layout.getMinimum() == histogramMinimum_ &&
+               layout.getMaximum() == histogramMaximum_ && layout.getBinCount() == histogramCounts_.size();
+    }
+
+} // namespace utils
@@ -0,0 +1,233 @@
+#include "utils/StreamingStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+
+    // RunningMoments implementation
+    RunningMoments::RunningMoments()
+        : count_(0), mean_(0.0), m2_(0.0), minimum_(0.0), maximum_(0.0)
+    {
+    }
+
+    void RunningMoments::add(double value)
+    {
+        if (count_ == 0)
+        {
+            minimum_ = value;
+            maximum_ = value;
+        }
+        else
+        {
+            minimum_ = std::min(minimum_, value);
+            maximum_ = std::max(maximum_, value);
+        }
+
+        ++count_;
+        double delta = value - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (value - mean_);
+    }
+
+    void RunningMoments::merge(const RunningMoments &other)
+    {
+        if (other.count_ == 0)
+        {
+            return;
+        }
+        if (count_ == 0)
+        {
+            *this = other;
+            return;
+        }
+
+        // Chan et al. pairwise combination
+        double total = static_cast<double>(count_ + other.count_);
+        double delta = other.mean_ - mean_;
+        mean_ += delta * other.count_ / total;
+        m2_ += other.m2_ + delta * delta * count_ * other.count_ / total;
+        minimum_ = std::min(minimum_, other.minimum_);
+        maximum_ = std::max(maximum_, other.maximum_);
+        count_ += other.count_;
+    }
+
+    void RunningMoments::clear()
+    {
+        *this = RunningMoments();
+    }
+
+    double RunningMoments::getVariance() const
+    {
+        if (count_ <= 1)
+        {
+            return 0.0;
+        }
+        return m2_ / (count_ - 1);
+    }
+
+    double RunningMoments::getStandardDeviation() const
+    {
+        return std::sqrt(getVariance());
+    }
+
+    // P2QuantileEstimator implementation
+    P2QuantileEstimator::P2QuantileEstimator(double quantile)
+        : quantile_(MathUtils::clamp(quantile, 0.0, 1.0))
+    {
+        clear();
+    }
+
+    void P2QuantileEstimator::add(double value)
+    {
+        // Collect the first five samples verbatim
+        if (count_ < 5)
+        {
+            heights_[count_++] = value;
+            std::sort(heights_, heights_ + count_);
+            return;
+        }
+
+        int k;
+        if (value < heights_[0])
+        {
+            heights_[0] = value;
+            k = 0;
+        }
+        else if (value >= heights_[4])
+        {
+            heights_[4] = value;
+            k = 3;
+        }
+        else
+        {
+            k = 0;
+            while (value >= heights_[k + 1])
+                ++k;
+        }
+
+        ++count_;
+        for (int i = k + 1; i < 5; ++i)
+            positions_[i] += 1.0;
+        for (int i = 0; i < 5; ++i)
+            desired_[i] += increments_[i];
+
+        // Adjust the three middle markers towards their desired positions
+        for (int i = 1; i <= 3; ++i)
+        {
+            double d = desired_[i] - positions_[i];
+            if ((d >= 1.0 && positions_[i + 1] - positions_[i] > 1.0) ||
+                (d <= -1.0 && positions_[i - 1] - positions_[i] < -1.0))
+            {
+                int step = (d > 0.0) ? 1 : -1;
+                double candidate = parabolic(i, step);
+                if (heights_[i - 1] < candidate && candidate < heights_[i + 1])
+                    heights_[i] = candidate;
+                else
+                    heights_[i] = linear(i, step);
+                positions_[i] += step;
+            }
+        }
+    }
+
+    void P2QuantileEstimator::clear()
+    {
+        count_ = 0;
+        for (int i = 0; i < 5; ++i)
+        {
+            heights_[i] = 0.0;
+            positions_[i] = i;
+        }
+
+        desired_[0] = 0.0;
+        desired_[1] = 2.0 * quantile_;
+        desired_[2] = 4.0 * quantile_;
+        desired_[3] = 2.0 + 2.0 * quantile_;
+        desired_[4] = 4.0;
+
+        increments_[0] = 0.0;
+        increments_[1] = quantile_ / 2.0;
+        increments_[2] = quantile_;
+        increments_[3] = (1.0 + quantile_) / 2.0;
+        increments_[4] = 1.0;
+    }
+
+    double P2QuantileEstimator::estimate() const
+    {
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+
+        if (count_ <= 5)
+        {
+            // Same interpolation as StatisticsCalculator::getPercentile
+            double index = quantile_ * (count_ - 1);
+            size_t lower = static_cast<size_t>(std::floor(index));
+            size_t upper = static_cast<size_t>(std::ceil(index));
+            double weight = index - lower;
+            return heights_[lower] * (1.0 - weight) + heights_[upper] * weight;
+        }
+
+        return heights_[2];
+    }
+
+    double P2QuantileEstimator::parabolic(int i, double d) const
+    {
+        double below = positions_[i] - positions_[i - 1];
+        double above = positions_[i + 1] - positions_[i];
+        return heights_[i] + d / (positions_[i + 1] - positions_[i - 1]) *
+                                 ((below + d) * (heights_[i + 1] - heights_[i]) / above +
+                                  (above - d) * (heights_[i] - heights_[i - 1]) / below);
+    }
+
+    double P2QuantileEstimator::linear(int i, int d) const
+    {
+        return heights_[i] + d * (heights_[i + d] - heights_[i]) / (positions_[i + d] - positions_[i]);
+    }
+
+    // StreamingStatistics implementation
+    StreamingStatistics::StreamingStatistics() : median_(0.5)
+    {
+    }
+
+    StreamingStatistics::~StreamingStatistics() = default;
+
+    void StreamingStatistics::addValue(double value)
+    {
+        moments_.add(value);
+        median_.add(value);
+    }
+
+    void StreamingStatistics::addValues(const std::vector<double> &values)
+    {
+        for (double value : values)
+        {
+            addValue(value);
+        }
+    }
+
+    void StreamingStatistics::clear()
+    {
+        moments_.clear();
+        median_.clear();
+    }
+
+    Statistics StreamingStatistics::calculate() const
+    {
+        if (moments_.getCount() == 0)
+        {
+            return Statistics{};
+        }
+
+        Statistics stats;
+        stats.count = moments_.getCount();
+        stats.mean = moments_.getMean();
+        stats.median = median_.estimate();
+        stats.standardDeviation = moments_.getStandardDeviation();
+        stats.minimum = moments_.getMinimum();
+        stats.maximum = moments_.getMaximum();
+        return stats;
+    }
+
+} // namespace utils
@@ -0,0 +1,303 @@
+#include "geometry/UniformGridIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+
+namespace geometry
+{
+
+    namespace
+    {
+        // Keeps ring arithmetic in nearest() well inside 64-bit range
+        constexpr double COORDINATE_LIMIT = 1 << 30;
+
+        const int32_t EMPTY_MIN = static_cast<int32_t>(COORDINATE_LIMIT);
+        const int32_t EMPTY_MAX = -static_cast<int32_t>(COORDINATE_LIMIT);
+    }
+
+    UniformGridIndex::UniformGridIndex(double cellSize, size_t maxCellsPerEntry)
+        : cellSize_((cellSize > 0.0) ? cellSize : 1.0), inverseCellSize_(1.0 / cellSize_),
+          maxCellsPerEntry_(std::max<size_t>(maxCellsPerEntry, 1)), count_(0), occupied_{EMPTY_MIN, EMPTY_MIN, EMPTY_MAX, EMPTY_MAX}
+    {
+    }
+
+    size_t UniformGridIndex::insert(const BoundingBox &box)
+    {
+        size_t id;
+        if (!freeIds_.empty())
+        {
+            id = freeIds_.back();
+            freeIds_.pop_back();
+        }
+        else
+        {
+            id = entries_.size();
+            entries_.emplace_back();
+        }
+
+        Entry &entry = entries_[id];
+        entry.box = box;
+        entry.cells = cellRange(box);
+        entry.active = true;
+        link(id, entry.cells);
+        ++count_;
+        return id;
+    }
+
+    void UniformGridIndex::update(size_t id, const BoundingBox &box)
+    {
+        Entry &entry = entries_[id];
+        if (!entry.active)
+            return;
+
+        CellRange range = cellRange(box);
+        if (!(range == entry.cells))
+        {
+            unlink(id, entry.cells);
+            link(id, range);
+            entry.cells = range;
+        }
+        entry.box = box;
+    }
+
+    void UniformGridIndex::remove(size_t id)
+    {
+        Entry &entry = entries_[id];
+        if (!entry.active)
+            return;
+
+        unlink(id, entry.cells);
+        entry.active = false;
+        freeIds_.push_back(id);
+        --count_;
+    }
+
+    void UniformGridIndex::clear()
+    {
+        entries_.clear();
+        freeIds_.clear();
+        cells_.clear();
+        oversize_.clear();
+        count_ = 0;
+        occupied_ = CellRange{EMPTY_MIN, EMPTY_MIN, EMPTY_MAX, EMPTY_MAX};
+    }
+
+    void UniformGridIndex::query(const BoundingBox &region, std::vector<size_t> &out) const
+    {
+        size_t first = out.size();
+        auto collect = [&](const std::vector<size_t> &ids)
+        {
+            for (size_t id : ids)
+            {
+                if (entries_[id].box.intersects(region))
+                    out.push_back(id);
+            }
+        };
+        collect(oversize_);
+
+        CellRange range = cellRange(region);
+        double spanned = (static_cast<double>(range.maxX) - range.minX + 1.0) *
+                         (static_cast<double>(range.maxY) - range.minY + 1.0);
+        if (spanned > static_cast<double>(cells_.size()))
+        {
+            // Large regions: scanning the occupied cells is cheaper
+            for (const auto &[key, ids] : cells_)
+            {
+                int32_t x = static_cast<int32_t>(key >> 32);
+                int32_t y = static_cast<int32_t>(key & 0xffffffffu);
+                if (x >= range.minX && x <= range.maxX && y >= range.minY && y <= range.maxY)
+                    collect(ids);
+            }
+        }
+        else
+        {
+            for (int32_t x = range.minX; x <= range.maxX; ++x)
+            {
+                for (int32_t y = range.minY; y <= range.maxY; ++y)
+                {
+                    auto cell = cells_.find(cellKey(x, y));
+                    if (cell != cells_.end())
+                        collect(cell->second);
+                }
+            }
+        }
+
+        // Entries spanning several cells are found once per cell
+        std::sort(out.begin() + first, out.end());
+        out.erase(std::unique(out.begin() + first, out.end()), out.end());
+    }
+
+    void UniformGridIndex::nearest(double x, double y, size_t k, std::vector<size_t> &out,
+                                   const DistanceFunction &distance) const
+    {
+        if (k == 0 || count_ == 0)
+            return;
+
+        // Max-heap of the best k candidates so far
+        std::priority_queue<std::pair<double, size_t>> best;
+        std::unordered_set<size_t> seen;
+        auto offer = [&](size_t id)
+        {
+            double d = distance ? distance(id) : entries_[id].box.distanceTo(x, y);
+            if (best.size() < k)
+            {
+                best.emplace(d, id);
+            }
+            else if (d < best.top().first)
+            {
+                best.pop();
+                best.emplace(d, id);
+            }
+        };
+        auto consider = [&](int64_t cellX, int64_t cellY)
+        {
+            if (cellX < occupied_.minX || cellX > occupied_.maxX ||
+                cellY < occupied_.minY || cellY > occupied_.maxY)
+                return;
+
+            auto cell = cells_.find(cellKey(static_cast<int32_t>(cellX), static_cast<int32_t>(cellY)));
+            if (cell == cells_.end())
+                return;
+
+            for (size_t id : cell->second)
+            {
+                if (seen.insert(id).second)
+                    offer(id);
+            }
+        };
+
+        // Oversize entries are in no cell; seed the candidates with them
+        for (size_t id : oversize_)
+        {
+            offer(id);
+        }
+
+        int64_t centerX = cellCoordinate(x);
+        int64_t centerY = cellCoordinate(y);
+        int64_t minRing = std::max({int64_t{0}, occupied_.minX - centerX, centerX - occupied_.maxX,
+                                    occupied_.minY - centerY, centerY - occupied_.maxY});
+        int64_t maxRing = std::max({centerX - occupied_.minX, occupied_.maxX - centerX,
+                                    centerY - occupied_.minY, occupied_.maxY - centerY});
+
+        for (int64_t ring = minRing; ring <= maxRing; ++ring)
+        {
+            // Walk only the parts of the ring that overlap occupied cells
+            int64_t fromX = std::max(centerX - ring, int64_t{occupied_.minX});
+            int64_t toX = std::min(centerX + ring, int64_t{occupied_.maxX});
+            int64_t fromY = std::max(centerY - ring + 1, int64_t{occupied_.minY});
+            int64_t toY = std::min(centerY + ring - 1, int64_t{occupied_.maxY});
+            for (int64_t cellX = fromX; cellX <= toX; ++cellX)
+            {
+                consider(cellX, centerY - ring);
+                if (ring > 0)
+                    consider(cellX, centerY + ring);
+            }
+            for (int64_t cellY = fromY; cellY <= toY; ++cellY)
+            {
+                consider(centerX - ring, cellY);
+                consider(centerX + ring, cellY);
+            }
+
+            // Anything unseen lies outside the square of rings searched so far
+            if (best.size() == k)
+            {
+                double bound = std::min({x - (centerX - ring) * cellSize_,
+                                         (centerX + ring + 1) * cellSize_ - x,
+                                         y - (centerY - ring) * cellSize_,
+                                         (centerY + ring + 1) * cellSize_ - y});
+                if (best.top().first <= bound)
+                    break;
+            }
+        }
+
+        size_t first = out.size();
+        out.resize(first + best.size());
+        for (size_t i = out.size(); i > first; --i)
+        {
+            out[i - 1] = best.top().second;
+            best.pop();
+        }
+    }
+
+    int32_t UniformGridIndex::cellCoordinate(double value) const
+    {
+        double cell = std::floor(value * inverseCellSize_);
+        return static_cast<int32_t>(std::clamp(cell, -COORDINATE_LIMIT, COORDINATE_LIMIT));
+    }
+
+    UniformGridIndex::CellRange UniformGridIndex::cellRange(const BoundingBox &box) const
+    {
+        return CellRange{cellCoordinate(box.minX), cellCoordinate(box.minY),
+                         cellCoordinate(box.maxX), cellCoordinate(box.maxY)};
+    }
+
+    bool UniformGridIndex::isOversize(const CellRange &range) const
+    {
+        double spanned = (static_cast<double>(range.maxX) - range.minX + 1.0) *
+                         (static_cast<double>(range.maxY) - range.minY + 1.0);
+        return spanned > static_cast<double>(maxCellsPerEntry_);
+    }
+
+    uint64_t UniformGridIndex::cellKey(int32_t x, int32_t y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    void UniformGridIndex::link(size_t id, const CellRange &range)
+    {
+        if (isOversize(range))
+        {
+            entries_[id].oversizeSlot = oversize_.size();
+            oversize_.push_back(id);
+            return;
+        }
+
+        for (int32_t x = range.minX; x <= range.maxX; ++x)
+        {
+            for (int32_t y = range.minY; y <= range.maxY; ++y)
+            {
+                cells_[cellKey(x, y)].push_back(id);
+            }
+        }
+
+        occupied_.minX = std::min(occupied_.minX, range.minX);
+        occupied_.minY = std::min(occupied_.minY, range.minY);
+        occupied_.maxX = std::max(occupied_.maxX, range.maxX);
+        occupied_.maxY = std::max(occupied_.maxY, range.maxY);
+    }
+
+    void UniformGridIndex::unlink(size_t id, const CellRange &range)
+    {
+        if (isOversize(range))
+        {
+            size_t slot = entries_[id].oversizeSlot;
+            oversize_[slot] = oversize_.back();
+            entries_[oversize_[slot]].oversizeSlot = slot;
+            oversize_.pop_back();
+            return;
+        }
+
+        for (int32_t x = range.minX; x <= range.maxX; ++x)
+        {
+            for (int32_t y = range.minY; y <= range.maxY; ++y)
+            {
+                auto cell = cells_.find(cellKey(x, y));
+                if (cell == cells_.end())
+                    continue;
+
+                std::vector<size_t> &ids = cell->second;
+                auto position = std::find(ids.begin(), ids.end(), id);
+                if (position != ids.end())
+                {
+                    *position = ids.back();
+                    ids.pop_back();
+                }
+                if (ids.empty())
+                    cells_.erase(cell);
+            }
+        }
+    }
+
+} // namespace geometry
@@ -0,0 +1,1004 @@
+#include "utils/VectorSimd.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTILS_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define UTILS_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace utils
+{
+    namespace simd
+    {
+        namespace
+        {
+            // Vectors are processed as flat arrays of interleaved components.
+            static_assert(sizeof(Vec2f) == 2 * sizeof(float), "Vec2f must be tightly packed");
+            static_assert(sizeof(Vec2d) == 2 * sizeof(double), "Vec2d must be tightly packed");
+            static_assert(sizeof(Vec2i) == 2 * sizeof(int), "Vec2i must be tightly packed");
+            static_assert(std::is_standard_layout_v<Vec2d>, "Vector2D must be standard layout");
+
+            // Same threshold as Vector2D::normalized()
+            template <typename T>
+            constexpr T normalizeEpsilon = static_cast<T>(1e-9);
+
+            /**
+             * Kernel table for one component type; counts are in vectors.
+             */
+            template <typename T>
+            struct Kernels
+            {
+                void (*add)(const Vector2D<T> *, const Vector2D<T> *, Vector2D<T> *, size_t);
+                void (*subtract)(const Vector2D<T> *, const Vector2D<T> *, Vector2D<T> *, size_t);
+                void (*dot)(const Vector2D<T> *, const Vector2D<T> *, T *, size_t);
+                void (*magnitude)(const Vector2D<T> *, T *, size_t);
+                void (*normalize)(Vector2D<T> *, size_t);
+                void (*squaredDistances)(const Vector2D<T> &, const Vector2D<T> *, T *, size_t);
+            };
+
+            // Scalar kernels built on the Vector2D instantiations
+            template <typename T>
+            void addScalar(const Vector2D<T> *a, const Vector2D<T> *b, Vector2D<T> *out, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = a[i] + b[i];
+            }
+
+            template <typename T>
+            void subtractScalar(const Vector2D<T> *a, const Vector2D<T> *b, Vector2D<T> *out, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = a[i] - b[i];
+            }
+
+            template <typename T>
+            void dotScalar(const Vector2D<T> *a, const Vector2D<T> *b, T *out, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = a[i].dot(b[i]);
+            }
+
+            template <typename T>
+            void magnitudeScalar(const Vector2D<T> *v, T *out, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    out[i] = v[i].magnitude();
+            }
+
+            template <typename T>
+            void normalizeScalar(Vector2D<T> *v, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    v[i] = v[i].normalized();
+            }
+
+            template <typename T>
+            void squaredDistancesScalar(const Vector2D<T> &origin, const Vector2D<T> *points, T *out, size_t n)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    Vector2D<T> diff = points[i] - origin;
+                    out[i] = diff.dot(diff);
+                }
+            }
+
+            template <typename T>
+            constexpr Kernels<T> scalarKernels()
+            {
+                return Kernels<T>{&addScalar<T>, &subtractScalar<T>, &dotScalar<T>,
+                                  &magnitudeScalar<T>, &normalizeScalar<T>, &squaredDistancesScalar<T>};
+            }
+
+#ifdef UTILS_SIMD_X86
+            // AVX2 kernels
+            __attribute__((target("avx2"))) void addAvx2(const Vec2d *a, const Vec2d *b, Vec2d *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                double *po = &out->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    __m256d va = _mm256_loadu_pd(pa + 2 * i);
+                    __m256d vb = _mm256_loadu_pd(pb + 2 * i);
+                    _mm256_storeu_pd(po + 2 * i, _mm256_add_pd(va, vb));
+                }
+                addScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void subtractAvx2(const Vec2d *a, const Vec2d *b, Vec2d *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                double *po = &out->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    __m256d va = _mm256_loadu_pd(pa + 2 * i);
+                    __m256d vb = _mm256_loadu_pd(pb + 2 * i);
+                    _mm256_storeu_pd(po + 2 * i, _mm256_sub_pd(va, vb));
+                }
+                subtractScalar(a + i, b + i, out + i, n - i);
+            }
+
+            // Sums adjacent (x, y) pairs of four vectors held in two registers.
+            __attribute__((target("avx2"))) inline __m256d pairSumsAvx2(__m256d lo, __m256d hi)
+            {
+                return _mm256_permute4x64_pd(_mm256_hadd_pd(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+            }
+
+            __attribute__((target("avx2"))) void dotAvx2(const Vec2d *a, const Vec2d *b, double *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256d lo = _mm256_mul_pd(_mm256_loadu_pd(pa + 2 * i), _mm256_loadu_pd(pb + 2 * i));
+                    __m256d hi = _mm256_mul_pd(_mm256_loadu_pd(pa + 2 * i + 4), _mm256_loadu_pd(pb + 2 * i + 4));
+                    _mm256_storeu_pd(out + i, pairSumsAvx2(lo, hi));
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void magnitudeAvx2(const Vec2d *v, double *out, size_t n)
+            {
+                const double *pv = &v->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256d lo = _mm256_loadu_pd(pv + 2 * i);
+                    __m256d hi = _mm256_loadu_pd(pv + 2 * i + 4);
+                    __m256d squared = pairSumsAvx2(_mm256_mul_pd(lo, lo), _mm256_mul_pd(hi, hi));
+                    _mm256_storeu_pd(out + i, _mm256_sqrt_pd(squared));
+                }
+                magnitudeScalar(v + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void normalizeAvx2(Vec2d *v, size_t n)
+            {
+                double *pv = &v->x;
+                const __m256d epsilon = _mm256_set1_pd(normalizeEpsilon<double>);
+                const __m256d zero = _mm256_setzero_pd();
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256d lo = _mm256_loadu_pd(pv + 2 * i);
+                    __m256d hi = _mm256_loadu_pd(pv + 2 * i + 4);
+                    __m256d mag = _mm256_sqrt_pd(pairSumsAvx2(_mm256_mul_pd(lo, lo), _mm256_mul_pd(hi, hi)));
+
+                    // Spread each magnitude over its vector's two components
+                    __m256d magLo = _mm256_permute4x64_pd(mag, _MM_SHUFFLE(1, 1, 0, 0));
+                    __m256d magHi = _mm256_permute4x64_pd(mag, _MM_SHUFFLE(3, 3, 2, 2));
+                    __m256d tinyLo = _mm256_cmp_pd(magLo, epsilon, _CMP_LT_OQ);
+                    __m256d tinyHi = _mm256_cmp_pd(magHi, epsilon, _CMP_LT_OQ);
+
+                    _mm256_storeu_pd(pv + 2 * i, _mm256_blendv_pd(_mm256_div_pd(lo, magLo), zero, tinyLo));
+                    _mm256_storeu_pd(pv + 2 * i + 4, _mm256_blendv_pd(_mm256_div_pd(hi, magHi), zero, tinyHi));
+                }
+                normalizeScalar(v + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void squaredDistancesAvx2(const Vec2d &origin, const Vec2d *points,
+                                                                       double *out, size_t n)
+            {
+                const double *pp = &points->x;
+                const __m256d o = _mm256_setr_pd(origin.x, origin.y, origin.x, origin.y);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256d lo = _mm256_sub_pd(_mm256_loadu_pd(pp + 2 * i), o);
+                    __m256d hi = _mm256_sub_pd(_mm256_loadu_pd(pp + 2 * i + 4), o);
+                    _mm256_storeu_pd(out + i, pairSumsAvx2(_mm256_mul_pd(lo, lo), _mm256_mul_pd(hi, hi)));
+                }
+                squaredDistancesScalar(origin, points + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void addAvx2(const Vec2f *a, const Vec2f *b, Vec2f *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                float *po = &out->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256 va = _mm256_loadu_ps(pa + 2 * i);
+                    __m256 vb = _mm256_loadu_ps(pb + 2 * i);
+                    _mm256_storeu_ps(po + 2 * i, _mm256_add_ps(va, vb));
+                }
+                addScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void subtractAvx2(const Vec2f *a, const Vec2f *b, Vec2f *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                float *po = &out->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256 va = _mm256_loadu_ps(pa + 2 * i);
+                    __m256 vb = _mm256_loadu_ps(pb + 2 * i);
+                    _mm256_storeu_ps(po + 2 * i, _mm256_sub_ps(va, vb));
+                }
+                subtractScalar(a + i, b + i, out + i, n - i);
+            }
+
+            // Sums adjacent (x, y) pairs of eight vectors held in two registers.
+            __attribute__((target("avx2"))) inline __m256 pairSumsAvx2(__m256 lo, __m256 hi)
+            {
+                __m256d sums = _mm256_castps_pd(_mm256_hadd_ps(lo, hi));
+                return _mm256_castpd_ps(_mm256_permute4x64_pd(sums, _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+
+            __attribute__((target("avx2"))) void dotAvx2(const Vec2f *a, const Vec2f *b, float *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m256 lo = _mm256_mul_ps(_mm256_loadu_ps(pa + 2 * i), _mm256_loadu_ps(pb + 2 * i));
+                    __m256 hi = _mm256_mul_ps(_mm256_loadu_ps(pa + 2 * i + 8), _mm256_loadu_ps(pb + 2 * i + 8));
+                    _mm256_storeu_ps(out + i, pairSumsAvx2(lo, hi));
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void magnitudeAvx2(const Vec2f *v, float *out, size_t n)
+            {
+                const float *pv = &v->x;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m256 lo = _mm256_loadu_ps(pv + 2 * i);
+                    __m256 hi = _mm256_loadu_ps(pv + 2 * i + 8);
+                    __m256 squared = pairSumsAvx2(_mm256_mul_ps(lo, lo), _mm256_mul_ps(hi, hi));
+                    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(squared));
+                }
+                magnitudeScalar(v + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void normalizeAvx2(Vec2f *v, size_t n)
+            {
+                float *pv = &v->x;
+                const __m256 epsilon = _mm256_set1_ps(normalizeEpsilon<float>);
+                const __m256 zero = _mm256_setzero_ps();
+                const __m256i spreadLo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+                const __m256i spreadHi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m256 lo = _mm256_loadu_ps(pv + 2 * i);
+                    __m256 hi = _mm256_loadu_ps(pv + 2 * i + 8);
+                    __m256 mag = _mm256_sqrt_ps(pairSumsAvx2(_mm256_mul_ps(lo, lo), _mm256_mul_ps(hi, hi)));
+
+                    __m256 magLo = _mm256_permutevar8x32_ps(mag, spreadLo);
+                    __m256 magHi = _mm256_permutevar8x32_ps(mag, spreadHi);
+                    __m256 tinyLo = _mm256_cmp_ps(magLo, epsilon, _CMP_LT_OQ);
+                    __m256 tinyHi = _mm256_cmp_ps(magHi, epsilon, _CMP_LT_OQ);
+
+                    _mm256_storeu_ps(pv + 2 * i, _mm256_blendv_ps(_mm256_div_ps(lo, magLo), zero, tinyLo));
+                    _mm256_storeu_ps(pv + 2 * i + 8, _mm256_blendv_ps(_mm256_div_ps(hi, magHi), zero, tinyHi));
+                }
+                normalizeScalar(v + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void squaredDistancesAvx2(const Vec2f &origin, const Vec2f *points,
+                                                                       float *out, size_t n)
+            {
+                const float *pp = &points->x;
+                const __m256 o = _mm256_setr_ps(origin.x, origin.y, origin.x, origin.y,
+                                                origin.x, origin.y, origin.x, origin.y);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m256 lo = _mm256_sub_ps(_mm256_loadu_ps(pp + 2 * i), o);
+                    __m256 hi = _mm256_sub_ps(_mm256_loadu_ps(pp + 2 * i + 8), o);
+                    _mm256_storeu_ps(out + i, pairSumsAvx2(_mm256_mul_ps(lo, lo), _mm256_mul_ps(hi, hi)));
+                }
+                squaredDistancesScalar(origin, points + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void addAvx2(const Vec2i *a, const Vec2i *b, Vec2i *out, size_t n)
+            {
+                const int *pa = &a->x;
+                const int *pb = &b->x;
+                int *po = &out->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pa + 2 * i));
+                    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pb + 2 * i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(po + 2 * i), _mm256_add_epi32(va, vb));
+                }
+                addScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void subtractAvx2(const Vec2i *a, const Vec2i *b, Vec2i *out, size_t n)
+            {
+                const int *pa = &a->x;
+                const int *pb = &b->x;
+                int *po = &out->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pa + 2 * i));
+                    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pb + 2 * i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(po + 2 * i), _mm256_sub_epi32(va, vb));
+                }
+                subtractScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx2"))) void dotAvx2(const Vec2i *a, const Vec2i *b, int *out, size_t n)
+            {
+                const int *pa = &a->x;
+                const int *pb = &b->x;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m256i lo = _mm256_mullo_epi32(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pa + 2 * i)),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pb + 2 * i)));
+                    __m256i hi = _mm256_mullo_epi32(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pa + 2 * i + 8)),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pb + 2 * i + 8)));
+                    __m256i sums = _mm256_permute4x64_epi64(_mm256_hadd_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), sums);
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+
+            // AVX-512 kernels
+#if defined(__GNUC__) && !defined(__clang__)
+            // GCC 12 headers trip -Wmaybe-uninitialized on _mm512_undefined_*()
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+            __attribute__((target("avx512f"))) void addAvx512(const Vec2d *a, const Vec2d *b, Vec2d *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                double *po = &out->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m512d va = _mm512_loadu_pd(pa + 2 * i);
+                    __m512d vb = _mm512_loadu_pd(pb + 2 * i);
+                    _mm512_storeu_pd(po + 2 * i, _mm512_add_pd(va, vb));
+                }
+                addScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void subtractAvx512(const Vec2d *a, const Vec2d *b, Vec2d *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                double *po = &out->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m512d va = _mm512_loadu_pd(pa + 2 * i);
+                    __m512d vb = _mm512_loadu_pd(pb + 2 * i);
+                    _mm512_storeu_pd(po + 2 * i, _mm512_sub_pd(va, vb));
+                }
+                subtractScalar(a + i, b + i, out + i, n - i);
+            }
+
+            // Sums adjacent (x, y) pairs of eight vectors held in two registers.
+            __attribute__((target("avx512f"))) inline __m512d pairSumsAvx512(__m512d lo, __m512d hi)
+            {
+                const __m512i evens = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+                const __m512i odds = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+                return _mm512_add_pd(_mm512_permutex2var_pd(lo, evens, hi),
+                                     _mm512_permutex2var_pd(lo, odds, hi));
+            }
+
+            __attribute__((target("avx512f"))) void dotAvx512(const Vec2d *a, const Vec2d *b, double *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m512d lo = _mm512_mul_pd(_mm512_loadu_pd(pa + 2 * i), _mm512_loadu_pd(pb + 2 * i));
+                    __m512d hi = _mm512_mul_pd(_mm512_loadu_pd(pa + 2 * i + 8), _mm512_loadu_pd(pb + 2 * i + 8));
+                    _mm512_storeu_pd(out + i, pairSumsAvx512(lo, hi));
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void magnitudeAvx512(const Vec2d *v, double *out, size_t n)
+            {
+                const double *pv = &v->x;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m512d lo = _mm512_loadu_pd(pv + 2 * i);
+                    __m512d hi = _mm512_loadu_pd(pv + 2 * i + 8);
+                    __m512d squared = pairSumsAvx512(_mm512_mul_pd(lo, lo), _mm512_mul_pd(hi, hi));
+                    _mm512_storeu_pd(out + i, _mm512_sqrt_pd(squared));
+                }
+                magnitudeScalar(v + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void normalizeAvx512(Vec2d *v, size_t n)
+            {
+                double *pv = &v->x;
+                const __m512d epsilon = _mm512_set1_pd(normalizeEpsilon<double>);
+                const __m512i spreadLo = _mm512_setr_epi64(0, 0, 1, 1, 2, 2, 3, 3);
+                const __m512i spreadHi = _mm512_setr_epi64(4, 4, 5, 5, 6, 6, 7, 7);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m512d lo = _mm512_loadu_pd(pv + 2 * i);
+                    __m512d hi = _mm512_loadu_pd(pv + 2 * i + 8);
+                    __m512d mag = _mm512_sqrt_pd(pairSumsAvx512(_mm512_mul_pd(lo, lo), _mm512_mul_pd(hi, hi)));
+
+                    __m512d magLo = _mm512_permutexvar_pd(spreadLo, mag);
+                    __m512d magHi = _mm512_permutexvar_pd(spreadHi, mag);
+                    __mmask8 keepLo = _mm512_cmp_pd_mask(magLo, epsilon, _CMP_NLT_UQ);
+                    __mmask8 keepHi = _mm512_cmp_pd_mask(magHi, epsilon, _CMP_NLT_UQ);
+
+                    _mm512_storeu_pd(pv + 2 * i, _mm512_maskz_div_pd(keepLo, lo, magLo));
+                    _mm512_storeu_pd(pv + 2 * i + 8, _mm512_maskz_div_pd(keepHi, hi, magHi));
+                }
+                normalizeScalar(v + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void squaredDistancesAvx512(const Vec2d &origin, const Vec2d *points,
+                                                                            double *out, size_t n)
+            {
+                const double *pp = &points->x;
+                const __m512d o = _mm512_setr_pd(origin.x, origin.y, origin.x, origin.y,
+                                                 origin.x, origin.y, origin.x, origin.y);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m512d lo = _mm512_sub_pd(_mm512_loadu_pd(pp + 2 * i), o);
+                    __m512d hi = _mm512_sub_pd(_mm512_loadu_pd(pp + 2 * i + 8), o);
+                    _mm512_storeu_pd(out + i, pairSumsAvx512(_mm512_mul_pd(lo, lo), _mm512_mul_pd(hi, hi)));
+                }
+                squaredDistancesScalar(origin, points + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void addAvx512(const Vec2f *a, const Vec2f *b, Vec2f *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                float *po = &out->x;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m512 va = _mm512_loadu_ps(pa + 2 * i);
+                    __m512 vb = _mm512_loadu_ps(pb + 2 * i);
+                    _mm512_storeu_ps(po + 2 * i, _mm512_add_ps(va, vb));
+                }
+                addScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void subtractAvx512(const Vec2f *a, const Vec2f *b, Vec2f *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                float *po = &out->x;
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m512 va = _mm512_loadu_ps(pa + 2 * i);
+                    __m512 vb = _mm512_loadu_ps(pb + 2 * i);
+                    _mm512_storeu_ps(po + 2 * i, _mm512_sub_ps(va, vb));
+                }
+                subtractScalar(a + i, b + i, out + i, n - i);
+            }
+
+            // Sums adjacent (x, y) pairs of sixteen vectors held in two registers.
+            __attribute__((target("avx512f"))) inline __m512 pairSumsAvx512(__m512 lo, __m512 hi)
+            {
+                const __m512i evens = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14,
+                                                        16, 18, 20, 22, 24, 26, 28, 30);
+                const __m512i odds = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15,
+                                                       17, 19, 21, 23, 25, 27, 29, 31);
+                return _mm512_add_ps(_mm512_permutex2var_ps(lo, evens, hi),
+                                     _mm512_permutex2var_ps(lo, odds, hi));
+            }
+
+            __attribute__((target("avx512f"))) void dotAvx512(const Vec2f *a, const Vec2f *b, float *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m512 lo = _mm512_mul_ps(_mm512_loadu_ps(pa + 2 * i), _mm512_loadu_ps(pb + 2 * i));
+                    __m512 hi = _mm512_mul_ps(_mm512_loadu_ps(pa + 2 * i + 16), _mm512_loadu_ps(pb + 2 * i + 16));
+                    _mm512_storeu_ps(out + i, pairSumsAvx512(lo, hi));
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void magnitudeAvx512(const Vec2f *v, float *out, size_t n)
+            {
+                const float *pv = &v->x;
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m512 lo = _mm512_loadu_ps(pv + 2 * i);
+                    __m512 hi = _mm512_loadu_ps(pv + 2 * i + 16);
+                    __m512 squared = pairSumsAvx512(_mm512_mul_ps(lo, lo), _mm512_mul_ps(hi, hi));
+                    _mm512_storeu_ps(out + i, _mm512_sqrt_ps(squared));
+                }
+                magnitudeScalar(v + i, out + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void normalizeAvx512(Vec2f *v, size_t n)
+            {
+                float *pv = &v->x;
+                const __m512 epsilon = _mm512_set1_ps(normalizeEpsilon<float>);
+                const __m512i spreadLo = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3,
+                                                           4, 4, 5, 5, 6, 6, 7, 7);
+                const __m512i spreadHi = _mm512_setr_epi32(8, 8, 9, 9, 10, 10, 11, 11,
+                                                           12, 12, 13, 13, 14, 14, 15, 15);
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m512 lo = _mm512_loadu_ps(pv + 2 * i);
+                    __m512 hi = _mm512_loadu_ps(pv + 2 * i + 16);
+                    __m512 mag = _mm512_sqrt_ps(pairSumsAvx512(_mm512_mul_ps(lo, lo), _mm512_mul_ps(hi, hi)));
+
+                    __m512 magLo = _mm512_permutexvar_ps(spreadLo, mag);
+                    __m512 magHi = _mm512_permutexvar_ps(spreadHi, mag);
+                    __mmask16 keepLo = _mm512_cmp_ps_mask(magLo, epsilon, _CMP_NLT_UQ);
+                    __mmask16 keepHi = _mm512_cmp_ps_mask(magHi, epsilon, _CMP_NLT_UQ);
+
+                    _mm512_storeu_ps(pv + 2 * i, _mm512_maskz_div_ps(keepLo, lo, magLo));
+                    _mm512_storeu_ps(pv + 2 * i + 16, _mm512_maskz_div_ps(keepHi, hi, magHi));
+                }
+                normalizeScalar(v + i, n - i);
+            }
+
+            __attribute__((target("avx512f"))) void squaredDistancesAvx512(const Vec2f &origin, const Vec2f *points,
+                                                                            float *out, size_t n)
+            {
+                const float *pp = &points->x;
+                const __m512 o = _mm512_setr_ps(origin.x, origin.y, origin.x, origin.y, origin.x, origin.y,
+                                                origin.x, origin.y, origin.x, origin.y, origin.x, origin.y,
+                                                origin.x, origin.y, origin.x, origin.y);
+                size_t i = 0;
+                for (; i + 16 <= n; i += 16)
+                {
+                    __m512 lo = _mm512_sub_ps(_mm512_loadu_ps(pp + 2 * i), o);
+                    __m512 hi = _mm512_sub_ps(_mm512_loadu_ps(pp + 2 * i + 16), o);
+                    _mm512_storeu_ps(out + i, pairSumsAvx512(_mm512_mul_ps(lo, lo), _mm512_mul_ps(hi, hi)));
+                }
+                squaredDistancesScalar(origin, points + i, out + i, n - i);
+            }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif // UTILS_SIMD_X86
+
+#ifdef UTILS_SIMD_NEON
+            // NEON kernels (de-interleaving loads split x and y into lanes)
+            void addNeon(const Vec2d *a, const Vec2d *b, Vec2d *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                double *po = &out->x;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    vst1q_f64(po + 2 * i, vaddq_f64(vld1q_f64(pa + 2 * i), vld1q_f64(pb + 2 * i)));
+                }
+            }
+
+            void subtractNeon(const Vec2d *a, const Vec2d *b, Vec2d *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                double *po = &out->x;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    vst1q_f64(po + 2 * i, vsubq_f64(vld1q_f64(pa + 2 * i), vld1q_f64(pb + 2 * i)));
+                }
+            }
+
+            void dotNeon(const Vec2d *a, const Vec2d *b, double *out, size_t n)
+            {
+                const double *pa = &a->x;
+                const double *pb = &b->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    float64x2x2_t va = vld2q_f64(pa + 2 * i);
+                    float64x2x2_t vb = vld2q_f64(pb + 2 * i);
+                    float64x2_t sums = vaddq_f64(vmulq_f64(va.val[0], vb.val[0]), vmulq_f64(va.val[1], vb.val[1]));
+                    vst1q_f64(out + i, sums);
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+
+            void magnitudeNeon(const Vec2d *v, double *out, size_t n)
+            {
+                const double *pv = &v->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    float64x2x2_t vv = vld2q_f64(pv + 2 * i);
+                    float64x2_t squared = vaddq_f64(vmulq_f64(vv.val[0], vv.val[0]), vmulq_f64(vv.val[1], vv.val[1]));
+                    vst1q_f64(out + i, vsqrtq_f64(squared));
+                }
+                magnitudeScalar(v + i, out + i, n - i);
+            }
+
+            void normalizeNeon(Vec2d *v, size_t n)
+            {
+                double *pv = &v->x;
+                const float64x2_t epsilon = vdupq_n_f64(normalizeEpsilon<double>);
+                const float64x2_t zero = vdupq_n_f64(0.0);
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    float64x2x2_t vv = vld2q_f64(pv + 2 * i);
+                    float64x2_t mag = vsqrtq_f64(vaddq_f64(vmulq_f64(vv.val[0], vv.val[0]), vmulq_f64(vv.val[1], vv.val[1])));
+                    uint64x2_t tiny = vcltq_f64(mag, epsilon);
+                    vv.val[0] = vbslq_f64(tiny, zero, vdivq_f64(vv.val[0], mag));
+                    vv.val[1] = vbslq_f64(tiny, zero, vdivq_f64(vv.val[1], mag));
+                    vst2q_f64(pv + 2 * i, vv);
+                }
+                normalizeScalar(v + i, n - i);
+            }
+
+            void squaredDistancesNeon(const Vec2d &origin, const Vec2d *points, double *out, size_t n)
+            {
+                const double *pp = &points->x;
+                const float64x2_t ox = vdupq_n_f64(origin.x);
+                const float64x2_t oy = vdupq_n_f64(origin.y);
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    float64x2x2_t vv = vld2q_f64(pp + 2 * i);
+                    float64x2_t dx = vsubq_f64(vv.val[0], ox);
+                    float64x2_t dy = vsubq_f64(vv.val[1], oy);
+                    vst1q_f64(out + i, vaddq_f64(vmulq_f64(dx, dx), vmulq_f64(dy, dy)));
+                }
+                squaredDistancesScalar(origin, points + i, out + i, n - i);
+            }
+
+            void addNeon(const Vec2f *a, const Vec2f *b, Vec2f *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                float *po = &out->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    vst1q_f32(po + 2 * i, vaddq_f32(vld1q_f32(pa + 2 * i), vld1q_f32(pb + 2 * i)));
+                }
+                addScalar(a + i, b + i, out + i, n - i);
+            }
+
+            void subtractNeon(const Vec2f *a, const Vec2f *b, Vec2f *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                float *po = &out->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    vst1q_f32(po + 2 * i, vsubq_f32(vld1q_f32(pa + 2 * i), vld1q_f32(pb + 2 * i)));
+                }
+                subtractScalar(a + i, b + i, out + i, n - i);
+            }
+
+            void dotNeon(const Vec2f *a, const Vec2f *b, float *out, size_t n)
+            {
+                const float *pa = &a->x;
+                const float *pb = &b->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    float32x4x2_t va = vld2q_f32(pa + 2 * i);
+                    float32x4x2_t vb = vld2q_f32(pb + 2 * i);
+                    float32x4_t sums = vaddq_f32(vmulq_f32(va.val[0], vb.val[0]), vmulq_f32(va.val[1], vb.val[1]));
+                    vst1q_f32(out + i, sums);
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+
+            void magnitudeNeon(const Vec2f *v, float *out, size_t n)
+            {
+                const float *pv = &v->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    float32x4x2_t vv = vld2q_f32(pv + 2 * i);
+                    float32x4_t squared = vaddq_f32(vmulq_f32(vv.val[0], vv.val[0]), vmulq_f32(vv.val[1], vv.val[1]));
+                    vst1q_f32(out + i, vsqrtq_f32(squared));
+                }
+                magnitudeScalar(v + i, out + i, n - i);
+            }
+
+            void normalizeNeon(Vec2f *v, size_t n)
+            {
+                float *pv = &v->x;
+                const float32x4_t epsilon = vdupq_n_f32(normalizeEpsilon<float>);
+                const float32x4_t zero = vdupq_n_f32(0.0f);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    float32x4x2_t vv = vld2q_f32(pv + 2 * i);
+                    float32x4_t mag = vsqrtq_f32(vaddq_f32(vmulq_f32(vv.val[0], vv.val[0]), vmulq_f32(vv.val[1], vv.val[1])));
+                    uint32x4_t tiny = vcltq_f32(mag, epsilon);
+                    vv.val[0] = vbslq_f32(tiny, zero, vdivq_f32(vv.val[0], mag));
+                    vv.val[1] = vbslq_f32(tiny, zero, vdivq_f32(vv.val[1], mag));
+                    vst2q_f32(pv + 2 * i, vv);
+                }
+                normalizeScalar(v + i, n - i);
+            }
+
+            void squaredDistancesNeon(const Vec2f &origin, const Vec2f *points, float *out, size_t n)
+            {
+                const float *pp = &points->x;
+                const float32x4_t ox = vdupq_n_f32(origin.x);
+                const float32x4_t oy = vdupq_n_f32(origin.y);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    float32x4x2_t vv = vld2q_f32(pp + 2 * i);
+                    float32x4_t dx = vsubq_f32(vv.val[0], ox);
+                    float32x4_t dy = vsubq_f32(vv.val[1], oy);
+                    vst1q_f32(out + i, vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)));
+                }
+                squaredDistancesScalar(origin, points + i, out + i, n - i);
+            }
+
+            void addNeon(const Vec2i *a, const Vec2i *b, Vec2i *out, size_t n)
+            {
+                const int *pa = &a->x;
+                const int *pb = &b->x;
+                int *po = &out->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    vst1q_s32(po + 2 * i, vaddq_s32(vld1q_s32(pa + 2 * i), vld1q_s32(pb + 2 * i)));
+                }
+                addScalar(a + i, b + i, out + i, n - i);
+            }
+
+            void subtractNeon(const Vec2i *a, const Vec2i *b, Vec2i *out, size_t n)
+            {
+                const int *pa = &a->x;
+                const int *pb = &b->x;
+                int *po = &out->x;
+                size_t i = 0;
+                for (; i + 2 <= n; i += 2)
+                {
+                    vst1q_s32(po + 2 * i, vsubq_s32(vld1q_s32(pa + 2 * i), vld1q_s32(pb + 2 * i)));
+                }
+                subtractScalar(a + i, b + i, out + i, n - i);
+            }
+
+            void dotNeon(const Vec2i *a, const Vec2i *b, int *out, size_t n)
+            {
+                const int *pa = &a->x;
+                const int *pb = &b->x;
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4)
+                {
+                    int32x4x2_t va = vld2q_s32(pa + 2 * i);
+                    int32x4x2_t vb = vld2q_s32(pb + 2 * i);
+                    vst1q_s32(out + i, vmlaq_s32(vmulq_s32(va.val[0], vb.val[0]), va.val[1], vb.val[1]));
+                }
+                dotScalar(a + i, b + i, out + i, n - i);
+            }
+#endif // UTILS_SIMD_NEON
+
+            // Kernel selection
+            template <typename T>
+            Kernels<T> selectKernels(InstructionSet instructionSet)
+            {
+                Kernels<T> kernels = scalarKernels<T>();
+#ifdef UTILS_SIMD_X86
+                if (instructionSet == InstructionSet::AVX2 || instructionSet == InstructionSet::AVX512)
+                {
+                    kernels.add = &addAvx2;
+                    kernels.subtract = &subtractAvx2;
+                    kernels.dot = &dotAvx2;
+                    if constexpr (std::is_floating_point_v<T>)
+                    {
+                        kernels.magnitude = &magnitudeAvx2;
+                        kernels.normalize = &normalizeAvx2;
+                        kernels.squaredDistances = &squaredDistancesAvx2;
+                    }
+                }
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    if (instructionSet == InstructionSet::AVX512)
+                    {
+                        kernels.add = &addAvx512;
+                        kernels.subtract = &subtractAvx512;
+                        kernels.dot = &dotAvx512;
+                        kernels.magnitude = &magnitudeAvx512;
+                        kernels.normalize = &normalizeAvx512;
+                        kernels.squaredDistances = &squaredDistancesAvx512;
+                    }
+                }
+#endif
+#ifdef UTILS_SIMD_NEON
+                if (instructionSet == InstructionSet::NEON)
+                {
+                    kernels.add = &addNeon;
+                    kernels.subtract = &subtractNeon;
+                    kernels.dot = &dotNeon;
+                    if constexpr (std::is_floating_point_v<T>)
+                    {
+                        kernels.magnitude = &magnitudeNeon;
+                        kernels.normalize = &normalizeNeon;
+                        kernels.squaredDistances = &squaredDistancesNeon;
+                    }
+                }
+#endif
+                return kernels;
+            }
+
+            std::atomic<InstructionSet> &activeSet()
+            {
+                static std::atomic<InstructionSet> active{detectInstructionSet()};
+                return active;
+            }
+
+            template <typename T>
+            const Kernels<T> &kernelsFor(InstructionSet instructionSet)
+            {
+                static const Kernels<T> table[] = {
+                    selectKernels<T>(InstructionSet::Scalar),
+                    selectKernels<T>(InstructionSet::AVX2),
+                    selectKernels<T>(InstructionSet::AVX512),
+                    selectKernels<T>(InstructionSet::NEON),
+                };
+                return table[static_cast<size_t>(instructionSet)];
+            }
+
+            template <typename T>
+            const Kernels<T> &activeKernels()
+            {
+                return kernelsFor<T>(activeSet().load(std::memory_order_relaxed));
+            }
+
+            // Bounds-checked entry points
+            template <typename T>
+            void addImpl(std::span<const Vector2D<T>> a, std::span<const Vector2D<T>> b,
+                         std::span<Vector2D<T>> out)
+            {
+                size_t n = std::min({a.size(), b.size(), out.size()});
+                activeKernels<T>().add(a.data(), b.data(), out.data(), n);
+            }
+
+            template <typename T>
+            void subtractImpl(std::span<const Vector2D<T>> a, std::span<const Vector2D<T>> b,
+                              std::span<Vector2D<T>> out)
+            {
+                size_t n = std::min({a.size(), b.size(), out.size()});
+                activeKernels<T>().subtract(a.data(), b.data(), out.data(), n);
+            }
+
+            template <typename T>
+            void dotImpl(std::span<const Vector2D<T>> a, std::span<const Vector2D<T>> b, std::span<T> out)
+            {
+                size_t n = std::min({a.size(), b.size(), out.size()});
+                activeKernels<T>().dot(a.data(), b.data(), out.data(), n);
+            }
+
+            template <typename T>
+            void magnitudeImpl(std::span<const Vector2D<T>> vectors, std::span<T> out)
+            {
+                size_t n = std::min(vectors.size(), out.size());
+                activeKernels<T>().magnitude(vectors.data(), out.data(), n);
+            }
+
+            template <typename T>
+            void normalizeImpl(std::span<Vector2D<T>> vectors)
+            {
+                activeKernels<T>().normalize(vectors.data(), vectors.size());
+            }
+
+            template <typename T>
+            void squaredDistancesImpl(const Vector2D<T> &origin, std::span<const Vector2D<T>> points,
+                                      std::span<T> out)
+            {
+                size_t n = std::min(points.size(), out.size());
+                activeKernels<T>().squaredDistances(origin, points.data(), out.data(), n);
+            }
+
+        } // namespace
+
+        // Dispatch control
+        InstructionSet detectInstructionSet()
+        {
+#ifdef UTILS_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return InstructionSet::AVX512;
+            if (__builtin_cpu_supports("avx2"))
+                return InstructionSet::AVX2;
+#endif
+#ifdef UTILS_SIMD_NEON
+            return InstructionSet::NEON;
+#endif
+            return InstructionSet::Scalar;
+        }
+
+        InstructionSet activeInstructionSet()
+        {
+            return activeSet().load(std::memory_order_relaxed);
+        }
+
+        void forceInstructionSet(InstructionSet instructionSet)
+        {
+            // Never select an instruction set the CPU cannot execute
+            InstructionSet detected = detectInstructionSet();
+            bool supported = instructionSet == InstructionSet::Scalar || instructionSet == detected ||
+                             (instructionSet == InstructionSet::AVX2 && detected == InstructionSet::AVX512);
+            activeSet().store(supported ? instructionSet : detected, std::memory_order_relaxed);
+        }
+
+        const char *instructionSetName(InstructionSet instructionSet)
+        {
+            switch (instructionSet)
+            {
+            case InstructionSet::AVX2:
+                return "AVX2";
+            case InstructionSet::AVX512:
+                return "AVX-512";
+            case InstructionSet::NEON:
+                return "NEON";
+            case InstructionSet::Scalar:
+                break;
+            }
+            return "Scalar";
+        }
+
+        // Public overloads
+        void add(std::span<const Vec2f> a, std::span<const Vec2f> b, std::span<Vec2f> out) { addImpl(a, b, out); }
+        void add(std::span<const Vec2d> a, std::span<const Vec2d> b, std::span<Vec2d> out) { addImpl(a, b, out); }
+        void add(std::span<const Vec2i> a, std::span<const Vec2i> b, std::span<Vec2i> out) { addImpl(a, b, out); }
+
+        void subtract(std::span<const Vec2f> a, std::span<const Vec2f> b, std::span<Vec2f> out) { subtractImpl(a, b, out); }
+        void subtract(std::span<const Vec2d> a, std::span<const Vec2d> b, std::span<Vec2d> out) { subtractImpl(a, b, out); }
+        void subtract(std::span<const Vec2i> a, std::span<const Vec2i> b, std::span<Vec2i> out) { subtractImpl(a, b, out); }
+
+        void dot(std::span<const Vec2f> a, std::span<const Vec2f> b, std::span<float> out) { dotImpl(a, b, out); }
+        void dot(std::span<const Vec2d> a, std::span<const Vec2d> b, std::span<double> out) { dotImpl(a, b, out); }
+        void dot(std::span<const Vec2i> a, std::span<const Vec2i> b, std::span<int> out) { dotImpl(a, b, out); }
+
+        void magnitude(std::span<const Vec2f> vectors, std::span<float> out) { magnitudeImpl(vectors, out); }
+        void magnitude(std::span<const Vec2d> vectors, std::span<double> out) { magnitudeImpl(vectors, out); }
+        void magnitude(std::span<const Vec2i> vectors, std::span<int> out) { magnitudeImpl(vectors, out); }
+
+        void normalize(std::span<Vec2f> vectors) { normalizeImpl(vectors); }
+        void normalize(std::span<Vec2d> vectors) { normalizeImpl(vectors); }
+        void normalize(std::span<Vec2i> vectors) { normalizeImpl(vectors); }
+
+        void squaredDistances(const Vec2f &origin, std::span<const Vec2f> points, std::span<float> out)
+        {
+            squaredDistancesImpl(origin, points, out);
+        }
+        void squaredDistances(const Vec2d &origin, std::span<const Vec2d> points, std::span<double> out)
+        {
+            squaredDistancesImpl(origin, points, out);
+        }
+        void squaredDistances(const Vec2i &origin, std::span<const Vec2i> points, std::span<int> out)
+        {
+            squaredDistancesImpl(origin, points, out);
+        }
+
+    } // namespace simd
+} // namespace utils
@@ -0,0 +1,253 @@
+#include "utils/WindowedStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace utils
+{
+
+    namespace
+    {
+        // Enough halvings to resolve any double range
+        constexpr int MAX_BISECTIONS = 2100;
+
+        IntervalBuckets::Clock::duration bucketInterval(IntervalBuckets::Clock::duration span, size_t buckets)
+        {
+            auto interval = span / static_cast<IntervalBuckets::Clock::rep>(std::max<size_t>(buckets, 1));
+            return std::max(interval, IntervalBuckets::Clock::duration(1));
+        }
+
+        // Quantile of the mixture of the live buckets' KLL rank functions, each bucket
+        // weighted by weight(age) per sample; bisection keeps below(low) < target <= below(high)
+        template <typename Weight>
+        double mixtureQuantile(const IntervalBuckets &buckets, IntervalBuckets::Clock::time_point now,
+                               double percentile, Weight weight)
+        {
+            double total = 0.0;
+            RunningMoments extremes;
+            buckets.forEachLive(now, [&](const IntervalBuckets::Bucket &bucket, int64_t age)
+            {
+                total += weight(age) * bucket.moments.getCount();
+                extremes.merge(bucket.moments);
+            });
+            if (extremes.getCount() == 0)
+            {
+                return 0.0;
+            }
+
+            double target = MathUtils::clamp(percentile, 0.0, 100.0) / 100.0;
+            auto fractionBelow = [&](double value)
+            {
+                double below = 0.0;
+                buckets.forEachLive(now, [&](const IntervalBuckets::Bucket &bucket, int64_t age)
+                                    { below += weight(age) * bucket.moments.getCount() * bucket.sketch.rank(value); });
+                return below / total;
+            };
+
+            double low = extremes.getMinimum();
+            double high = extremes.getMaximum();
+            if (target <= 0.0 || fractionBelow(high) < target)
+            {
+                return (target <= 0.0) ? low : high;
+            }
+            for (int iteration = 0; iteration < MAX_BISECTIONS; ++iteration)
+            {
+                double middle = low + (high - low) / 2.0;
+                if (middle <= low || middle >= high)
+                    break;
+                if (fractionBelow(middle) < target)
+                    low = middle;
+                else
+                    high = middle;
+            }
+            return low;
+        }
+
+        double unitWeight(int64_t)
+        {
+            return 1.0;
+        }
+    }
+
+    // IntervalBuckets implementation
+    IntervalBuckets::IntervalBuckets(Clock::duration interval, size_t buckets, size_t sketchK)
+        : interval_(std::max(interval, Clock::duration(1))), buckets_(std::max<size_t>(buckets, 1), Bucket(sketchK))
+    {
+    }
+
+    bool IntervalBuckets::add(double value, Clock::time_point time)
+    {
+        int64_t interval = intervalOf(time);
+        int64_t count = static_cast<int64_t>(buckets_.size());
+
+        // Too old for the ring behind the newest interval seen, whatever its slot holds
+        if (newest_ != UNUSED && interval <= newest_ - count)
+        {
+            ++rejected_;
+            return false;
+        }
+        newest_ = std::max(newest_, interval);
+
+        Bucket &bucket = buckets_[static_cast<size_t>(((interval % count) + count) % count)];
+        if (bucket.interval != interval)
+        {
+            bucket.interval = interval;
+            bucket.moments.clear();
+            bucket.sketch.clear();
+        }
+
+        bucket.moments.add(value);
+        bucket.sketch.add(value);
+        return true;
+    }
+
+    void IntervalBuckets::clear()
+    {
+        for (Bucket &bucket : buckets_)
+        {
+            bucket.interval = UNUSED;
+            bucket.moments.clear();
+            bucket.sketch.clear();
+        }
+        newest_ = UNUSED;
+        rejected_ = 0;
+    }
+
+    int64_t IntervalBuckets::intervalOf(Clock::time_point time) const
+    {
+        // Floor division, so intervals stay aligned before the clock's epoch too
+        Clock::rep ticks = time.time_since_epoch().count();
+        Clock::rep length = interval_.count();
+        Clock::rep quotient = ticks / length;
+        return static_cast<int64_t>((ticks % length < 0) ? quotient - 1 : quotient);
+    }
+
+    // SlidingWindowStatistics implementation
+    SlidingWindowStatistics::SlidingWindowStatistics(Clock::duration window, size_t buckets, size_t sketchK)
+        : buckets_(bucketInterval(window, buckets), buckets, sketchK)
+    {
+    }
+
+    Statistics SlidingWindowStatistics::calculate(Clock::time_point now) const
+    {
+        RunningMoments moments;
+        buckets_.forEachLive(now, [&moments](const IntervalBuckets::Bucket &bucket, int64_t)
+                             { moments.merge(bucket.moments); });
+
+        Statistics stats;
+        if (moments.getCount() == 0)
+        {
+            return stats;
+        }
+        stats.count = moments.getCount();
+        stats.mean = moments.getMean();
+        stats.median = getPercentile(50.0, now);
+        stats.standardDeviation = moments.getStandardDeviation();
+        stats.minimum = moments.getMinimum();
+        stats.maximum = moments.getMaximum();
+        return stats;
+    }
+
+    double SlidingWindowStatistics::getPercentile(double percentile, Clock::time_point now) const
+    {
+        return mixtureQuantile(buckets_, now, percentile, unitWeight);
+    }
+
+    std::vector<double> SlidingWindowStatistics::getPercentiles(const std::vector<double> &percentiles,
+                                                                Clock::time_point now) const
+    {
+        std::vector<double> result;
+        result.reserve(percentiles.size());
+        for (double percentile : percentiles)
+        {
+            result.push_back(getPercentile(percentile, now));
+        }
+        return result;
+    }
+
+    size_t SlidingWindowStatistics::getCount(Clock::time_point now) const
+    {
+        size_t count = 0;
+        buckets_.forEachLive(now, [&count](const IntervalBuckets::Bucket &bucket, int64_t)
+                             { count += bucket.moments.getCount(); });
+        return count;
+    }
+
+    // DecayedStatistics implementation
+    DecayedStatistics::DecayedStatistics(Clock::duration halfLife, size_t buckets, size_t sketchK)
+        : buckets_(bucketInterval(halfLife * HORIZON_HALF_LIVES, buckets), buckets, sketchK),
+          halfLife_(std::max(halfLife, Clock::duration(1)))
+    {
+    }
+
+    Statistics DecayedStatistics::calculate(Clock::time_point now) const
+    {
+        // Weighted combination of the buckets' moments around the weighted mean
+        double weight = 0.0;
+        double weightedSum = 0.0;
+        RunningMoments extremes;
+        buckets_.forEachLive(now, [&](const IntervalBuckets::Bucket &bucket, int64_t age)
+        {
+            double bucketWeight = weightOf(age) * bucket.moments.getCount();
+            weight += bucketWeight;
+            weightedSum += bucketWeight * bucket.moments.getMean();
+            extremes.merge(bucket.moments);
+        });
+
+        Statistics stats;
+        if (extremes.getCount() == 0)
+        {
+            return stats;
+        }
+
+        double mean = weightedSum / weight;
+        double sumSquaredDiff = 0.0;
+        buckets_.forEachLive(now, [&](const IntervalBuckets::Bucket &bucket, int64_t age)
+        {
+            double delta = bucket.moments.getMean() - mean;
+            sumSquaredDiff += weightOf(age) * (bucket.moments.getSumSquaredDiff() +
+                                               bucket.moments.getCount() * delta * delta);
+        });
+
+        // Bessel's correction on the raw count, so equal weights give the sample variance
+        size_t count = extremes.getCount();
+        double variance = (count > 1) ? sumSquaredDiff / weight * count / (count - 1) : 0.0;
+
+        stats.count = count;
+        stats.mean = mean;
+        stats.median = getPercentile(50.0, now);
+        stats.standardDeviation = std::sqrt(variance);
+        stats.minimum = extremes.getMinimum();
+        stats.maximum = extremes.getMaximum();
+        return stats;
+    }
+
+    double DecayedStatistics::getPercentile(double percentile, Clock::time_point now) const
+    {
+        return mixtureQuantile(buckets_, now, percentile, [this](int64_t age)
+                               { return weightOf(age); });
+    }
+
+    size_t DecayedStatistics::getCount(Clock::time_point now) const
+    {
+        size_t count = 0;
+        buckets_.forEachLive(now, [&count](const IntervalBuckets::Bucket &bucket, int64_t)
+                             { count += bucket.moments.getCount(); });
+        return count;
+    }
+
+    double DecayedStatistics::getWeightedCount(Clock::time_point now) const
+    {
+        double weight = 0.0;
+        buckets_.forEachLive(now, [&](const IntervalBuckets::Bucket &bucket, int64_t age)
+                             { weight += weightOf(age) * bucket.moments.getCount(); });
+        return weight;
+    }
+
+    double DecayedStatistics::weightOf(int64_t age) const
+    {
+        using Seconds = std::chrono::duration<double>;
+        double intervals = static_cast<double>(age) * Seconds(buckets_.getInterval()).count();
+        return std::exp2(-intervals / Seconds(halfLife_).count());
+    }
+
+} // namespace utils